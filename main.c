@@ -50,44 +50,165 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include "nrf_delay.h"
 #include "boards.h"
-#include "nrf_power.h"
+#include "nrf_drv_clock.h"
+#include "app_timer.h"
+#include "app_error.h"
 #include "fuel_gauge.h"
+#include "sampler.h"
+#include "uptime.h"
+#if HW_SAMPLER_ENABLED
+#include "hw_sampler.h"
+#endif
+#if NPM1300_EVENTS_ENABLED
+#include "npm1300_events.h"
+#endif
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+#include "telemetry.h"
+#endif
+#if PROFILE_ENABLED
+#include "profile.h"
+#endif
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
 #include "nrf_log_default_backends.h"
+/**
+ * @brief Function for starting the LFCLK and the RTC based timers driving the sampling.
+ */
+static void timers_init(void)
+{
+    ret_code_t err_code;
+
+    err_code = nrf_drv_clock_init();
+    APP_ERROR_CHECK(err_code);
+
+    nrf_drv_clock_lfclk_request(NULL);
+    while (!nrf_drv_clock_lfclk_is_running())
+    {
+        /* Wait for the low frequency clock to start. */
+    }
+
+    err_code = app_timer_init();
+    APP_ERROR_CHECK(err_code);
+
+    err_code = uptime_init();
+    APP_ERROR_CHECK(err_code);
+
+    err_code = sampler_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+#if NPM1300_EVENTS_ENABLED
+/**
+ * @brief Function for taking a sample right away when VBUS or the charger state changes.
+ */
+static void pmic_event_handler(uint32_t events, void * p_context)
+{
+    UNUSED_PARAMETER(events);
+    UNUSED_PARAMETER(p_context);
+
+    sampler_sample_request();
+}
+#endif
+
+/**
+ * @brief Function for following the period the fuel gauge asks for after an update.
+ */
+static void period_follow(uint32_t * p_period_ms)
+{
+    if (fuel_gauge_period_get() == *p_period_ms)
+    {
+        return;
+    }
+
+    *p_period_ms = fuel_gauge_period_get();
+#if HW_SAMPLER_ENABLED
+    APP_ERROR_CHECK(hw_sampler_period_set(*p_period_ms));
+#else
+    APP_ERROR_CHECK(sampler_period_set(*p_period_ms));
+#endif
+}
+
 /**
  * @brief Function for application main entry.
  */
 int main(void)
 {
-    static uint32_t val = 0;
+    uint32_t period_ms = FUEL_GAUGE_SAMPLE_PERIOD_MS;
+#if !HW_SAMPLER_ENABLED
+    sampler_config_t const sampler_config =
+    {
+        .period_ms   = period_ms,
+        .phase_align = FUEL_GAUGE_SAMPLE_PHASE_ALIGN,
+    };
+#endif
+
     /* Configure board. */
     bsp_board_init(BSP_INIT_LEDS);
 
-    nrf_power_gpregret_set(0x34);
-
-    val =  nrf_power_gpregret_get();
+    /* The fuel gauge takes its time reference from the uptime counter. */
+    timers_init();
 
-    val += 1;
+#if PROFILE_ENABLED
+    profile_init();
+#endif
 
+    /* After a soft, pin or watchdog reset the PMIC configured by the last boot is taken over. */
     if (fuel_gauge_init() != 0) {
 	printf("Could not initialise fuel gauge.\n");
 	return 0;
     }
     printf("PMIC device ok\n");
 
-    /* Toggle LEDs. */
+#if NPM1300_EVENTS_ENABLED
+    APP_ERROR_CHECK(npm1300_events_subscribe(npm1300_charger_events_get(fuel_gauge_charger_get()),
+                                             NPM1300_EVENT_MASK_VBUS |
+                                             NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_COMPLETED) |
+                                             NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_ERROR),
+                                             pmic_event_handler, NULL));
+#endif
+
+#if HW_SAMPLER_ENABLED
+    /* Samples are taken without the CPU, the sampler only serves PMIC events. */
+    APP_ERROR_CHECK(hw_sampler_init(fuel_gauge_twi_queue_get(), fuel_gauge_charger_get()));
+    APP_ERROR_CHECK(hw_sampler_start(period_ms));
+#else
+    APP_ERROR_CHECK(sampler_start(&sampler_config));
+#endif
+
+    /* Sample on every timer tick, log at idle and sleep in between. */
     while (true)
     {
-        fuel_gauge_update();
-    
-        for (int i = 0; i < LEDS_NUMBER; i++)
+#if HW_SAMPLER_ENABLED
+        hw_sampler_batch_t batch;
+
+        /* Wakes up once per HW_SAMPLER_BATCH samples. */
+        if (hw_sampler_batch_take(&batch))
         {
-            bsp_board_led_invert(i);
-            nrf_delay_ms(200);
+            fuel_gauge_batch_update(&batch);
+            bsp_board_led_invert(0);
+            period_follow(&period_ms);
         }
+#endif
+
+        if (sampler_sample_pending_take())
+        {
+            fuel_gauge_update();
+            bsp_board_led_invert(0);
+            period_follow(&period_ms);
+        }
+
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+        /* Send the queued gauge records before going to sleep. */
+        telemetry_flush();
+#endif
+
+#if PROFILE_ENABLED
+        /* Typed keys raise no interrupt, they are seen on the next wakeup. */
+        profile_command_poll();
+#endif
+
+        __WFE();
     }
 }
 
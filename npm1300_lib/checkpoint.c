@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_fstorage.h"
+#include "nrf_fstorage_nvmc.h"
+#include "crc32.h"
+#include "checkpoint.h"
+
+/* Flash page of the nRF52 series, the erase unit of the NVMC */
+#define CHECKPOINT_PAGE_SIZE      4096UL
+#define CHECKPOINT_END_ADDR       (FUEL_GAUGE_CHECKPOINT_START_ADDR + \
+                                   (FUEL_GAUGE_CHECKPOINT_PAGES * CHECKPOINT_PAGE_SIZE))
+#define CHECKPOINT_SLOTS_PER_PAGE (CHECKPOINT_PAGE_SIZE / sizeof(checkpoint_t))
+#define CHECKPOINT_SLOTS          (FUEL_GAUGE_CHECKPOINT_PAGES * CHECKPOINT_SLOTS_PER_PAGE)
+
+/* Records are word aligned and never cross a page. */
+STATIC_ASSERT(sizeof(checkpoint_t) == 32U);
+STATIC_ASSERT((CHECKPOINT_PAGE_SIZE % sizeof(checkpoint_t)) == 0U);
+STATIC_ASSERT((FUEL_GAUGE_CHECKPOINT_START_ADDR % CHECKPOINT_PAGE_SIZE) == 0U);
+
+/* One page holds the newest records while the other one is erased. */
+STATIC_ASSERT(FUEL_GAUGE_CHECKPOINT_PAGES >= 2);
+
+static void fstorage_evt_handler(nrf_fstorage_evt_t * p_evt);
+
+NRF_FSTORAGE_DEF(nrf_fstorage_t m_checkpoint_fs) =
+{
+    .evt_handler = fstorage_evt_handler,
+    .start_addr  = FUEL_GAUGE_CHECKPOINT_START_ADDR,
+    .end_addr    = CHECKPOINT_END_ADDR,
+};
+
+static checkpoint_t       m_pending;    /* Source of the write in progress */
+static volatile bool      m_busy;
+static checkpoint_t       m_last;
+static bool               m_found;
+static uint32_t           m_next_slot;
+static checkpoint_stats_t m_stats;
+
+static void fstorage_evt_handler(nrf_fstorage_evt_t * p_evt)
+{
+    /* A failed write leaves a slot with a wrong CRC, it is skipped at the next start. */
+    if (p_evt->id == NRF_FSTORAGE_EVT_WRITE_RESULT)
+    {
+        m_busy = false;
+    }
+}
+
+static uint32_t slot_addr(uint32_t slot)
+{
+    return FUEL_GAUGE_CHECKPOINT_START_ADDR + (slot * sizeof(checkpoint_t));
+}
+
+static uint32_t record_crc(checkpoint_t const * p_record)
+{
+    return crc32_compute((uint8_t const *)p_record, offsetof(checkpoint_t, crc), NULL);
+}
+
+static bool record_blank(checkpoint_t const * p_record)
+{
+    uint32_t const * p_words = (uint32_t const *)p_record;
+
+    for (size_t i = 0U; i < (sizeof(*p_record) / sizeof(uint32_t)); i++)
+    {
+        if (p_words[i] != UINT32_MAX)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ret_code_t checkpoint_init(void)
+{
+    checkpoint_t record;
+    uint32_t     last_slot = 0U;
+    ret_code_t   err_code;
+
+    err_code = nrf_fstorage_init(&m_checkpoint_fs, &nrf_fstorage_nvmc, NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    m_busy  = false;
+    m_found = false;
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    for (uint32_t slot = 0U; slot < CHECKPOINT_SLOTS; slot++)
+    {
+        err_code = nrf_fstorage_read(&m_checkpoint_fs, slot_addr(slot), &record, sizeof(record));
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+
+        if (record_blank(&record) || (record.crc != record_crc(&record)))
+        {
+            continue;
+        }
+
+        /* The counter of the newest record is ahead of all others, also across a wrap. */
+        if (!m_found || ((int32_t)(record.seq - m_last.seq) > 0))
+        {
+            m_last    = record;
+            m_found   = true;
+            last_slot = slot;
+        }
+    }
+
+    if (!m_found)
+    {
+        m_next_slot = 0U;
+        return NRF_SUCCESS;
+    }
+
+    /* Slots written by a cut write cannot be programmed again before the page is erased,
+     * skip them. The start of a page is always usable, it is erased before the write.
+     */
+    m_next_slot = (last_slot + 1U) % CHECKPOINT_SLOTS;
+    while ((m_next_slot % CHECKPOINT_SLOTS_PER_PAGE) != 0U)
+    {
+        err_code = nrf_fstorage_read(&m_checkpoint_fs, slot_addr(m_next_slot), &record,
+                                     sizeof(record));
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+
+        if (record_blank(&record))
+        {
+            break;
+        }
+        m_next_slot = (m_next_slot + 1U) % CHECKPOINT_SLOTS;
+    }
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t checkpoint_load(checkpoint_t * p_checkpoint)
+{
+    if (!m_found)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_checkpoint = m_last;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t checkpoint_store(checkpoint_t * p_checkpoint)
+{
+    ret_code_t err_code;
+
+    if (m_busy)
+    {
+        m_stats.busy++;
+        return NRF_ERROR_BUSY;
+    }
+
+    p_checkpoint->seq = m_found ? (m_last.seq + 1U) : 0U;
+    p_checkpoint->crc = record_crc(p_checkpoint);
+    m_pending = *p_checkpoint;
+
+    /* The NVMC backend completes and reports the operation before returning. */
+    m_busy = true;
+
+    if ((m_next_slot % CHECKPOINT_SLOTS_PER_PAGE) == 0U)
+    {
+        err_code = nrf_fstorage_erase(&m_checkpoint_fs, slot_addr(m_next_slot), 1U, NULL);
+        if (err_code != NRF_SUCCESS)
+        {
+            m_busy = false;
+            return err_code;
+        }
+        m_stats.erases++;
+    }
+
+    err_code = nrf_fstorage_write(&m_checkpoint_fs, slot_addr(m_next_slot), &m_pending,
+                                  sizeof(m_pending), NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_busy = false;
+        return err_code;
+    }
+
+    m_stats.writes++;
+    m_last      = m_pending;
+    m_found     = true;
+    m_next_slot = (m_next_slot + 1U) % CHECKPOINT_SLOTS;
+
+    return NRF_SUCCESS;
+}
+
+void checkpoint_stats_get(checkpoint_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
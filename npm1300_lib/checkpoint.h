@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup checkpoint Fuel gauge checkpoint
+ * @{
+ * @brief Last fuel gauge state, kept in flash across power cycles.
+ *
+ * @details Records are appended to a log of FUEL_GAUGE_CHECKPOINT_PAGES flash pages through
+ *          nrf_fstorage, the newest valid record is the checkpoint. A page is only erased
+ *          when the log wraps into it, so every page sees the same number of erase cycles
+ *          and the previous page still holds a valid record while a page is erased. Records
+ *          are protected by a CRC32, a write cut by a reset is skipped at the next start.
+ */
+
+#ifndef CHECKPOINT_H__
+#define CHECKPOINT_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Checkpoint record, as stored in flash.
+ *
+ * @details Battery channels are averaged over the updates since the previous record.
+ */
+typedef struct
+{
+    uint32_t seq;         /**< Record counter, filled in by @ref checkpoint_store. */
+    uint32_t time_s;      /**< Operating time summed over all boots. */
+    float    soc;         /**< State of charge in percent. */
+    float    voltage;     /**< Average battery voltage in volts. */
+    float    current;     /**< Average battery current in amperes, positive when discharging. */
+    float    temp;        /**< Average battery temperature in degrees Celsius. */
+    uint8_t  chg_status;  /**< CHG_STAT register of the last update. */
+    uint8_t  vbus_stat;   /**< VBUS status register of the last update. */
+    uint16_t samples;     /**< Number of updates averaged. */
+    uint32_t crc;         /**< CRC32 of the record, filled in by @ref checkpoint_store. */
+} checkpoint_t;
+
+/** @brief Flash usage. */
+typedef struct
+{
+    uint32_t writes;  /**< Records written. */
+    uint32_t erases;  /**< Pages erased. */
+    uint32_t busy;    /**< Records not written because the previous one was still pending. */
+} checkpoint_stats_t;
+
+/**
+ * @brief Function for setting up fstorage and finding the newest record.
+ *
+ * @details Reads the whole log once.
+ */
+ret_code_t checkpoint_init(void);
+
+/**
+ * @brief Function for getting the newest record.
+ *
+ * @retval NRF_SUCCESS          Record copied.
+ * @retval NRF_ERROR_NOT_FOUND  The log holds no valid record.
+ */
+ret_code_t checkpoint_load(checkpoint_t * p_checkpoint);
+
+/**
+ * @brief Function for appending a record to the log.
+ *
+ * @details The record is copied, fstorage writes it in the background. When the log wraps
+ *          into the next page, the page is erased first. With the NVMC backend both are done
+ *          before the function returns and stall the CPU, the erase for about 85 ms.
+ *
+ * @param[in,out] p_checkpoint Record to store, the counter and CRC are filled in.
+ *
+ * @retval NRF_SUCCESS          Write started.
+ * @retval NRF_ERROR_BUSY       The previous write has not completed.
+ */
+ret_code_t checkpoint_store(checkpoint_t * p_checkpoint);
+
+/**
+ * @brief Function for getting the flash usage.
+ */
+void checkpoint_stats_get(checkpoint_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHECKPOINT_H__
+
+/** @} */
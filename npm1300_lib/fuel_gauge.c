@@ -5,90 +5,624 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
+#include "sdk_common.h"
+#include "app_util_platform.h"
 #include "sensor.h"
 #include "npm1300_charger.h"
 #include "nrf_fuel_gauge.h"
+#include "uptime.h"
+#include "profile.h"
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+#include "telemetry.h"
+#endif
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+#include "nrf_power.h"
+#endif
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+#include "checkpoint.h"
+#endif
+#include "fuel_gauge.h"
 #include "nrf_log.h"
-#include "nrf_drv_twi.h"
 #include "nrf_log_ctrl.h"
 #include "nrf_log_default_backends.h"
 
-static float max_charge_current;
-static float term_charge_current;
+/* PMIC bus on the Arduino header of the DK */
+#define ARDUINO_SCL_PIN             27    // SCL signal pin
+#define ARDUINO_SDA_PIN             26    // SDA signal pin
+
+/* TWI transaction queue. */
+TWI_QUEUE_DEF(m_twi_queue, 0);
+
+/* Charger of the gauged battery. The gauge library keeps a single model state, so there is
+ * one gauge per application even with several charger instances.
+ */
+NPM1300_CHARGER_DEF(m_charger);
+
 static int64_t ref_time;
 
-extern void npm1300_charger_sample_fetch(void);
-extern int npm1300_charger_channel_get(enum sensor_channel chan,struct sensor_value *valp);
-extern void npm1300_charger_init(void);
-extern void twi_master_init(void);
+/* Outputs of the last nrf_fuel_gauge_process. Time to empty and time to full are estimated
+ * on first use, and only the one that applies to the battery current direction.
+ */
+static struct {
+    float tte;
+    float ttf;
+    bool tte_valid;
+    bool ttf_valid;
+    bool charging;
+    bool discharging;
+} result = { .tte = NAN, .ttf = NAN, .tte_valid = true, .ttf_valid = true };
+
+/* Updates logged since the last one that computed the estimates for the log */
+static uint32_t log_updates;
+
+#if FUEL_GAUGE_ADAPTIVE_ENABLED
+/* Last inputs used to decide whether the battery is in steady state */
+static struct {
+    float voltage;
+    float current;
+    int32_t chg_status;
+    int32_t vbus_status;
+} last_sample;
+
+#if HW_SAMPLER_ENABLED
+/* Samples reach the gauge a batch at a time, the longest period bounds the batch interval */
+#define PERIOD_MAX_MS (FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS / HW_SAMPLER_BATCH)
+#else
+#define PERIOD_MAX_MS FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS
+#endif
+#endif
+
+static uint32_t period_ms = FUEL_GAUGE_SAMPLE_PERIOD_MS;
+static float last_soc = NAN;
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+/* GPREGRET value marking a PMIC configured by this application. GPREGRET is cleared by
+ * power-on and brown-out resets only.
+ */
+#define WARM_BOOT_MARK  0x34U
+#define RETAINED_MAGIC  0x46475742UL
+
+/* State kept in RAM across soft, pin and watchdog resets */
+struct retained_state {
+    uint32_t magic;
+    npm1300_charger_retained_t charger;
+    float voltage;
+    float current;
+    float temp;
+    float soc;
+    uint32_t period_ms;
+    uint8_t chg_status;
+    uint8_t vbus_status;
+    uint32_t checksum;
+};
+
+/* Not initialized by the startup code */
+static struct retained_state retained __attribute__((section(".non_init")));
+#endif
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED || FUEL_GAUGE_CHECKPOINT_ENABLED
+/* Battery voltage range searched for the rest voltage of a known state of charge, and the
+ * number of halvings, 16 give a resolution of 31 uV.
+ */
+#define SEED_V_MIN    2.5f
+#define SEED_V_MAX    4.5f
+#define SEED_V_STEPS  16
+#endif
+
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+/* Updates since the last checkpoint, averaged into the next one */
+static struct {
+    float voltage;
+    float current;
+    float temp;
+    uint32_t samples;
+    float soc;             /* State of charge of the last checkpoint, NaN without one */
+    uint32_t time_base_s;  /* Operating time of the previous boots */
+} checkpoint_acc = { .soc = NAN };
+#endif
 
 static const struct battery_model battery_model = {
 #include "battery_model.inc"
 };
 
-static void read_sensors(float *voltage, float *current, float *temp)
+static void twi_master_init(void)
+{
+    ret_code_t ret;
+    const twi_queue_config_t config =
+    {
+       .scl                = ARDUINO_SCL_PIN,
+       .sda                = ARDUINO_SDA_PIN,
+       .frequency          = (twi_queue_frequency_t)NPM1300_TWI_FREQUENCY,
+       .interrupt_priority = APP_IRQ_PRIORITY_HIGH
+    };
+
+    ret = twi_queue_init(&m_twi_queue, &config);
+    APP_ERROR_CHECK(ret);
+}
+
+/* Charger current in amperes. Charge and termination current can be changed at runtime. */
+static float charger_current_get(enum sensor_channel chan)
 {
     struct sensor_value value;
-    int ret;
 
-    npm1300_charger_sample_fetch();
-    
+    npm1300_charger_channel_get(&m_charger, chan, &value);
+
+    return (float)value.val1 + ((float)value.val2 / 1000000);
+}
 
-    npm1300_charger_channel_get(SENSOR_CHAN_GAUGE_VOLTAGE, &value);
-    *voltage = (float)value.val1 + ((float)value.val2 / 1000000);
+static void read_sensors(npm1300_charger_snapshot_t *snapshot)
+{
+    PROFILE_BEGIN(PROFILE_SCOPE_FETCH);
+    npm1300_charger_sample_fetch(&m_charger);
+    PROFILE_END(PROFILE_SCOPE_FETCH);
+    npm1300_charger_snapshot_get(&m_charger, snapshot);
+}
 
-    npm1300_charger_channel_get(SENSOR_CHAN_GAUGE_TEMP, &value);
-    *temp = (float)value.val1 + ((float)value.val2 / 1000000);
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+/* FNV-1a over the retained state up to the checksum */
+static uint32_t retained_checksum(void)
+{
+    uint8_t const *p = (uint8_t const *)&retained;
+    uint32_t hash = 2166136261UL;
 
-    npm1300_charger_channel_get(SENSOR_CHAN_GAUGE_AVG_CURRENT, &value);
-    *current = (float)value.val1 + ((float)value.val2 / 1000000);
+    for (size_t i = 0; i < offsetof(struct retained_state, checksum); i++) {
+        hash = (hash ^ p[i]) * 16777619UL;
+    }
+
+    return hash;
 }
 
+static bool retained_valid(void)
+{
+    return (nrf_power_gpregret_get() == WARM_BOOT_MARK) &&
+           (retained.magic == RETAINED_MAGIC) &&
+           (retained.checksum == retained_checksum());
+}
+
+/* Keep the register shadow and the last gauge inputs for the next warm boot */
+static void retained_store(npm1300_charger_snapshot_t const *snapshot, float soc)
+{
+    retained.magic = RETAINED_MAGIC;
+    npm1300_charger_retained_get(&m_charger, &retained.charger);
+    retained.voltage = snapshot->voltage;
+    retained.current = snapshot->current;
+    retained.temp = snapshot->temp;
+    retained.soc = soc;
+    retained.period_ms = period_ms;
+    retained.chg_status = snapshot->status;
+    retained.vbus_status = snapshot->vbus_stat;
+    retained.checksum = retained_checksum();
+}
+
+/* Take over the PMIC and the gauge inputs from before the reset. Returns false when the
+ * retained state is invalid or the PMIC has been reset, the caller does a cold init then.
+ */
+static bool warm_init(npm1300_charger_config_t const *charger_config,
+                      npm1300_charger_snapshot_t *snapshot)
+{
+    if (!retained_valid() ||
+        (npm1300_charger_init_warm(&m_charger, charger_config, &retained.charger) != NRF_SUCCESS)) {
+        return false;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->voltage = retained.voltage;
+    snapshot->current = retained.current;
+    snapshot->temp = retained.temp;
+    snapshot->status = retained.chg_status;
+    snapshot->vbus_stat = retained.vbus_status;
+#if FUEL_GAUGE_ADAPTIVE_ENABLED
+    period_ms = retained.period_ms;
+#endif
+
+    return true;
+}
+#endif
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED || FUEL_GAUGE_CHECKPOINT_ENABLED
+/* State of charge the gauge library starts from with the given inputs */
+static float initial_soc_get(struct nrf_fuel_gauge_init_parameters const *parameters)
+{
+    nrf_fuel_gauge_init(parameters, NULL);
+
+    return nrf_fuel_gauge_process(parameters->v0, parameters->i0, parameters->t0, 0.f, NULL);
+}
+
+/* Start the gauge from a known state of charge. The library derives its start from the
+ * initial voltage only, so the rest voltage that gives the state of charge is searched for.
+ */
+static void soc_seed(struct nrf_fuel_gauge_init_parameters *parameters, float soc)
+{
+    struct nrf_fuel_gauge_init_parameters search = *parameters;
+    float low = SEED_V_MIN;
+    float high = SEED_V_MAX;
+
+    search.i0 = 0.f;
+    for (int i = 0; i < SEED_V_STEPS; i++) {
+        search.v0 = (low + high) / 2.f;
+        if (initial_soc_get(&search) < soc) {
+            low = search.v0;
+        } else {
+            high = search.v0;
+        }
+    }
+
+    parameters->v0 = (low + high) / 2.f;
+    parameters->i0 = 0.f;
+
+    /* What the library starts from, not the requested value it may not reach exactly */
+    last_soc = initial_soc_get(parameters);
+}
+#endif
+
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+
+/* Continue from the last checkpoint in flash. After a cold start, the gauge is seeded with
+ * the state of charge of the checkpoint instead of the one of the first sample, unless the
+ * two differ so much that the battery must have been charged or discharged while the
+ * device was off. A warm boot has already been seeded from the retained state, which is
+ * newer than any checkpoint, so only the checkpoint log is taken over then.
+ */
+static void checkpoint_start(struct nrf_fuel_gauge_init_parameters *parameters, bool warm)
+{
+    checkpoint_t checkpoint;
+
+    APP_ERROR_CHECK(checkpoint_init());
+
+    if (checkpoint_load(&checkpoint) != NRF_SUCCESS) {
+        return;
+    }
+
+    checkpoint_acc.soc = checkpoint.soc;
+    checkpoint_acc.time_base_s = checkpoint.time_s;
+
+    if (warm ||
+        (fabsf(initial_soc_get(parameters) - checkpoint.soc) > FUEL_GAUGE_CHECKPOINT_MAX_SOC_DIFF)) {
+        return;
+    }
+
+    soc_seed(parameters, checkpoint.soc);
+}
+
+/* Average the update into the next checkpoint, and write it once the state of charge has
+ * moved by FUEL_GAUGE_CHECKPOINT_SOC_STEP since the last one.
+ */
+static void checkpoint_update(npm1300_charger_snapshot_t const *snapshot, float soc)
+{
+    checkpoint_t checkpoint;
+
+    checkpoint_acc.voltage += snapshot->voltage;
+    checkpoint_acc.current += snapshot->current;
+    checkpoint_acc.temp += snapshot->temp;
+    checkpoint_acc.samples++;
+
+    if (!isnan(checkpoint_acc.soc) &&
+        (fabsf(soc - checkpoint_acc.soc) < FUEL_GAUGE_CHECKPOINT_SOC_STEP)) {
+        return;
+    }
+
+    checkpoint = (checkpoint_t) {
+        .time_s = checkpoint_acc.time_base_s + (uint32_t)(uptime_get() / 1000),
+        .soc = soc,
+        .voltage = checkpoint_acc.voltage / checkpoint_acc.samples,
+        .current = checkpoint_acc.current / checkpoint_acc.samples,
+        .temp = checkpoint_acc.temp / checkpoint_acc.samples,
+        .chg_status = snapshot->status,
+        .vbus_stat = snapshot->vbus_stat,
+        .samples = (uint16_t)MIN(checkpoint_acc.samples, UINT16_MAX),
+    };
+
+    /* Tried again on the next update while a write is pending */
+    if (checkpoint_store(&checkpoint) != NRF_SUCCESS) {
+        return;
+    }
+
+    checkpoint_acc.soc = soc;
+    checkpoint_acc.voltage = 0.f;
+    checkpoint_acc.current = 0.f;
+    checkpoint_acc.temp = 0.f;
+    checkpoint_acc.samples = 0;
+}
+#endif
 
 int fuel_gauge_init(void)
 {
-    struct sensor_value value;
     struct nrf_fuel_gauge_init_parameters parameters = { .model = &battery_model };
-    int ret;
+    npm1300_charger_snapshot_t snapshot;
+    const npm1300_charger_config_t charger_config = NPM1300_CHARGER_DEFAULT_CONFIG(&m_twi_queue);
+    bool warm = false;
 
     twi_master_init();     
-    npm1300_charger_init();
-     
-    read_sensors(&parameters.v0, &parameters.i0, &parameters.t0);
-           
-    /* Store charge nominal and termination current, needed for ttf calculation */
-    npm1300_charger_channel_get(SENSOR_CHAN_GAUGE_DESIRED_CHARGING_CURRENT, &value);
-    max_charge_current = (float)value.val1 + ((float)value.val2 / 1000000);
-    term_charge_current = max_charge_current / 10.f;
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+    /* After a soft reset the PMIC is still configured and the inputs of the last update
+     * are valid, no sample is needed to seed the gauge.
+     */
+    warm = warm_init(&charger_config, &snapshot);
+#endif
+    if (!warm) {
+        npm1300_charger_init(&m_charger, &charger_config);
+        read_sensors(&snapshot);
+    }
+
+    parameters.v0 = snapshot.voltage;
+    parameters.i0 = snapshot.current;
+    parameters.t0 = snapshot.temp;
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+    /* Continue from the state of charge before the reset, coulomb counting included */
+    if (warm) {
+        soc_seed(&parameters, retained.soc);
+    }
+#endif
+
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+    checkpoint_start(&parameters, warm);
+#endif
 
     nrf_fuel_gauge_init(&parameters, NULL);     
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+    retained_store(&snapshot, last_soc);
+    nrf_power_gpregret_set(WARM_BOOT_MARK);
+#endif
+
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+    APP_ERROR_CHECK(telemetry_init());
+#endif
+
+#if FUEL_GAUGE_ADAPTIVE_ENABLED
+    last_sample.voltage = snapshot.voltage;
+    last_sample.current = snapshot.current;
+    last_sample.chg_status = snapshot.status;
+    last_sample.vbus_status = snapshot.vbus_stat;
+#endif
     
-    //ref_time = k_uptime_get();  //???
-    ref_time = 1500000;   //about 15ms
+    ref_time = uptime_get();
 
     return 0;
 }
 
-void fuel_gauge_update(void)
+#if FUEL_GAUGE_ADAPTIVE_ENABLED
+/* Pick the next sampling period from the change since the last sample.
+ * Returns true when the battery is in steady state.
+ */
+static bool period_adapt(npm1300_charger_snapshot_t const *snapshot)
+{
+    float voltage = snapshot->voltage;
+    float current = snapshot->current;
+    int32_t chg_status = snapshot->status;
+    int32_t vbus_status = snapshot->vbus_stat;
+    bool stable;
+
+    stable = (chg_status == last_sample.chg_status) &&
+             (vbus_status == last_sample.vbus_status) &&
+             (fabsf(current - last_sample.current) <= (FUEL_GAUGE_STABLE_CURRENT_UA / 1000000.f)) &&
+             (fabsf(voltage - last_sample.voltage) <= (FUEL_GAUGE_STABLE_VOLTAGE_MV / 1000.f));
+
+    last_sample.voltage = voltage;
+    last_sample.current = current;
+    last_sample.chg_status = chg_status;
+    last_sample.vbus_status = vbus_status;
+
+    if (stable) {
+        /* Back off geometrically while nothing changes */
+        period_ms = MIN(period_ms * 2U, PERIOD_MAX_MS);
+    } else {
+        /* Load step, charger state change or VBUS attach/detach */
+        period_ms = FUEL_GAUGE_SAMPLE_PERIOD_MS;
+    }
+
+    /* Idle only on battery (VBUS status bit 0 is VBUS detected) and with a load
+     * current too small to tell apart from the idle current.
+     */
+    return stable && ((vbus_status & 1) == 0) &&
+           (fabsf(current) <= (FUEL_GAUGE_STABLE_CURRENT_UA / 1000000.f));
+}
+#endif
+
+uint32_t fuel_gauge_period_get(void)
 {
-    float voltage;
-    float current;
-    float temp;
+    return period_ms;
+}
+
+float fuel_gauge_soc_get(void)
+{
+    return last_soc;
+}
+
+float fuel_gauge_tte_get(void)
+{
+    if (!result.tte_valid) {
+        PROFILE_BEGIN(PROFILE_SCOPE_ESTIMATE);
+        result.tte = result.discharging ? nrf_fuel_gauge_tte_get() : NAN;
+        result.tte_valid = true;
+        PROFILE_END(PROFILE_SCOPE_ESTIMATE);
+    }
+
+    return result.tte;
+}
+
+float fuel_gauge_ttf_get(void)
+{
+    float i_cc;
+    float i_term;
+
+    if (!result.ttf_valid) {
+        PROFILE_BEGIN(PROFILE_SCOPE_ESTIMATE);
+        result.ttf = NAN;
+        if (result.charging) {
+            /* The library takes charge currents as negative values */
+            i_cc = charger_current_get(SENSOR_CHAN_GAUGE_DESIRED_CHARGING_CURRENT);
+            i_term = charger_current_get((enum sensor_channel)SENSOR_CHAN_NPM1300_CHARGER_TERM_CURRENT);
+            result.ttf = nrf_fuel_gauge_ttf_get(-i_cc, -i_term);
+        }
+        result.ttf_valid = true;
+        PROFILE_END(PROFILE_SCOPE_ESTIMATE);
+    }
+
+    return result.ttf;
+}
+
+npm1300_charger_t *fuel_gauge_charger_get(void)
+{
+    return &m_charger;
+}
+
+twi_queue_t *fuel_gauge_twi_queue_get(void)
+{
+    return &m_twi_queue;
+}
+
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+/* Queue the sample and the gauge outputs, they are formatted on the host. */
+static void telemetry_record_put(npm1300_charger_snapshot_t const *snapshot,
+                                 float soc, float tte, float ttf)
+{
+    telemetry_record_t record = {
+        .chg_status = snapshot->status,
+        .vbus_stat = snapshot->vbus_stat,
+        .time_ms = (uint32_t)ref_time,
+        .voltage_uv = snapshot->voltage_uv,
+        .current_ua = snapshot->current_ua,
+        .temp_mdeg = snapshot->temp_mdeg,
+        .soc = soc,
+        .tte = tte,
+        .ttf = ttf,
+    };
+
+    telemetry_put(&record);
+}
+#endif
+
+/* Seconds from the conversion of the previous sample to the one of this sample. A sample
+ * converted before the reference, such as the first pipelined fetch after init, counts as 0.
+ */
+static float sample_delta(npm1300_charger_snapshot_t const *snapshot)
+{
+    int64_t delta = snapshot->time_ms - ref_time;
+
+    if (delta <= 0) {
+        return 0.f;
+    }
+
+    ref_time = snapshot->time_ms;
+
+    return (float)delta / 1000.f;
+}
+
+/* New gauge outputs, the estimates are left to the getters */
+static void result_reset(uint8_t ibat_stat)
+{
+    result.discharging = (ibat_stat == NPM1300_CHARGER_IBAT_STAT_DISCHARGE);
+    result.charging = (ibat_stat == NPM1300_CHARGER_IBAT_STAT_CHARGE_TRICKLE) ||
+                      (ibat_stat == NPM1300_CHARGER_IBAT_STAT_CHARGE_COOL) ||
+                      (ibat_stat == NPM1300_CHARGER_IBAT_STAT_CHARGE_NORMAL);
+    result.tte_valid = false;
+    result.ttf_valid = false;
+}
+
+/* Estimates for the log of an update: the ones read since the update, and computed once
+ * every FUEL_GAUGE_LOG_ESTIMATE_INTERVAL updates. The log does not pay for them otherwise.
+ */
+static void log_estimates_get(float *tte, float *ttf)
+{
+    bool compute = false;
+
+    if (FUEL_GAUGE_LOG_ESTIMATE_INTERVAL > 0) {
+        log_updates++;
+        compute = (log_updates >= FUEL_GAUGE_LOG_ESTIMATE_INTERVAL);
+    }
+    if (compute) {
+        log_updates = 0;
+    }
+
+    *tte = (compute || result.tte_valid) ? fuel_gauge_tte_get() : NAN;
+    *ttf = (compute || result.ttf_valid) ? fuel_gauge_ttf_get() : NAN;
+}
+
+/* Feed one sample to the gauge, taken delta seconds after the previous one at ref_time */
+static void gauge_step(npm1300_charger_snapshot_t const *snapshot, float delta)
+{
+    float voltage = snapshot->voltage;
+    float current = snapshot->current;
+    float temp = snapshot->temp;
     float soc;
     float tte;
     float ttf;
-    float delta;
- 
-    read_sensors(&voltage, &current, &temp);
-    
-    //delta = (float) k_uptime_delta(&ref_time) / 1000.f;
-    delta = 1000000;
 
+    PROFILE_BEGIN(PROFILE_SCOPE_PROCESS);
     soc = nrf_fuel_gauge_process(voltage, current, temp, delta, NULL);
-    tte = nrf_fuel_gauge_tte_get();
-    ttf = nrf_fuel_gauge_ttf_get(-max_charge_current, -term_charge_current);
+    PROFILE_END(PROFILE_SCOPE_PROCESS);
+    last_soc = soc;
+    result_reset(snapshot->ibat_stat);
+
+#if FUEL_GAUGE_ADAPTIVE_ENABLED
+    /* Until the next sample, let the gauge integrate the known idle current
+     * instead of extrapolating the last measurement over a long gap.
+     */
+    if (period_adapt(snapshot) && (FUEL_GAUGE_IDLE_CURRENT_UA > 0) &&
+        (period_ms >= FUEL_GAUGE_IDLE_PERIOD_MS)) {
+        nrf_fuel_gauge_idle_set(voltage, temp, FUEL_GAUGE_IDLE_CURRENT_UA / 1000000.f);
+    }
+#endif
+
+#if FUEL_GAUGE_WARM_BOOT_ENABLED
+    retained_store(snapshot, soc);
+#endif
 
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+    checkpoint_update(snapshot, soc);
+#endif
+
+    /* Estimated outside of the logging scope, they have their own */
+    log_estimates_get(&tte, &ttf);
+
+    PROFILE_BEGIN(PROFILE_SCOPE_LOG);
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+    telemetry_record_put(snapshot, soc, tte, ttf);
+#else
     printf("V:"NRF_LOG_FLOAT_MARKER", I:"NRF_LOG_FLOAT_MARKER", T:"NRF_LOG_FLOAT_MARKER", SoC:"NRF_LOG_FLOAT_MARKER", TTE:"NRF_LOG_FLOAT_MARKER", TTF:"NRF_LOG_FLOAT_MARKER"\r\n",  \ 
            NRF_LOG_FLOAT(voltage),NRF_LOG_FLOAT(current),NRF_LOG_FLOAT(temp),NRF_LOG_FLOAT(soc),NRF_LOG_FLOAT(tte),NRF_LOG_FLOAT(ttf));  
+#endif
+    PROFILE_END(PROFILE_SCOPE_LOG);
+}
+
+int fuel_gauge_update(void)
+{
+    npm1300_charger_snapshot_t snapshot;
 
+    read_sensors(&snapshot);
+    gauge_step(&snapshot, sample_delta(&snapshot));
+
+    return 0;
+}
+
+#if HW_SAMPLER_ENABLED
+int fuel_gauge_batch_update(hw_sampler_batch_t const *batch)
+{
+    npm1300_charger_snapshot_t snapshot;
+    int64_t start = ref_time;
+    int64_t end = uptime_get();
+    int64_t time;
+
+    /* Entries carry no time stamp. The batch ends right before its interrupt, spread the
+     * samples evenly from the last update up to now.
+     */
+    for (uint32_t i = 0; i < batch->count; i++) {
+        time = start + ((end - start) * (int64_t)(i + 1)) / (int64_t)batch->count;
+
+        /* The bus work was done by the hardware, the fetch is only the copy of the entry */
+        PROFILE_BEGIN(PROFILE_SCOPE_FETCH);
+        npm1300_charger_list_entry_load(&m_charger,
+                                        &batch->p_entries[i * NPM1300_CHARGER_LIST_ENTRY_LEN],
+                                        time);
+        PROFILE_END(PROFILE_SCOPE_FETCH);
+        npm1300_charger_snapshot_get(&m_charger, &snapshot);
+        gauge_step(&snapshot, sample_delta(&snapshot));
+    }
+
+    return 0;
 }
+#endif
@@ -6,8 +6,90 @@
 #ifndef __FUEL_GAUGE_H__
 #define __FUEL_GAUGE_H__
 
+#include <stdint.h>
+#include "npm1300_charger.h"
+#if HW_SAMPLER_ENABLED
+#include "hw_sampler.h"
+#endif
 
+/**
+ * @brief Configure the PMIC and initialize the gauge from a first sample.
+ *
+ * @details With FUEL_GAUGE_WARM_BOOT_ENABLED, a PMIC configured before an nRF reset is taken
+ *          over without running the init sequence, and the gauge is seeded with the inputs
+ *          of the last update before the reset. GPREGRET and a RAM section that the startup
+ *          code does not initialize carry the state across the reset.
+ *          With FUEL_GAUGE_CHECKPOINT_ENABLED, a cold start continues from the state of charge
+ *          of the last checkpoint in flash, as long as the first sample roughly agrees with
+ *          it. Checkpoints are written while updating.
+ */
 int fuel_gauge_init(void);
 int fuel_gauge_update(void);
 
+#if HW_SAMPLER_ENABLED
+/**
+ * @brief Feed a batch of samples taken by the hardware sampler to the gauge.
+ *
+ * @details Each entry goes through the same processing as a @ref fuel_gauge_update, in order.
+ *          The entries are not time stamped, they are spread evenly over the time since the
+ *          last update. The charger snapshot holds the last entry afterwards.
+ */
+int fuel_gauge_batch_update(hw_sampler_batch_t const *batch);
+#endif
+
+/**
+ * @brief Get the sampling period wanted by the fuel gauge.
+ *
+ * @details With FUEL_GAUGE_ADAPTIVE_ENABLED the period doubles on every steady sample up to
+ *          FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS, and drops back to FUEL_GAUGE_SAMPLE_PERIOD_MS on
+ *          a load step, a charger state change or a VBUS change. Otherwise it is fixed.
+ *
+ * @return Period in milliseconds to use after the last @ref fuel_gauge_update.
+ */
+uint32_t fuel_gauge_period_get(void);
+
+/**
+ * @brief Get the state of charge of the last @ref fuel_gauge_update.
+ *
+ * @details After a warm restart with FUEL_GAUGE_WARM_BOOT_ENABLED, the state of charge from
+ *          before the reset is returned until the first update, after a cold start the one
+ *          of the checkpoint the gauge was seeded with. NaN otherwise.
+ *
+ * @return State of charge in percent.
+ */
+float fuel_gauge_soc_get(void);
+
+/**
+ * @brief Get the time to empty after the last @ref fuel_gauge_update.
+ *
+ * @details Estimated on the first call after an update, and only while the battery is
+ *          discharging. Later calls return the cached value.
+ *
+ * @return Time to empty in seconds, NaN while charging, before the first update, or when
+ *         the gauge has no estimate.
+ */
+float fuel_gauge_tte_get(void);
+
+/**
+ * @brief Get the time to full after the last @ref fuel_gauge_update.
+ *
+ * @details Estimated on the first call after an update, and only while the battery is
+ *          charging, with the charge current and the termination current configured in
+ *          the charger. Later calls return the cached value.
+ *
+ * @return Time to full in seconds, NaN while discharging, before the first update, or when
+ *         the gauge has no estimate.
+ */
+float fuel_gauge_ttf_get(void);
+
+/**
+ * @brief Get the charger of the gauged battery, initialized by @ref fuel_gauge_init.
+ */
+npm1300_charger_t *fuel_gauge_charger_get(void);
+
+/**
+ * @brief Get the queue of the PMIC bus, for other devices on the same bus.
+ */
+twi_queue_t *fuel_gauge_twi_queue_get(void);
+
 #endif /* __FUEL_GAUGE_H__ */
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sdk_common.h"
+#if HW_SAMPLER_ENABLED
+#include <string.h>
+#include "nrfx_ppi.h"
+#include "nrfx_rtc.h"
+#include "nrfx_timer.h"
+#include "app_util_platform.h"
+#include "hw_sampler.h"
+
+#if !TWI_QUEUE_USE_TWIM
+#error "HW_SAMPLER_ENABLED needs TWI_QUEUE_USE_TWIM, the TWI peripheral has no EasyDMA list"
+#endif
+
+/* RTC without prescaler, the 24-bit counter wraps after 512 s */
+#define RTC_FREQ         32768UL
+#define RTC_COUNTER_MAX  0xFFFFFFUL
+
+/* Shortest period, several list transfers long at 100 kbps */
+#define TICKS_MIN        (RTC_FREQ / 100UL)
+
+/* Two batches, and a spare entry for a tick that comes before the list is moved back to
+ * the start, see timer_handler().
+ */
+#define LIST_ENTRIES     (2U * HW_SAMPLER_BATCH)
+#define LIST_SPARE       LIST_ENTRIES
+
+/* TIMER1 channels: the batch ends, the count captured by every tick and a scratch channel
+ * for reading the count.
+ */
+#define CC_BATCH0        NRF_TIMER_CC_CHANNEL0
+#define CC_BATCH1        NRF_TIMER_CC_CHANNEL1
+#define CC_TICK          NRF_TIMER_CC_CHANNEL2
+#define CC_NOW           NRF_TIMER_CC_CHANNEL3
+
+/* Value of CC_TICK before the first tick, never reached by the count */
+#define COUNT_NONE       0xFFFFUL
+
+STATIC_ASSERT(LIST_ENTRIES < COUNT_NONE);
+
+static const nrfx_rtc_t   m_rtc   = NRFX_RTC_INSTANCE(2);
+static const nrfx_timer_t m_timer = NRFX_TIMER_INSTANCE(1);
+
+static twi_queue_t *      mp_queue;
+static twi_queue_xfer_t   m_xfer;
+static uint8_t            m_list[LIST_ENTRIES + 1U][NPM1300_CHARGER_LIST_ENTRY_LEN];
+static nrf_ppi_channel_t  m_ppi_tick;   /* RTC COMPARE0 to TWIM STARTTX, fork to TIMER CAPTURE2 */
+static nrf_ppi_channel_t  m_ppi_clear;  /* RTC COMPARE0 to RTC CLEAR */
+static nrf_ppi_channel_t  m_ppi_count;  /* TWIM STOPPED to TIMER COUNT */
+static volatile uint8_t   m_ready;      /* Bit per batch completed and not taken */
+static uint8_t            m_next;       /* Batch handed out next */
+static volatile bool      m_bus_queue;  /* The TWI queue owns the bus */
+static hw_sampler_stats_t m_stats;
+
+static uint32_t count_get(void)
+{
+    return nrfx_timer_capture(&m_timer, CC_NOW);
+}
+
+/* A tick captures the count as it starts the transfer, the count moves on once the
+ * transfer has stopped.
+ */
+static bool transfer_in_progress(void)
+{
+    return nrfx_timer_capture_get(&m_timer, CC_TICK) == count_get();
+}
+
+/* Set up the transfer the next tick starts, reading into the entry of the current count.
+ * TWIM moves the read pointer on by one entry after every transfer.
+ */
+static void list_arm(void)
+{
+    nrfx_twim_xfer_desc_t const desc = NRFX_TWIM_XFER_DESC_TXRX(m_xfer.address,
+                                                                (uint8_t *)m_xfer.p_tx,
+                                                                m_xfer.tx_len,
+                                                                m_list[count_get()],
+                                                                m_xfer.rx_len);
+
+    APP_ERROR_CHECK(nrfx_twim_xfer(twi_queue_instance_get(mp_queue), &desc,
+                                   NRFX_TWIM_FLAG_HOLD_XFER | NRFX_TWIM_FLAG_REPEATED_XFER |
+                                   NRFX_TWIM_FLAG_RX_POSTINC |
+                                   NRFX_TWIM_FLAG_NO_XFER_EVT_HANDLER));
+}
+
+/* Stop starting transfers and wait for the one in progress, then stop counting, transfers
+ * of the queue end with STOPPED as well. Called with interrupts disabled.
+ */
+static void list_hold(void)
+{
+    nrfx_ppi_channel_disable(m_ppi_tick);
+
+    while (transfer_in_progress())
+    {
+        /* One list transfer at most, below 1 ms at 400 kbps */
+    }
+
+    nrfx_ppi_channel_disable(m_ppi_count);
+}
+
+/* Called with interrupts disabled. */
+static void list_resume(void)
+{
+    list_arm();
+    nrfx_ppi_channel_enable(m_ppi_count);
+    nrfx_ppi_channel_enable(m_ppi_tick);
+}
+
+static void bus_acquire(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    list_hold();
+    m_bus_queue = true;
+    m_stats.handovers++;
+}
+
+static void bus_release(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    list_resume();
+    m_bus_queue = false;
+}
+
+static const twi_queue_bus_hook_t m_bus_hook =
+{
+    .acquire   = bus_acquire,
+    .release   = bus_release,
+    .p_context = NULL,
+};
+
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    uint8_t batch = (event_type == NRF_TIMER_EVENT_COMPARE0) ? 0U : 1U;
+
+    UNUSED_PARAMETER(p_context);
+
+    if (batch == 1U)
+    {
+        /* The count has been cleared, move the list back to the start. While the queue
+         * owns the bus this is done when the bus is released.
+         */
+        CRITICAL_REGION_ENTER();
+        if (!m_bus_queue)
+        {
+            list_hold();
+
+            /* A tick came before the interrupt was handled and read into the spare entry */
+            if (count_get() == 1U)
+            {
+                memcpy(m_list[0], m_list[LIST_SPARE], sizeof(m_list[0]));
+            }
+
+            list_resume();
+        }
+        CRITICAL_REGION_EXIT();
+    }
+
+    if ((m_ready & (1U << batch)) != 0U)
+    {
+        m_stats.overruns++;
+    }
+    m_ready |= (uint8_t)(1U << batch);
+    m_stats.batches++;
+
+    /* Wake up the main loop if the interrupt arrived just before it went to sleep. */
+    __SEV();
+}
+
+/* Compare events only go to PPI, nrfx_rtc needs a handler all the same. */
+static void rtc_handler(nrfx_rtc_int_type_t int_type)
+{
+    UNUSED_PARAMETER(int_type);
+}
+
+static uint32_t period_ticks_get(uint32_t period_ms)
+{
+    uint64_t ticks = ((uint64_t)period_ms * RTC_FREQ) / 1000U;
+
+    if ((ticks < TICKS_MIN) || (ticks > RTC_COUNTER_MAX))
+    {
+        return 0;
+    }
+
+    return (uint32_t)ticks;
+}
+
+static ret_code_t ppi_channel_setup(nrf_ppi_channel_t * p_channel, uint32_t eep, uint32_t tep)
+{
+    ret_code_t err_code;
+
+    err_code = nrfx_ppi_channel_alloc(p_channel);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    return nrfx_ppi_channel_assign(*p_channel, eep, tep);
+}
+
+ret_code_t hw_sampler_init(twi_queue_t * p_queue, npm1300_charger_t const * p_charger)
+{
+    nrfx_rtc_config_t   rtc_config   = NRFX_RTC_DEFAULT_CONFIG;
+    nrfx_timer_config_t timer_config = NRFX_TIMER_DEFAULT_CONFIG;
+    nrfx_twim_t const * p_twim       = twi_queue_instance_get(p_queue);
+    uint32_t            compare;
+    ret_code_t          err_code;
+
+    mp_queue = p_queue;
+    npm1300_charger_list_xfer_get(p_charger, &m_xfer);
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    rtc_config.prescaler = 0U;
+    err_code = nrfx_rtc_init(&m_rtc, &rtc_config, rtc_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    timer_config.mode      = NRF_TIMER_MODE_COUNTER;
+    timer_config.bit_width = NRF_TIMER_BIT_WIDTH_16;
+    err_code = nrfx_timer_init(&m_timer, &timer_config, timer_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    nrfx_timer_compare(&m_timer, CC_BATCH0, HW_SAMPLER_BATCH, true);
+    nrfx_timer_extended_compare(&m_timer, CC_BATCH1, LIST_ENTRIES,
+                                NRF_TIMER_SHORT_COMPARE1_CLEAR_MASK, true);
+
+    compare = nrfx_rtc_event_address_get(&m_rtc, NRF_RTC_EVENT_COMPARE_0);
+
+    err_code = ppi_channel_setup(&m_ppi_tick, compare,
+                                 nrfx_twim_start_task_get(p_twim, NRFX_TWIM_XFER_TXRX));
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    err_code = nrfx_ppi_channel_fork_assign(m_ppi_tick,
+                                            nrfx_timer_capture_task_address_get(&m_timer, CC_TICK));
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    /* The counter is cleared one tick after the compare event. */
+    err_code = ppi_channel_setup(&m_ppi_clear, compare,
+                                 nrfx_rtc_task_address_get(&m_rtc, NRF_RTC_TASK_CLEAR));
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    err_code = ppi_channel_setup(&m_ppi_count, nrfx_twim_stopped_event_get(p_twim),
+                                 nrfx_timer_task_address_get(&m_timer, NRF_TIMER_TASK_COUNT));
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    return nrfx_ppi_channel_enable(m_ppi_clear);
+}
+
+ret_code_t hw_sampler_start(uint32_t period_ms)
+{
+    uint32_t ticks = period_ticks_get(period_ms);
+
+    if (ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    hw_sampler_stop();
+
+    m_ready = 0U;
+    m_next  = 0U;
+
+    nrfx_timer_clear(&m_timer);
+    nrfx_timer_compare(&m_timer, CC_TICK, COUNT_NONE, false);
+    nrfx_timer_enable(&m_timer);
+
+    /* Cannot fail without the reliable mode */
+    (void)nrfx_rtc_cc_set(&m_rtc, 0, ticks - 1U, false);
+    nrfx_rtc_counter_clear(&m_rtc);
+    nrfx_rtc_enable(&m_rtc);
+
+    /* Hands the bus over and arms the list right away when the queue is idle */
+    twi_queue_bus_hook_set(mp_queue, &m_bus_hook);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t hw_sampler_period_set(uint32_t period_ms)
+{
+    uint32_t ticks = period_ticks_get(period_ms);
+
+    if (ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    /* A counter past the compare value would run through the whole counter range first */
+    CRITICAL_REGION_ENTER();
+    (void)nrfx_rtc_cc_set(&m_rtc, 0, ticks - 1U, false);
+    if (nrfx_rtc_counter_get(&m_rtc) >= (ticks - 1U))
+    {
+        nrfx_rtc_counter_clear(&m_rtc);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+void hw_sampler_stop(void)
+{
+    /* Waits for a list transfer in progress */
+    twi_queue_bus_hook_set(mp_queue, NULL);
+
+    nrfx_rtc_disable(&m_rtc);
+    nrfx_timer_disable(&m_timer);
+}
+
+bool hw_sampler_batch_take(hw_sampler_batch_t * p_batch)
+{
+    bool ready;
+
+    CRITICAL_REGION_ENTER();
+    ready    = (m_ready & (1U << m_next)) != 0U;
+    m_ready &= (uint8_t)~(1U << m_next);
+    CRITICAL_REGION_EXIT();
+
+    if (!ready)
+    {
+        return false;
+    }
+
+    p_batch->p_entries = m_list[m_next * HW_SAMPLER_BATCH];
+    p_batch->count     = HW_SAMPLER_BATCH;
+    m_next ^= 1U;
+
+    return true;
+}
+
+void hw_sampler_stats_get(hw_sampler_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+}
+
+#endif // HW_SAMPLER_ENABLED
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup hw_sampler Hardware sample list
+ * @{
+ * @brief Periodic PMIC sampling by RTC, PPI and TWIM, without waking the CPU.
+ *
+ * @details Every compare event of RTC2 starts the sample list transfer of the charger
+ *          (see @ref npm1300_charger_list_xfer_get) through PPI, and TWIM writes each read
+ *          to the next entry of a list in RAM. TIMER1 counts the transfers in counter mode
+ *          and interrupts the CPU once every HW_SAMPLER_BATCH entries. The list holds two
+ *          batches, one is processed while the hardware fills the other.
+ *
+ *          The sampler shares the bus with the TWI queue through @ref twi_queue_bus_hook_set.
+ *          Ticks while the queue runs a transaction are skipped, the list only moves on with
+ *          completed transfers, so a batch is always contiguous but can span more than
+ *          HW_SAMPLER_BATCH periods.
+ *
+ *          The interrupt at the end of the list must be served within one period, a tick
+ *          before that goes to a spare entry and a second one would run past the list.
+ *
+ *          RTC2 and TIMER1 are reserved for the sampler, RTC1 is used by app_timer. Needs
+ *          TWI_QUEUE_USE_TWIM.
+ */
+
+#ifndef HW_SAMPLER_H__
+#define HW_SAMPLER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "twi_queue.h"
+#include "npm1300_charger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Samples taken by the hardware, for @ref npm1300_charger_list_entry_load. */
+typedef struct
+{
+    uint8_t const * p_entries; /**< NPM1300_CHARGER_LIST_ENTRY_LEN bytes per sample, oldest first. */
+    uint32_t        count;     /**< Number of samples. */
+} hw_sampler_batch_t;
+
+/** @brief Sampler statistics. */
+typedef struct
+{
+    uint32_t batches;   /**< Batches completed by the hardware. */
+    uint32_t overruns;  /**< Batches completed again before they were taken. */
+    uint32_t handovers; /**< Times the TWI queue took the bus over. */
+} hw_sampler_stats_t;
+
+/**
+ * @brief Function for setting up the RTC, TIMER and PPI channels.
+ *
+ * @param[in] p_queue   Queue of the bus the PMIC is on, must use TWIM.
+ * @param[in] p_charger Initialized charger to sample.
+ *
+ * @return Error code of the nrfx drivers, NRF_ERROR_NO_MEM when no PPI channel is left.
+ */
+ret_code_t hw_sampler_init(twi_queue_t * p_queue, npm1300_charger_t const * p_charger);
+
+/**
+ * @brief Function for starting periodic sampling.
+ *
+ * @details The first sample is taken one period after the call, unless the queue is busy.
+ *
+ * @retval NRF_SUCCESS             Sampling started.
+ * @retval NRF_ERROR_INVALID_PARAM Period is below 10 ms or does not fit the RTC counter range.
+ */
+ret_code_t hw_sampler_start(uint32_t period_ms);
+
+/**
+ * @brief Function for changing the period of a running sampler.
+ *
+ * @details Applied from the next tick. A counter already past the new period is cleared,
+ *          that period is cut short.
+ *
+ * @retval NRF_SUCCESS             Period changed.
+ * @retval NRF_ERROR_INVALID_PARAM Period is below 10 ms or does not fit the RTC counter range.
+ */
+ret_code_t hw_sampler_period_set(uint32_t period_ms);
+
+/**
+ * @brief Function for stopping periodic sampling and leaving the bus to the queue.
+ *
+ * @details Samples of an unfinished batch are dropped.
+ */
+void hw_sampler_stop(void);
+
+/**
+ * @brief Function for taking the next completed batch.
+ *
+ * @details Batches are handed out in order. The entries stay valid until the hardware
+ *          has filled the other batch, HW_SAMPLER_BATCH periods at the least. Must be called
+ *          from thread mode.
+ *
+ * @param[out] p_batch Batch.
+ *
+ * @return False if no batch has been completed since the last call.
+ */
+bool hw_sampler_batch_take(hw_sampler_batch_t * p_batch);
+
+/**
+ * @brief Function for getting the sampler statistics.
+ */
+void hw_sampler_stats_get(hw_sampler_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HW_SAMPLER_H__
+
+/** @} */
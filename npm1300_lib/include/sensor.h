@@ -169,6 +169,10 @@ enum sensor_channel {
 enum sensor_channel_npm1300_charger {
 	SENSOR_CHAN_NPM1300_CHARGER_STATUS = SENSOR_CHAN_PRIV_START,
 	SENSOR_CHAN_NPM1300_CHARGER_ERROR,
+	SENSOR_CHAN_NPM1300_CHARGER_VBUS_STATUS,
+	SENSOR_CHAN_NPM1300_CHARGER_VSYS,
+	SENSOR_CHAN_NPM1300_CHARGER_VBUS_VOLTAGE,
+	SENSOR_CHAN_NPM1300_CHARGER_TERM_CURRENT,
 };
 
 #endif
@@ -2,60 +2,27 @@
  * Copyright (c) 2023 Nordic Semiconductor ASA
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <math.h>
-#include "nrf_drv_twi.h"
+#include <string.h>
 #include "sensor.h"
 #include "linear_range.h"
 #include "util.h"
-
-/* Common addresses definition for temperature sensor. */
-#define NPM1300_ADDR             0x6B  //   (0x6BU >> 1)
-#define ARDUINO_SCL_PIN             27    // SCL signal pin
-#define ARDUINO_SDA_PIN             26    // SDA signal pin
-/* TWI instance. */
-static const  nrfx_twi_t m_twi = NRFX_TWI_INSTANCE(0);  
-/* Indicates if operation on TWI has ended. */
-static volatile bool m_xfer_done = false;
-
-struct npm1300_charger_config {
-	int32_t term_microvolt;
-	int32_t term_warm_microvolt;
-	int32_t current_microamp;
-	int32_t dischg_limit_microamp;
-	int32_t vbus_limit_microamp;
-	uint8_t thermistor_idx;
-	uint16_t thermistor_beta;
-	bool charging_enable;
-};
-
-static struct npm1300_charger_config config = {
-    .term_microvolt = 4150000,
-   .term_warm_microvolt = 4000000, 
-   .current_microamp = 150000,
-   .dischg_limit_microamp = 1000000,
-   .vbus_limit_microamp = 500000,
-   .thermistor_beta = 3380,
-   .charging_enable = true,
-}; 
-
-struct npm1300_charger_data {
-	uint16_t voltage;
-	uint16_t current;
-	uint16_t temp;
-	uint8_t status;
-	uint8_t error;
-	uint8_t ibat_stat;
-	uint8_t vbus_stat;
-};
-
-static struct npm1300_charger_data npm1300_data = {0};
-
-
+#include "app_util_platform.h"
+#include "nrf_assert.h"
+#include "twi_queue.h"
+#include "ntc_temp.h"
+#include "uptime.h"
+#include "profile.h"
+#include "npm1300_charger.h"
+#if NPM1300_EVENTS_ENABLED
+#include "npm1300_events.h"
+#endif
 
 /* nPM1300 base addresses */
 #define CHGR_BASE 0x03U
 #define ADC_BASE  0x05U
 #define VBUS_BASE 0x02U
+#define BUCK_BASE 0x04U
+#define LDSW_BASE 0x08U
 
 /* nPM1300 charger register offsets */
 #define CHGR_OFFSET_EN_SET	0x04U
@@ -64,12 +31,16 @@ static struct npm1300_charger_data npm1300_data = {0};
 #define CHGR_OFFSET_ISET_DISCHG 0x0AU
 #define CHGR_OFFSET_VTERM	0x0CU
 #define CHGR_OFFSET_VTERM_R	0x0DU
+#define CHGR_OFFSET_ITERM_SEL	0x0FU
 #define CHGR_OFFSET_CHG_STAT	0x34U
 #define CHGR_OFFSET_ERR_REASON	0x36U
 
 /* nPM1300 ADC register offsets */
 #define ADC_OFFSET_TASK_VBAT 0x00U
 #define ADC_OFFSET_TASK_TEMP 0x01U
+#define ADC_OFFSET_TASK_DIE  0x02U
+#define ADC_OFFSET_TASK_VSYS 0x03U
+#define ADC_OFFSET_TASK_VBUS 0x07U
 #define ADC_OFFSET_CONFIG    0x09U
 #define ADC_OFFSET_NTCR_SEL  0x0AU
 #define ADC_OFFSET_RESULTS   0x10U
@@ -80,11 +51,16 @@ static struct npm1300_charger_data npm1300_data = {0};
 #define VBUS_OFFSET_ILIM	0x01U
 #define VBUS_OFFSET_STATUS	0x07U
 
-/* Ibat status */
-#define IBAT_STAT_DISCHARGE	 0x04U
-#define IBAT_STAT_CHARGE_TRICKLE 0x0CU
-#define IBAT_STAT_CHARGE_COOL	 0x0DU
-#define IBAT_STAT_CHARGE_NORMAL	 0x0FU
+/* nPM1300 buck register offsets */
+#define BUCK_OFFSET_BUCK2_NORM_VOUT 0x0AU
+#define BUCK_OFFSET_BUCK2_RET_VOUT  0x0BU
+#define BUCK_OFFSET_EN_CTRL	    0x0CU
+#define BUCK_OFFSET_VRET_CTRL	    0x0DU
+#define BUCK_OFFSET_PWM_CTRL	    0x0EU
+#define BUCK_OFFSET_SW_CTRL	    0x0FU
+
+/* nPM1300 load switch register offsets */
+#define LDSW_OFFSET_GPISEL 0x05U
 
 struct adc_results_t {
 	uint8_t ibat_stat;
@@ -100,14 +76,18 @@ struct adc_results_t {
 	uint8_t lsb_b;
 } __packed;
 
-static struct adc_results_t adc_results={0};
+STATIC_ASSERT(sizeof(struct adc_results_t) == NPM1300_CHARGER_ADC_RESULTS_LEN);
+STATIC_ASSERT(CHGR_OFFSET_ERR_REASON - CHGR_OFFSET_CHG_STAT + 1U == NPM1300_CHARGER_STATUS_LEN);
 
 /* ADC result masks */
 #define ADC_MSB_SHIFT	   2U
 #define ADC_LSB_MASK	   0x03U
 #define ADC_LSB_VBAT_SHIFT 0U
 #define ADC_LSB_NTC_SHIFT  2U
+#define ADC_LSB_DIE_SHIFT  4U
+#define ADC_LSB_VSYS_SHIFT 6U
 #define ADC_LSB_IBAT_SHIFT 4U
+#define ADC_LSB_VBUS_SHIFT 6U
 
 /* Linear range for charger terminal voltage */
 static const struct linear_range charger_volt_ranges[] = {
@@ -123,249 +103,1232 @@ static const struct linear_range discharge_limit_range = LINEAR_RANGE_INIT(26809
 static const struct linear_range vbus_current_ranges[] = {
 	LINEAR_RANGE_INIT(100000, 0, 1U, 1U), LINEAR_RANGE_INIT(500000, 100000, 5U, 15U)};
 
+/* Read multiple registers from specified address */
+/* base= device address
+   offset = reg
+ */
+static void reg_read_burst(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset,
+                           void *data, size_t len)
+{
+    uint8_t buffer[]={base, offset};
+    twi_queue_xfer_t const xfer = TWI_QUEUE_READ(p_charger->config.address, buffer, sizeof(buffer), data, len);
+
+    APP_ERROR_CHECK(twi_queue_perform(p_charger->config.p_queue, &xfer, 1U));
+}
+
+/* Battery temperature in millidegrees Celsius */
+static int32_t calc_temp(npm1300_charger_config_t const *config, uint16_t code)
+{
+    /* The generated table avoids log() and the float divisions, fall back to the formula
+     * for a thermistor the table was not generated for.
+     */
+    if (config->thermistor_beta == ntc_temp_lut_beta_get()) {
+        return ntc_temp_lut_get(code);
+    }
+
+    return (int32_t)(ntc_temp_calc(code, config->thermistor_beta) * 1000.f);
+}
+
+static uint16_t adc_get_res(uint8_t msb, uint8_t lsb, uint16_t lsb_shift)
+{
+    return ((uint16_t)msb << ADC_MSB_SHIFT) | ((lsb >> lsb_shift) & ADC_LSB_MASK);
+}
+
+/* Die temperature in millidegrees: 394.67 C minus 0.7926 C per code */
+static int32_t calc_die_temp(uint16_t code)
+{
+    return 394670 - (((int32_t)code * 3963) / 5);
+}
+
+/* Battery current in microamperes, positive when discharging */
+static int32_t calc_current(npm1300_charger_config_t const *config,
+                            struct npm1300_charger_data const *const data)
+{
+    int32_t full_scale_ua;
+
+    switch (data->ibat_stat) {
+    case NPM1300_CHARGER_IBAT_STAT_DISCHARGE:
+        full_scale_ua = config->dischg_limit_microamp;
+        break;
+    case NPM1300_CHARGER_IBAT_STAT_CHARGE_TRICKLE:
+        full_scale_ua = -config->current_microamp / 10;
+        break;
+    case NPM1300_CHARGER_IBAT_STAT_CHARGE_COOL:
+        full_scale_ua = -config->current_microamp / 2;
+        break;
+    case NPM1300_CHARGER_IBAT_STAT_CHARGE_NORMAL:
+        full_scale_ua = -config->current_microamp;
+        break;
+    default:
+        full_scale_ua = 0;
+        break;
+    }
+
+    /* Full scale stays below 2^21 uA, so the product fits */
+    return (data->current * full_scale_ua) / 1024;
+}
+
+/* Channel groups of the snapshot, each converted on first use for a sample */
+#define SNAPSHOT_VOLTAGE  (1U << 0)
+#define SNAPSHOT_CURRENT  (1U << 1)
+#define SNAPSHOT_TEMP     (1U << 2)
+#define SNAPSHOT_DIE_TEMP (1U << 3)
+#define SNAPSHOT_VSYS     (1U << 4)
+#define SNAPSHOT_VBUS     (1U << 5)
+#define SNAPSHOT_ALL      (SNAPSHOT_VOLTAGE | SNAPSHOT_CURRENT | SNAPSHOT_TEMP | \
+                           SNAPSHOT_DIE_TEMP | SNAPSHOT_VSYS | SNAPSHOT_VBUS)
+
+/* Convert the given channels of the last sample into the cached snapshot, unless they
+ * already are. Status fields come with any channel.
+ */
+static npm1300_charger_snapshot_t const *snapshot_decode(npm1300_charger_t *p_charger,
+                                                         uint8_t channels)
+{
+    npm1300_charger_snapshot_t *snap = &p_charger->snapshot;
+    struct npm1300_charger_data data;
+    uint32_t generation;
+    uint8_t missing;
+
+    /* Nothing new since the last call */
+    if ((snap->generation == p_charger->generation) &&
+        ((p_charger->snapshot_decoded & channels) == channels)) {
+        return snap;
+    }
+
+    CRITICAL_REGION_ENTER();
+    data = p_charger->data;
+    generation = p_charger->generation;
+    CRITICAL_REGION_EXIT();
+
+    if (snap->generation != generation) {
+        p_charger->snapshot_decoded = 0U;
+        snap->generation = generation;
+        snap->time_ms = data.time_ms;
+        snap->status = data.status;
+        snap->error = data.error;
+        snap->vbus_stat = data.vbus_stat;
+        snap->ibat_stat = data.ibat_stat;
+    }
+
+    missing = channels & ~p_charger->snapshot_decoded;
+
+    PROFILE_BEGIN(PROFILE_SCOPE_CONVERT);
+    if (missing & SNAPSHOT_VOLTAGE) {
+        /* VBAT full scale is 5 V: 5000000 / 1024 uV per code */
+        snap->voltage_uv = ((int32_t)data.voltage * 78125) / 16;
+        snap->voltage = (float)snap->voltage_uv * 1e-6f;
+    }
+    if (missing & SNAPSHOT_CURRENT) {
+        snap->current_ua = calc_current(&p_charger->config, &data);
+        snap->current = (float)snap->current_ua * 1e-6f;
+    }
+    if (missing & SNAPSHOT_TEMP) {
+        snap->temp_mdeg = calc_temp(&p_charger->config, data.temp);
+        snap->temp = (float)snap->temp_mdeg * 1e-3f;
+    }
+    if (missing & SNAPSHOT_DIE_TEMP) {
+        snap->die_temp_mdeg = calc_die_temp(data.die_temp);
+        snap->die_temp = (float)snap->die_temp_mdeg * 1e-3f;
+    }
+    /* VSYS and VBUS full scales are 6.375 V and 7.5 V */
+    if (missing & SNAPSHOT_VSYS) {
+        snap->vsys_uv = ((int32_t)data.vsys * 796875) / 128;
+        snap->vsys = (float)snap->vsys_uv * 1e-6f;
+    }
+    if (missing & SNAPSHOT_VBUS) {
+        snap->vbus_uv = ((int32_t)data.vbus * 234375) / 32;
+        snap->vbus = (float)snap->vbus_uv * 1e-6f;
+    }
+
+    PROFILE_END(PROFILE_SCOPE_CONVERT);
+    p_charger->snapshot_decoded |= missing;
+
+    return snap;
+}
+
+void npm1300_charger_snapshot_get(npm1300_charger_t *p_charger, npm1300_charger_snapshot_t *p_snapshot)
+{
+    *p_snapshot = *snapshot_decode(p_charger, SNAPSHOT_ALL);
+}
+
+static ret_code_t charge_current_encode(int32_t microamp, uint8_t *data);
+
+/* Termination current: the configured share of the charge current actually programmed,
+ * decoded from the ISET index that charge_current_encode writes.
+ */
+static int32_t term_current_get(npm1300_charger_t const *p_charger)
+{
+    npm1300_charger_config_t const *config = &p_charger->config;
+    uint8_t data[2];
+    int32_t iset;
+
+    if ((charge_current_encode(config->current_microamp, data) != NRF_SUCCESS) ||
+        (linear_range_get_value(&charger_current_range, ((uint32_t)data[0] * 2U) + data[1],
+                                &iset) != 0)) {
+        return 0;
+    }
+
+    return (iset * config->term_current_percent) / 100;
+}
+
+static void value_from_micro(int32_t micro, struct sensor_value *valp)
+{
+    valp->val1 = micro / 1000000;
+    valp->val2 = micro % 1000000;
+}
+
+int npm1300_charger_channel_get(npm1300_charger_t *p_charger, enum sensor_channel chan,
+                                struct sensor_value *valp)
+{
+    npm1300_charger_snapshot_t const *snap;
+    uint8_t channels;
+
+    switch ((uint32_t)chan) {
+    case SENSOR_CHAN_GAUGE_DESIRED_CHARGING_CURRENT:
+        value_from_micro(p_charger->config.current_microamp, valp);
+        return 0;
+    case SENSOR_CHAN_GAUGE_MAX_LOAD_CURRENT:
+        value_from_micro(p_charger->config.dischg_limit_microamp, valp);
+        return 0;
+    case SENSOR_CHAN_GAUGE_VOLTAGE:
+        channels = SNAPSHOT_VOLTAGE;
+        break;
+    case SENSOR_CHAN_GAUGE_TEMP:
+        channels = SNAPSHOT_TEMP;
+        break;
+    case SENSOR_CHAN_GAUGE_AVG_CURRENT:
+        channels = SNAPSHOT_CURRENT;
+        break;
+    case SENSOR_CHAN_DIE_TEMP:
+        channels = SNAPSHOT_DIE_TEMP;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_VSYS:
+        channels = SNAPSHOT_VSYS;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_VBUS_VOLTAGE:
+        channels = SNAPSHOT_VBUS;
+        break;
+    default:
+        /* Status registers, nothing to convert */
+        channels = 0U;
+        break;
+    }
+
+    /* Only the requested channel is converted, once per sample */
+    snap = snapshot_decode(p_charger, channels);
+
+    switch ((uint32_t)chan) {
+    case SENSOR_CHAN_GAUGE_VOLTAGE:
+        value_from_micro(snap->voltage_uv, valp);
+        break;
+    case SENSOR_CHAN_GAUGE_TEMP:
+        valp->val1 = snap->temp_mdeg / 1000;
+        valp->val2 = (snap->temp_mdeg % 1000) * 1000;
+        break;
+    case SENSOR_CHAN_GAUGE_AVG_CURRENT:
+        value_from_micro(snap->current_ua, valp);
+        break;
+    case SENSOR_CHAN_DIE_TEMP:
+        valp->val1 = snap->die_temp_mdeg / 1000;
+        valp->val2 = (snap->die_temp_mdeg % 1000) * 1000;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_VSYS:
+        value_from_micro(snap->vsys_uv, valp);
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_VBUS_VOLTAGE:
+        value_from_micro(snap->vbus_uv, valp);
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_STATUS:
+        valp->val1 = snap->status;
+        valp->val2 = 0;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_ERROR:
+        valp->val1 = snap->error;
+        valp->val2 = 0;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_VBUS_STATUS:
+        valp->val1 = snap->vbus_stat;
+        valp->val2 = 0;
+        break;
+    case SENSOR_CHAN_NPM1300_CHARGER_TERM_CURRENT:
+        value_from_micro(term_current_get(p_charger), valp);
+        break;
+    default:
+        return NRF_ERROR_NOT_SUPPORTED; 
+    }
+
+    return 0;
+}
+
+/* Register addresses and task values used by the sample fetch, shared by all instances.
+ * Referenced by the queued transfers, so they must outlive the transaction, and kept in
+ * RAM for EasyDMA.
+ */
+static uint8_t m_chg_stat_reg[]       = {CHGR_BASE, CHGR_OFFSET_CHG_STAT};
+static uint8_t m_adc_results_reg[]    = {ADC_BASE, ADC_OFFSET_RESULTS};
+static uint8_t m_vbus_status_reg[]    = {VBUS_BASE, VBUS_OFFSET_STATUS};
+static uint8_t m_vbus_task_update[]   = {VBUS_BASE, VBUS_OFFSET_TASK_UPDATE, 1U};
+
+#if NPM1300_CHARGER_FETCH_COALESCED
+/* TASK_VBAT and TASK_TEMP are adjacent, trigger both with one write */
+static uint8_t m_task_vbat_temp[]     = {ADC_BASE, ADC_OFFSET_TASK_VBAT, 1U, 1U};
+#else
+static uint8_t m_err_reason_reg[]     = {CHGR_BASE, CHGR_OFFSET_ERR_REASON};
+static uint8_t m_task_temp[]          = {ADC_BASE, ADC_OFFSET_TASK_TEMP, 1U};
+static uint8_t m_task_vbat[]          = {ADC_BASE, ADC_OFFSET_TASK_VBAT, 1U};
+#endif
+
+#if NPM1300_CHARGER_AUX_ADC_PERIOD
+/* TASK_DIE and TASK_VSYS are adjacent, TASK_VBUS is not */
+static uint8_t m_task_die_vsys[]      = {ADC_BASE, ADC_OFFSET_TASK_DIE, 1U, 1U};
+static uint8_t m_task_vbus[]          = {ADC_BASE, ADC_OFFSET_TASK_VBUS, 1U};
+#endif
+
+/* Sample list transfer: TASK_VBAT and TASK_TEMP, then the read continues at TASK_DIE */
+static uint8_t m_list_tasks[]         = {ADC_BASE, ADC_OFFSET_TASK_VBAT, 1U, 1U};
+
+STATIC_ASSERT(ADC_OFFSET_RESULTS - ADC_OFFSET_TASK_DIE == NPM1300_CHARGER_LIST_SKIP_LEN);
+
+/* Index of ERR_REASON in the raw status */
+#define STATUS_RAW_ERR (CHGR_OFFSET_ERR_REASON - CHGR_OFFSET_CHG_STAT)
+
+/* Number of status reads at the start of the fetch transfers */
+#if NPM1300_CHARGER_FETCH_COALESCED
+#define FETCH_STATUS_XFERS 2U
+#else
+#define FETCH_STATUS_XFERS 3U
+#endif
+
+#if NPM1300_EVENTS_ENABLED
+#define FETCH_FIRST_XFER FETCH_STATUS_XFERS
+#else
+#define FETCH_FIRST_XFER 0U
+#endif
+
+/* Number of auxiliary task writes at the end of the fetch transfers */
+#if NPM1300_CHARGER_AUX_ADC_PERIOD
+#define FETCH_AUX_XFERS 2U
+#else
+#define FETCH_AUX_XFERS 0U
+#endif
+
+#if NPM1300_CHARGER_FETCH_FRESH
+/* ADC results read at the end of the fetch transfers, as a transaction of its own */
+#define FETCH_READ_XFERS 1U
+
+/* Conversions triggered by the fetch: VBAT with the automatic IBAT, and NTC. The auxiliary
+ * fetch adds die temperature, VSYS and VBUS.
+ */
+#define FETCH_CONVERSIONS     3U
+#define FETCH_AUX_CONVERSIONS (FETCH_CONVERSIONS + ((FETCH_AUX_XFERS != 0U) ? 3U : 0U))
+
+/* Wait for a number of conversions in app_timer ticks, rounded up */
+#define CONVERSION_TICKS(_n)                                                               \
+    MAX(APP_TIMER_MIN_TIMEOUT_TICKS,                                                       \
+        (uint32_t)CEIL_DIV((uint64_t)(_n) * NPM1300_CHARGER_CONVERSION_US * APP_TIMER_CLOCK_FREQ, \
+                           1000000ULL * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1U)))
+#else
+#define FETCH_READ_XFERS 0U
+#endif
+
+static void fetch_done(ret_code_t result, void * p_context);
+#if NPM1300_CHARGER_FETCH_FRESH
+static void trigger_done(ret_code_t result, void * p_context);
+static void conversion_timeout(void * p_context);
+#endif
+#if NPM1300_EVENTS_ENABLED
+static void status_done(ret_code_t result, void * p_context);
+#endif
 
-/**
- * @brief TWI events handler.
+/* Build the transfers of the sample fetch on the instance address and buffers. Status reads
+ * come first, so that with NPM1300_EVENTS_ENABLED they can run as their own transaction
+ * when the PMIC reports a change, and the periodic fetch starts at the ADC. With
+ * NPM1300_CHARGER_FETCH_FRESH the ADC results are read last, after the conversion wait.
  */
-void twi_handler(nrfx_twi_evt_t const * p_event, void * p_context)
+static void fetch_xfers_init(npm1300_charger_t * p_charger)
 {
-    switch (p_event->type)
+    uint8_t              addr = p_charger->config.address;
+    twi_queue_xfer_t   * xfer = p_charger->fetch_xfers;
+    uint8_t              count;
+    twi_queue_callback_t fetch_callback;
+
+#if NPM1300_CHARGER_FETCH_COALESCED
+    /* Read charge status and error reason */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_chg_stat_reg, sizeof(m_chg_stat_reg),
+                                               p_charger->status_raw, NPM1300_CHARGER_STATUS_LEN);
+#else
+    /* Read charge status and error reason */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_chg_stat_reg, sizeof(m_chg_stat_reg),
+                                               &p_charger->status_raw[0], 1U);
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_err_reason_reg, sizeof(m_err_reason_reg),
+                                               &p_charger->status_raw[STATUS_RAW_ERR], 1U);
+#endif
+    /* Read vbus status */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_vbus_status_reg, sizeof(m_vbus_status_reg),
+                                               &p_charger->vbus_stat_raw, 1U);
+#if !NPM1300_CHARGER_FETCH_FRESH
+    /* Read adc results */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_adc_results_reg, sizeof(m_adc_results_reg),
+                                               p_charger->adc_raw, NPM1300_CHARGER_ADC_RESULTS_LEN);
+#endif
+#if NPM1300_CHARGER_FETCH_COALESCED
+    /* Trigger current, voltage and temperature measurement */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_task_vbat_temp, sizeof(m_task_vbat_temp));
+#else
+    /* Trigger temperature measurement */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_task_temp, sizeof(m_task_temp));
+    /* Trigger current and voltage measurement */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_task_vbat, sizeof(m_task_vbat));
+#endif
+#if NPM1300_CHARGER_AUX_ADC_PERIOD
+    /* Trigger die temperature, VSYS and VBUS measurement, on every
+     * NPM1300_CHARGER_AUX_ADC_PERIOD-th fetch only
+     */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_task_die_vsys, sizeof(m_task_die_vsys));
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_task_vbus, sizeof(m_task_vbus));
+#endif
+#if NPM1300_CHARGER_FETCH_FRESH
+    /* Read adc results, once the conversions triggered above are complete */
+    *xfer++ = (twi_queue_xfer_t)TWI_QUEUE_READ(addr, m_adc_results_reg, sizeof(m_adc_results_reg),
+                                               p_charger->adc_raw, NPM1300_CHARGER_ADC_RESULTS_LEN);
+#endif
+
+    count = (uint8_t)(xfer - p_charger->fetch_xfers);
+    ASSERT(count <= NPM1300_CHARGER_FETCH_XFERS_MAX);
+
+#if NPM1300_CHARGER_FETCH_FRESH
+    fetch_callback = trigger_done;
+
+    p_charger->results_transaction = (twi_queue_transaction_t) {
+        .callback  = fetch_done,
+        .p_context = p_charger,
+        .p_xfers   = &p_charger->fetch_xfers[count - FETCH_READ_XFERS],
+        .count     = FETCH_READ_XFERS,
+        .priority  = TWI_QUEUE_PRIORITY_NORMAL,
+    };
+
+    p_charger->conversion_timer = &p_charger->conversion_timer_data;
+    APP_ERROR_CHECK(app_timer_create(&p_charger->conversion_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                                     conversion_timeout));
+#else
+    fetch_callback = fetch_done;
+#endif
+
+    p_charger->fetch_transaction = (twi_queue_transaction_t) {
+        .callback  = fetch_callback,
+        .p_context = p_charger,
+        .p_xfers   = &p_charger->fetch_xfers[FETCH_FIRST_XFER],
+        .count     = count - FETCH_FIRST_XFER - FETCH_AUX_XFERS - FETCH_READ_XFERS,
+        .priority  = TWI_QUEUE_PRIORITY_NORMAL,
+    };
+
+    p_charger->fetch_aux_transaction = (twi_queue_transaction_t) {
+        .callback  = fetch_callback,
+        .p_context = p_charger,
+        .p_xfers   = &p_charger->fetch_xfers[FETCH_FIRST_XFER],
+        .count     = count - FETCH_FIRST_XFER - FETCH_READ_XFERS,
+        .priority  = TWI_QUEUE_PRIORITY_NORMAL,
+    };
+
+#if NPM1300_EVENTS_ENABLED
+    /* Status changes are time-critical, read them ahead of samples queued on the bus */
+    p_charger->status_transaction = (twi_queue_transaction_t) {
+        .callback  = status_done,
+        .p_context = p_charger,
+        .p_xfers   = p_charger->fetch_xfers,
+        .count     = FETCH_STATUS_XFERS,
+        .priority  = TWI_QUEUE_PRIORITY_HIGH,
+    };
+#endif
+
+    p_charger->vbus_update_xfer = (twi_queue_xfer_t)TWI_QUEUE_WRITE(addr, m_vbus_task_update,
+                                                                    sizeof(m_vbus_task_update));
+    p_charger->vbus_update_transaction = (twi_queue_transaction_t) {
+        .callback  = NULL,
+        .p_context = NULL,
+        .p_xfers   = &p_charger->vbus_update_xfer,
+        .count     = 1U,
+        .priority  = TWI_QUEUE_PRIORITY_HIGH,
+    };
+}
+
+/* Decode the status registers read by the first FETCH_STATUS_XFERS transfers. The number of
+ * transfers queued on top of them is returned in p_xfers.
+ */
+static ret_code_t status_decode(npm1300_charger_t *p_charger, uint8_t *p_xfers)
+{
+    struct npm1300_charger_data *data = &p_charger->data;
+    ret_code_t ret = NRF_SUCCESS;
+    bool last_vbus;
+
+    data->status = p_charger->status_raw[0];
+    data->error = p_charger->status_raw[STATUS_RAW_ERR];
+
+    /* Set SW current limit on new vbus detection */
+    last_vbus = (data->vbus_stat & 1U) != 0U;
+    data->vbus_stat = p_charger->vbus_stat_raw;
+
+#if NPM1300_CHARGER_AUX_ADC_PERIOD
+    /* VSYS and VBUS have changed, measure them with the next fetch */
+    if (last_vbus != ((data->vbus_stat & 1U) != 0U)) {
+        p_charger->aux_countdown = 0U;
+    }
+#endif
+
+    *p_xfers = 0U;
+    if (!last_vbus && ((data->vbus_stat & 1U) != 0U)) {
+        ret = twi_queue_schedule(p_charger->config.p_queue,
+                                 &p_charger->vbus_update_transaction);
+        *p_xfers = p_charger->vbus_update_transaction.count;
+    }
+
+    return ret;
+}
+
+/* Unpack an ADC result burst into the raw sample, converted at time_ms */
+static void adc_decode(npm1300_charger_t *p_charger, uint8_t const *p_raw, int64_t time_ms)
+{
+    struct npm1300_charger_data *p_data = &p_charger->data;
+    struct adc_results_t const *p_adc = (struct adc_results_t const *)p_raw;
+
+    p_data->voltage = adc_get_res(p_adc->msb_vbat, p_adc->lsb_a, ADC_LSB_VBAT_SHIFT);
+    p_data->temp = adc_get_res(p_adc->msb_ntc, p_adc->lsb_a, ADC_LSB_NTC_SHIFT);
+    p_data->current = adc_get_res(p_adc->msb_ibat, p_adc->lsb_b, ADC_LSB_IBAT_SHIFT);
+    p_data->ibat_stat = p_adc->ibat_stat;
+    /* Auxiliary results come with the same burst, from the last time they were triggered */
+    p_data->die_temp = adc_get_res(p_adc->msb_die, p_adc->lsb_a, ADC_LSB_DIE_SHIFT);
+    p_data->vsys = adc_get_res(p_adc->msb_vsys, p_adc->lsb_a, ADC_LSB_VSYS_SHIFT);
+    p_data->vbus = adc_get_res(p_adc->msb_vbus, p_adc->lsb_b, ADC_LSB_VBUS_SHIFT);
+    p_data->time_ms = time_ms;
+    p_charger->generation++;
+}
+
+static void fetch_done(ret_code_t result, void * p_context)
+{
+    npm1300_charger_t               * p_charger = (npm1300_charger_t *)p_context;
+    npm1300_charger_fetch_handler_t   handler   = p_charger->fetch_handler;
+
+    if (result == NRF_SUCCESS)
     {
-        case NRF_DRV_TWI_EVT_DONE:
-            m_xfer_done = true;
-            break;
+        p_charger->stats.last_xfers = p_charger->p_fetch_current->count + FETCH_READ_XFERS;
+
+#if !NPM1300_EVENTS_ENABLED
+        uint8_t extra_xfers;
+
+        result = status_decode(p_charger, &extra_xfers);
+        p_charger->stats.last_xfers += extra_xfers;
+#endif
+
+        adc_decode(p_charger, p_charger->adc_raw, p_charger->trigger_ms);
+#if !NPM1300_CHARGER_FETCH_FRESH
+        /* The results were triggered by the previous fetch, this one has triggered the next */
+        p_charger->trigger_ms = uptime_get();
+#endif
 
-        default:
-            break;
+        p_charger->stats.samples++;
+        p_charger->stats.xfers += p_charger->stats.last_xfers;
+    }
+
+    p_charger->fetch_busy = false;
+
+    if (handler != NULL)
+    {
+        handler(p_charger, result);
     }
 }
 
+#if NPM1300_CHARGER_FETCH_FRESH
+/* Conversions triggered, read the results once they are complete */
+static void trigger_done(ret_code_t result, void * p_context)
+{
+    npm1300_charger_t * p_charger = (npm1300_charger_t *)p_context;
+    uint32_t            ticks     = CONVERSION_TICKS(FETCH_CONVERSIONS);
 
+    if (result == NRF_SUCCESS)
+    {
+        p_charger->trigger_ms = uptime_get();
+
+        if (p_charger->p_fetch_current == &p_charger->fetch_aux_transaction)
+        {
+            ticks = CONVERSION_TICKS(FETCH_AUX_CONVERSIONS);
+        }
+
+        result = app_timer_start(p_charger->conversion_timer, ticks, p_charger);
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        fetch_done(result, p_charger);
+    }
+}
+
+static void conversion_timeout(void * p_context)
+{
+    npm1300_charger_t * p_charger = (npm1300_charger_t *)p_context;
+    ret_code_t          result;
+
+    result = twi_queue_schedule(p_charger->config.p_queue, &p_charger->results_transaction);
+    if (result != NRF_SUCCESS)
+    {
+        fetch_done(result, p_charger);
+    }
+}
+#endif
+
+#if NPM1300_EVENTS_ENABLED
+static void status_fetch_start(npm1300_charger_t * p_charger)
+{
+    bool start;
+
+    CRITICAL_REGION_ENTER();
+    start = !p_charger->status_busy;
+    p_charger->status_busy = true;
+    p_charger->status_pending = !start;
+    CRITICAL_REGION_EXIT();
+
+    if (start &&
+        (twi_queue_schedule(p_charger->config.p_queue, &p_charger->status_transaction) != NRF_SUCCESS))
+    {
+        p_charger->status_busy = false;
+    }
+}
+
+static void status_done(ret_code_t result, void * p_context)
+{
+    npm1300_charger_t * p_charger = (npm1300_charger_t *)p_context;
+    uint8_t extra_xfers = 0U;
+    bool restart;
 
-void twi_master_init(void)
+    if (result == NRF_SUCCESS)
+    {
+        (void)status_decode(p_charger, &extra_xfers);
+        /* New status, decode the snapshot again */
+        p_charger->generation++;
+        p_charger->stats.status_updates++;
+        p_charger->stats.xfers += FETCH_STATUS_XFERS + extra_xfers;
+    }
+
+    CRITICAL_REGION_ENTER();
+    restart = p_charger->status_pending;
+    p_charger->status_pending = false;
+    p_charger->status_busy = restart;
+    CRITICAL_REGION_EXIT();
+
+    if (restart &&
+        (twi_queue_schedule(p_charger->config.p_queue, &p_charger->status_transaction) != NRF_SUCCESS))
+    {
+        p_charger->status_busy = false;
+    }
+}
+
+/* Charger, battery and VBUS changes, the status registers are read again. */
+static void status_event_handler(uint32_t events, void * p_context)
+{
+    UNUSED_PARAMETER(events);
+
+    status_fetch_start((npm1300_charger_t *)p_context);
+}
+#endif
+
+ret_code_t npm1300_charger_sample_fetch_async(npm1300_charger_t             * p_charger,
+                                              npm1300_charger_fetch_handler_t handler)
 {
     ret_code_t ret;
-    const nrfx_twi_config_t config =
+
+    if (p_charger->fetch_busy)
     {
-       .scl                = ARDUINO_SCL_PIN,
-       .sda                = ARDUINO_SDA_PIN,
-       .frequency          = NRF_DRV_TWI_FREQ_100K,
-       .interrupt_priority = APP_IRQ_PRIORITY_HIGH,
-       .hold_bus_uninit     = false
-    };
+        return NRF_ERROR_BUSY;
+    }
+
+    p_charger->fetch_busy = true;
+    p_charger->fetch_handler = handler;
+    p_charger->p_fetch_current = &p_charger->fetch_transaction;
+
+#if NPM1300_CHARGER_AUX_ADC_PERIOD
+    if (p_charger->aux_countdown == 0U)
+    {
+        p_charger->aux_countdown = NPM1300_CHARGER_AUX_ADC_PERIOD;
+        p_charger->p_fetch_current = &p_charger->fetch_aux_transaction;
+    }
+    p_charger->aux_countdown--;
+#endif
+
+    ret = twi_queue_schedule(p_charger->config.p_queue, p_charger->p_fetch_current);
+    if (ret != NRF_SUCCESS)
+    {
+        p_charger->fetch_busy = false;
+    }
+
+    return ret;
+}
 
-    ret = nrfx_twi_init(&m_twi, &config, twi_handler, NULL);
-    APP_ERROR_CHECK(ret);
+void npm1300_charger_stats_get(npm1300_charger_t const * p_charger, npm1300_charger_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_charger->stats;
+    CRITICAL_REGION_EXIT();
+}
 
-    nrfx_twi_enable(&m_twi);
+void npm1300_charger_list_xfer_get(npm1300_charger_t const * p_charger, twi_queue_xfer_t * p_xfer)
+{
+    *p_xfer = (twi_queue_xfer_t)TWI_QUEUE_READ(p_charger->config.address, m_list_tasks,
+                                               sizeof(m_list_tasks), NULL,
+                                               NPM1300_CHARGER_LIST_ENTRY_LEN);
 }
 
+void npm1300_charger_list_entry_load(npm1300_charger_t * p_charger, uint8_t const * p_entry,
+                                     int64_t time_ms)
+{
+    CRITICAL_REGION_ENTER();
+    adc_decode(p_charger, &p_entry[NPM1300_CHARGER_LIST_SKIP_LEN], time_ms);
+    p_charger->stats.last_xfers = 1U;
+    p_charger->stats.samples++;
+    p_charger->stats.xfers++;
+    CRITICAL_REGION_EXIT();
+}
 
+static void fetch_sync_handler(npm1300_charger_t * p_charger, ret_code_t result)
+{
+    p_charger->fetch_sync_result = result;
+    p_charger->fetch_sync_done = true;
+}
 
-/* Read multiple registers from specified address */
-/* base= device address
-   offset = reg
+void npm1300_charger_sample_fetch(npm1300_charger_t * p_charger)
+{
+    p_charger->fetch_sync_done = false;
+    APP_ERROR_CHECK(npm1300_charger_sample_fetch_async(p_charger, fetch_sync_handler));
+
+    /* Sleep until the TWI interrupt has completed the whole sample. */
+    while (!p_charger->fetch_sync_done)
+    {
+        __WFE();
+    }
+
+    APP_ERROR_CHECK(p_charger->fetch_sync_result);
+}
+
+/* Initialization table, applied in order. Values of configuration registers are
+ * compared against the shadow and only written when they differ, adjacent entries
+ * are merged into burst writes.
  */
-static void reg_read_burst(uint8_t base, uint8_t offset, void *data, size_t len)
+const npm1300_reg_init_t npm1300_charger_init_table[] = {
+    /* Load switch 1 not controlled by GPIO */
+    { LDSW_BASE, LDSW_OFFSET_GPISEL,          0x00U, 0U },
+    /* BUCK2 output voltage, retention voltage and control */
+    { BUCK_BASE, BUCK_OFFSET_BUCK2_NORM_VOUT, 0x17U, 0U },
+    { BUCK_BASE, BUCK_OFFSET_SW_CTRL,         0x02U, 0U },
+    { BUCK_BASE, BUCK_OFFSET_BUCK2_RET_VOUT,  0x0FU, 0U },
+    { BUCK_BASE, BUCK_OFFSET_EN_CTRL,         0x90U, 0U },
+    { BUCK_BASE, BUCK_OFFSET_VRET_CTRL,       0x18U, 0U },
+    { BUCK_BASE, BUCK_OFFSET_VRET_CTRL,       0x98U, 0U },
+    /* NTC thermistor type */
+    { ADC_BASE,  ADC_OFFSET_NTCR_SEL,         0x01U, 0U },
+    /* Charge current, discharge limit, termination voltages and current, and VBUS current
+     * limit are encoded from the charger configuration before this table is applied.
+     */
+    /* Enable automatic battery current measurement */
+    { ADC_BASE,  ADC_OFFSET_IBAT_EN,          0x01U, 0U },
+    /* Trigger current, voltage and temperature measurement */
+    { ADC_BASE,  ADC_OFFSET_TASK_VBAT,        0x01U, NPM1300_REG_INIT_TASK },
+    { ADC_BASE,  ADC_OFFSET_TASK_TEMP,        0x01U, NPM1300_REG_INIT_TASK },
+    /* Enable charging */
+    { CHGR_BASE, CHGR_OFFSET_EN_SET,          0x01U, NPM1300_REG_INIT_TASK },
+    /* Apply the VBUS current limit */
+    { VBUS_BASE, VBUS_OFFSET_TASK_UPDATE,     0x01U, NPM1300_REG_INIT_TASK },
+};
+
+const size_t npm1300_charger_init_table_len = ARRAY_SIZE(npm1300_charger_init_table);
+
+/* Writable configuration registers mirrored in RAM. Each region is filled with one
+ * burst read during init.
+ */
+struct shadow_region {
+    uint8_t base;
+    uint8_t offset;
+    uint8_t len;
+    uint8_t idx;
+};
+
+static const struct shadow_region shadow_regions[] = {
+    { LDSW_BASE, LDSW_OFFSET_GPISEL,          1U,  0U },
+    { BUCK_BASE, BUCK_OFFSET_BUCK2_NORM_VOUT, 6U,  1U },
+    { ADC_BASE,  ADC_OFFSET_NTCR_SEL,         1U,  7U },
+    { ADC_BASE,  ADC_OFFSET_IBAT_EN,          1U,  8U },
+    { CHGR_BASE, CHGR_OFFSET_ISET,            8U,  9U },
+    { VBUS_BASE, VBUS_OFFSET_ILIM,            1U, 17U },
+};
+
+/* Shadowed charger and buck registers checked by the warm init */
+#define CHGR_RETAINED_LEN (CHGR_OFFSET_VTERM_R - CHGR_OFFSET_ISET + 1U)
+#define BUCK_RETAINED_LEN (BUCK_OFFSET_SW_CTRL - BUCK_OFFSET_BUCK2_NORM_VOUT + 1U)
+
+/* Longest burst write produced from the init table */
+#define INIT_BURST_MAX 8U
+
+static uint8_t *shadow_reg(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset)
 {
-    uint8_t buffer[]={base, offset};
+    for (size_t i = 0U; i < ARRAY_SIZE(shadow_regions); i++) {
+        const struct shadow_region *r = &shadow_regions[i];
 
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_tx(&m_twi, NPM1300_ADDR, buffer,sizeof(buffer), true));
-    while (m_xfer_done == false);
+        if ((r->base == base) && (offset >= r->offset) && (offset < (r->offset + r->len))) {
+            return &p_charger->shadow[r->idx + (offset - r->offset)];
+        }
+    }
 
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_rx(&m_twi, NPM1300_ADDR, data, len));
-    while (m_xfer_done == false);
+    return NULL;
 }
 
-static void reg_write(uint8_t base, uint8_t offset, uint8_t data)
-{  
-    uint8_t buffer[] = {base, offset, data};
+static void reg_write_burst(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset,
+                            uint8_t const *data, size_t len)
+{
+    uint8_t buffer[2U + INIT_BURST_MAX];
+    twi_queue_xfer_t const xfer = TWI_QUEUE_WRITE(p_charger->config.address, buffer, 2U + len);
+
+    ASSERT(len <= INIT_BURST_MAX);
+
+    buffer[0] = base;
+    buffer[1] = offset;
+    memcpy(&buffer[2], data, len);
 
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_tx(&m_twi, NPM1300_ADDR, buffer, sizeof(buffer), false));
-    while (m_xfer_done == false);
+    APP_ERROR_CHECK(twi_queue_perform(p_charger->config.p_queue, &xfer, 1U));
+
+    /* Keep the shadow coherent with what was written */
+    for (size_t i = 0U; i < len; i++) {
+        uint8_t *reg = shadow_reg(p_charger, base, offset + i);
+
+        if (reg != NULL) {
+            *reg = data[i];
+        }
+    }
 }
 
-static void reg_write2(uint8_t base, uint8_t offset, uint8_t data1,uint8_t data2)
+/* Read a configuration register from the shadow, falling back to the bus for
+ * registers that are not mirrored.
+ */
+static uint8_t reg_read_cached(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset)
 {
-    uint8_t buffer[] = {base, offset, data1, data2};
+    uint8_t *reg = shadow_reg(p_charger, base, offset);
+    uint8_t data;
+
+    if (p_charger->shadow_valid && (reg != NULL)) {
+        return *reg;
+    }
 
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_tx(&m_twi, NPM1300_ADDR, buffer, sizeof(buffer), false));
-    while (m_xfer_done == false);
+    reg_read_burst(p_charger, base, offset, &data, sizeof(data));
+
+    return data;
 }
 
-static void reg_read(uint8_t base, uint8_t offset, uint8_t * pdata)
+static void shadow_load(npm1300_charger_t *p_charger)
 {
-    uint8_t buffer[]= { base, offset}; 
-   
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_tx(&m_twi, NPM1300_ADDR, buffer, sizeof(buffer), true));
-    while (m_xfer_done == false);
+    for (size_t i = 0U; i < ARRAY_SIZE(shadow_regions); i++) {
+        const struct shadow_region *r = &shadow_regions[i];
+
+        reg_read_burst(p_charger, r->base, r->offset, &p_charger->shadow[r->idx], r->len);
+    }
 
-    m_xfer_done = false;
-    APP_ERROR_CHECK(nrfx_twi_rx(&m_twi, NPM1300_ADDR, pdata, 1U));
-    while (m_xfer_done == false);
+    p_charger->shadow_valid = true;
 }
 
-static void calc_temp(uint16_t code,
-		      struct sensor_value *valp)
+/* Value a register is left with by the table, from the last entry writing it */
+static uint8_t init_final_value(const npm1300_reg_init_t *table, size_t len, size_t idx)
 {
-    /* Ref: Datasheet Figure 42: Battery temperature (Kelvin) */
-    float log_result = log((1024.f / (float)code) - 1);
-    float inv_temp_k = (1.f / 298.15f) - (log_result / (float)config.thermistor_beta);
+    uint8_t value = table[idx].value;
 
-    float temp = (1.f / inv_temp_k) - 273.15f;
+    for (size_t i = idx + 1U; i < len; i++) {
+        if ((table[i].base == table[idx].base) && (table[i].offset == table[idx].offset)) {
+            value = table[i].value;
+        }
+    }
 
-    valp->val1 = (int32_t)temp;
-    valp->val2 = (int32_t)(fmodf(temp, 1.f) * 1000000.f);
+    return value;
 }
 
-static uint16_t adc_get_res(uint8_t msb, uint8_t lsb, uint16_t lsb_shift)
+/* Without tasks, a register set in several steps is only written again when the value it
+ * is left with differs, so a configured PMIC sees no writes at all.
+ */
+static bool init_entry_needed(npm1300_charger_t *p_charger, const npm1300_reg_init_t *table,
+                              size_t len, size_t idx, bool tasks)
 {
-    return ((uint16_t)msb << ADC_MSB_SHIFT) | ((lsb >> lsb_shift) & ADC_LSB_MASK);
+    const npm1300_reg_init_t *entry = &table[idx];
+    uint8_t value;
+
+    if ((entry->flags & NPM1300_REG_INIT_TASK) != 0U) {
+        return tasks;
+    }
+
+    value = reg_read_cached(p_charger, entry->base, entry->offset);
+    if (!tasks && (value == init_final_value(table, len, idx))) {
+        return false;
+    }
+
+    return value != entry->value;
 }
 
-static void calc_current(struct npm1300_charger_data *const data, struct sensor_value *valp)
-{
-      int32_t full_scale_ma;
-      int32_t current;
-
-      switch (data->ibat_stat) {
-      case IBAT_STAT_DISCHARGE:
-              full_scale_ma = config.dischg_limit_microamp / 1000;
-              break;
-      case IBAT_STAT_CHARGE_TRICKLE:
-              full_scale_ma = -config.current_microamp / 10000;
-              break;
-      case IBAT_STAT_CHARGE_COOL:
-              full_scale_ma = -config.current_microamp / 2000;
-              break;
-      case IBAT_STAT_CHARGE_NORMAL:
-              full_scale_ma = -config.current_microamp / 1000;
-              break;
-      default:
-              full_scale_ma = 0;
-              break;
-      }
-
-      current = (data->current * full_scale_ma) / 1024;
-
-      valp->val1 = current / 1000;
-      valp->val2 = (current % 1000) * 1000;
-}
-
-int npm1300_charger_channel_get(enum sensor_channel chan,struct sensor_value *valp)
-{       
-      int32_t tmp;
-
-      switch ((uint32_t)chan) {
-      case SENSOR_CHAN_GAUGE_VOLTAGE:
-              tmp = npm1300_data.voltage * 5000 / 1024;
-              valp->val1 = tmp / 1000;
-              valp->val2 = (tmp % 1000) * 1000;
-              break;
-      case SENSOR_CHAN_GAUGE_TEMP:
-              calc_temp(npm1300_data.temp, valp);
-              break;
-      case SENSOR_CHAN_GAUGE_AVG_CURRENT:
-              calc_current(&npm1300_data, valp);
-              break;
-      case SENSOR_CHAN_NPM1300_CHARGER_STATUS:
-              valp->val1 = npm1300_data.status;
-              valp->val2 = 0;
-              break;
-      case SENSOR_CHAN_NPM1300_CHARGER_ERROR:
-              valp->val1 = npm1300_data.error;
-              valp->val2 = 0;
-              break;
-      case SENSOR_CHAN_GAUGE_DESIRED_CHARGING_CURRENT:
-              valp->val1 = config.current_microamp / 1000000;
-              valp->val2 = config.current_microamp % 1000000;
-              break;
-      case SENSOR_CHAN_GAUGE_MAX_LOAD_CURRENT:
-              valp->val1 = config.dischg_limit_microamp / 1000000;
-              valp->val2 = config.dischg_limit_microamp % 1000000;
-              break;
-      default:
-              return NRF_ERROR_NOT_SUPPORTED; 
-      }
-
-      return 0;
-}
-
-void npm1300_charger_sample_fetch(void)
+static void init_table_apply(npm1300_charger_t *p_charger, const npm1300_reg_init_t *table,
+                             size_t len, bool tasks)
 {
-    bool last_vbus;
+    size_t i = 0U;
 
-    /* Read charge status and error reason */
-    reg_read(CHGR_BASE, CHGR_OFFSET_CHG_STAT, &npm1300_data.status);    
-    reg_read(CHGR_BASE, CHGR_OFFSET_ERR_REASON, &npm1300_data.error);
-    
-    /* Read adc results */
-    reg_read_burst(ADC_BASE, ADC_OFFSET_RESULTS, &adc_results, sizeof(adc_results));
-    
-    npm1300_data.voltage = adc_get_res(adc_results.msb_vbat, adc_results.lsb_a, ADC_LSB_VBAT_SHIFT);
-    npm1300_data.temp = adc_get_res(adc_results.msb_ntc, adc_results.lsb_a, ADC_LSB_NTC_SHIFT);
-    npm1300_data.current = adc_get_res(adc_results.msb_ibat, adc_results.lsb_b, ADC_LSB_IBAT_SHIFT);
-    npm1300_data.ibat_stat = adc_results.ibat_stat;
+    while (i < len) {
+        const npm1300_reg_init_t *first = &table[i];
+        uint8_t data[INIT_BURST_MAX];
+        size_t count = 0U;
 
-    /* Trigger temperature measurement */
-    reg_write(ADC_BASE, ADC_OFFSET_TASK_TEMP, 1U);
-    
-    /* Trigger current and voltage measurement */
-    reg_write(ADC_BASE, ADC_OFFSET_TASK_VBAT, 1U);
-    
-
-    /* Read vbus status, and set SW current limit on new vbus detection */
-    last_vbus = (npm1300_data.vbus_stat & 1U) != 0U;
-    reg_read(VBUS_BASE, VBUS_OFFSET_STATUS, &npm1300_data.vbus_stat);
-    
-
-    if (!last_vbus && ((npm1300_data.vbus_stat & 1U) != 0U)) {
-            reg_write(VBUS_BASE, VBUS_OFFSET_TASK_UPDATE, 1U);		
-    }   
-}
-
-void npm1300_charger_init(void)
-{
-    static uint8_t results = 0;
-    static uint8_t res_buf[11] = {0};
-
-    reg_read_burst(0x08, 0x0c, &results, sizeof(results));  
-    reg_write(0x08, 0x05, 0x00);
-    reg_write(0x04, 0x0A, 0x17);
-    reg_read_burst(0x04, 0x0f, &results, sizeof(results));
-    reg_write(0x04, 0x0F, 0x02);
-    reg_read_burst(0x04, 0x0F, &results, sizeof(results)); 
-    reg_read_burst(0x04, 0x0A, &results, sizeof(results));
-    reg_write(0x04, 0x0B, 0x0F);
-    reg_read_burst(0x04, 0x0C, &results, sizeof(results));
-    reg_write(0x04, 0x0C, 0x90);
-    reg_read_burst(0x04, 0x0D, &results, sizeof(results));
-    reg_write(0x04, 0x0D, 0x18);
-    reg_read_burst(0x04, 0x0E, &results, sizeof(results));
-    reg_write(0x04, 0x0D, 0x98);
-    reg_read_burst(0x04, 0x0F, &results, sizeof(results));  
-    reg_read_burst(0x04, 0x10, &results, sizeof(results));
-    reg_write(0x05, 0x0A, 0x01);  
-    reg_write(0x03, 0x0C, 0x07);
-    reg_write(0x03, 0x0d, 0x04);
-    reg_write2(0x03, 0x08, 0x25,0x00);
-    reg_write2(0x03, 0x0A, 0x9A,0x01);
-    reg_write(0x02, 0x01, 0x05);
-    reg_write(0x05, 0x24, 0x01);
-    reg_write(0x05, 0x00, 0x01);
-    reg_write(0x05, 0x01, 0x01);
-    reg_write(0x03, 0x04, 0x01);
-    reg_read_burst(0x03, 0x34, &results, sizeof(results));
-    reg_read_burst(0x03, 0x36, &results, sizeof(results));
-    reg_read_burst(0x05, 0x10, &res_buf, sizeof(res_buf));
-    reg_write(0x05, 0x01, 0x01);
-    reg_write(0x05, 0x00, 0x01);
-    reg_read_burst(0x02, 0x07, &results, sizeof(results));
-    reg_write(0x02, 0x00, 0x01);
+        if (!init_entry_needed(p_charger, table, len, i, tasks)) {
+            i++;
+            continue;
+        }
+
+        /* Merge following entries that continue the same register run */
+        do {
+            data[count++] = table[i++].value;
+        } while ((i < len) && (count < INIT_BURST_MAX) &&
+                 (table[i].base == first->base) &&
+                 (table[i].offset == (first->offset + count)) &&
+                 init_entry_needed(p_charger, table, len, i, tasks));
+
+        reg_write_burst(p_charger, first->base, first->offset, data, count);
+    }
 }
 
+static bool regs_differ(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset,
+                        uint8_t const *data, size_t len)
+{
+    for (size_t i = 0U; i < len; i++) {
+        if (reg_read_cached(p_charger, base, offset + i) != data[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Write registers that differ from the shadow. Returns true if anything was written. */
+static bool reg_write_changed(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset,
+                              uint8_t const *data, size_t len)
+{
+    if (!regs_differ(p_charger, base, offset, data, len)) {
+        return false;
+    }
+
+    reg_write_burst(p_charger, base, offset, data, len);
+
+    return true;
+}
+
+static void reg_write_task(npm1300_charger_t *p_charger, uint8_t base, uint8_t offset)
+{
+    uint8_t trigger = 1U;
+
+    reg_write_burst(p_charger, base, offset, &trigger, sizeof(trigger));
+}
+
+/* Charger parameters only change while it is stopped */
+static bool chgr_config_write(npm1300_charger_t *p_charger, uint8_t offset, uint8_t const *data,
+                              size_t len, bool restart)
+{
+    if (!regs_differ(p_charger, CHGR_BASE, offset, data, len)) {
+        return false;
+    }
+
+    if (restart) {
+        reg_write_task(p_charger, CHGR_BASE, CHGR_OFFSET_EN_CLR);
+    }
+
+    reg_write_burst(p_charger, CHGR_BASE, offset, data, len);
+
+    if (restart) {
+        reg_write_task(p_charger, CHGR_BASE, CHGR_OFFSET_EN_SET);
+    }
+
+    return true;
+}
+
+/* Highest index of the range whose value does not exceed the given one */
+static ret_code_t range_index_round_down(const struct linear_range *r, int32_t value,
+                                         uint16_t *idx)
+{
+    if ((value < r->min) || (value > linear_range_get_max_value(r))) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *idx = r->min_idx + (uint16_t)((uint32_t)(value - r->min) / r->step);
+
+    return NRF_SUCCESS;
+}
+
+static ret_code_t charge_current_encode(int32_t microamp, uint8_t *data)
+{
+    uint16_t idx;
+
+    if (range_index_round_down(&charger_current_range, microamp, &idx) != NRF_SUCCESS) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    data[0] = idx / 2U;
+    data[1] = idx & 1U;
+
+    return NRF_SUCCESS;
+}
+
+/* 10 % or 20 % of the charge current */
+static ret_code_t term_current_encode(uint8_t percent, uint8_t *data)
+{
+    switch (percent) {
+    case 10U:
+        *data = 0U;
+        return NRF_SUCCESS;
+    case 20U:
+        *data = 1U;
+        return NRF_SUCCESS;
+    default:
+        return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+static ret_code_t dischg_limit_encode(int32_t microamp, uint8_t *data)
+{
+    uint16_t idx;
+
+    if (range_index_round_down(&discharge_limit_range, microamp, &idx) != NRF_SUCCESS) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    data[0] = idx / 2U;
+    data[1] = idx & 1U;
+
+    return NRF_SUCCESS;
+}
+
+/* VTERM and VTERM_R are adjacent */
+static ret_code_t term_voltage_encode(int32_t microvolt, int32_t warm_microvolt, uint8_t *data)
+{
+    uint16_t idx;
+    uint16_t idx_warm;
+
+    if ((linear_range_group_get_win_index(charger_volt_ranges, ARRAY_SIZE(charger_volt_ranges),
+                                          microvolt, microvolt, &idx) != 0) ||
+        (linear_range_group_get_win_index(charger_volt_ranges, ARRAY_SIZE(charger_volt_ranges),
+                                          warm_microvolt, warm_microvolt, &idx_warm) != 0)) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    data[0] = (uint8_t)idx;
+    data[1] = (uint8_t)idx_warm;
+
+    return NRF_SUCCESS;
+}
+
+static ret_code_t vbus_limit_encode(int32_t microamp, uint8_t *data)
+{
+    uint16_t idx;
+
+    if (linear_range_group_get_win_index(vbus_current_ranges, ARRAY_SIZE(vbus_current_ranges),
+                                         microamp, microamp, &idx) != 0) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *data = (uint8_t)idx;
+
+    return NRF_SUCCESS;
+}
+
+/* Decoding of later samples depends on the charge current and discharge limit */
+static void snapshot_invalidate(npm1300_charger_t *p_charger)
+{
+    p_charger->snapshot_decoded &= (uint8_t)~SNAPSHOT_CURRENT;
+}
+
+ret_code_t npm1300_charger_current_set(npm1300_charger_t *p_charger, int32_t microamp)
+{
+    uint8_t data[2];
+    ret_code_t ret = charge_current_encode(microamp, data);
+
+    if (ret != NRF_SUCCESS) {
+        return ret;
+    }
+
+    (void)chgr_config_write(p_charger, CHGR_OFFSET_ISET, data, sizeof(data),
+                            p_charger->config.charging_enable);
+    p_charger->config.current_microamp = microamp;
+    snapshot_invalidate(p_charger);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t npm1300_charger_dischg_limit_set(npm1300_charger_t *p_charger, int32_t microamp)
+{
+    uint8_t data[2];
+    ret_code_t ret = dischg_limit_encode(microamp, data);
+
+    if (ret != NRF_SUCCESS) {
+        return ret;
+    }
+
+    (void)reg_write_changed(p_charger, CHGR_BASE, CHGR_OFFSET_ISET_DISCHG, data, sizeof(data));
+    p_charger->config.dischg_limit_microamp = microamp;
+    snapshot_invalidate(p_charger);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t npm1300_charger_term_voltage_set(npm1300_charger_t *p_charger, int32_t microvolt,
+                                            int32_t warm_microvolt)
+{
+    uint8_t data[2];
+    ret_code_t ret = term_voltage_encode(microvolt, warm_microvolt, data);
+
+    if (ret != NRF_SUCCESS) {
+        return ret;
+    }
+
+    (void)chgr_config_write(p_charger, CHGR_OFFSET_VTERM, data, sizeof(data),
+                            p_charger->config.charging_enable);
+    p_charger->config.term_microvolt = microvolt;
+    p_charger->config.term_warm_microvolt = warm_microvolt;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t npm1300_charger_vbus_limit_set(npm1300_charger_t *p_charger, int32_t microamp)
+{
+    uint8_t data;
+    ret_code_t ret = vbus_limit_encode(microamp, &data);
+
+    if (ret != NRF_SUCCESS) {
+        return ret;
+    }
+
+    if (reg_write_changed(p_charger, VBUS_BASE, VBUS_OFFSET_ILIM, &data, sizeof(data))) {
+        /* The new limit is used from the next update task */
+        reg_write_task(p_charger, VBUS_BASE, VBUS_OFFSET_TASK_UPDATE);
+    }
+    p_charger->config.vbus_limit_microamp = microamp;
+
+    return NRF_SUCCESS;
+}
+
+#if NPM1300_EVENTS_ENABLED
+/* Status is only read again on events, so read it once after they are enabled. */
+static void events_setup(npm1300_charger_t *p_charger)
+{
+    npm1300_charger_config_t const *config = &p_charger->config;
+    const npm1300_events_config_t events_config = {
+        .p_queue   = config->p_queue,
+        .address   = config->address,
+        .int_pin   = config->int_pin,
+        .pmic_gpio = config->int_pmic_gpio,
+    };
+    uint8_t extra_xfers;
+
+    APP_ERROR_CHECK(npm1300_events_init(&p_charger->events, &events_config));
+    APP_ERROR_CHECK(npm1300_events_subscribe(&p_charger->events,
+                                             NPM1300_EVENT_MASK_CHARGER |
+                                             NPM1300_EVENT_MASK_BATTERY |
+                                             NPM1300_EVENT_MASK_VBUS,
+                                             status_event_handler, p_charger));
+    APP_ERROR_CHECK(twi_queue_perform(config->p_queue, p_charger->fetch_xfers, FETCH_STATUS_XFERS));
+    APP_ERROR_CHECK(status_decode(p_charger, &extra_xfers));
+}
+#endif
+
+/* Charger registers from the configuration: ISET to VTERM_R, the termination current and
+ * the VBUS current limit
+ */
+static void config_encode(npm1300_charger_config_t const *config, uint8_t *chgr, uint8_t *iterm,
+                          uint8_t *ilim)
+{
+    APP_ERROR_CHECK(charge_current_encode(config->current_microamp,
+                                          &chgr[CHGR_OFFSET_ISET - CHGR_OFFSET_ISET]));
+    APP_ERROR_CHECK(dischg_limit_encode(config->dischg_limit_microamp,
+                                        &chgr[CHGR_OFFSET_ISET_DISCHG - CHGR_OFFSET_ISET]));
+    APP_ERROR_CHECK(term_voltage_encode(config->term_microvolt, config->term_warm_microvolt,
+                                        &chgr[CHGR_OFFSET_VTERM - CHGR_OFFSET_ISET]));
+    APP_ERROR_CHECK(term_current_encode(config->term_current_percent, iterm));
+    APP_ERROR_CHECK(vbus_limit_encode(config->vbus_limit_microamp, ilim));
+}
+
+void npm1300_charger_init(npm1300_charger_t *p_charger, npm1300_charger_config_t const *p_config)
+{
+    uint8_t chgr[CHGR_RETAINED_LEN];
+    uint8_t iterm;
+    uint8_t ilim;
+
+    memset(p_charger, 0, sizeof(*p_charger));
+    p_charger->config = *p_config;
+    p_charger->trigger_ms = uptime_get();
+    fetch_xfers_init(p_charger);
+
+    shadow_load(p_charger);
+
+    /* Charger registers from the configuration, in one burst. The init table then starts
+     * the charger and applies the VBUS current limit.
+     */
+    config_encode(&p_charger->config, chgr, &iterm, &ilim);
+    (void)reg_write_changed(p_charger, CHGR_BASE, CHGR_OFFSET_ISET, chgr, sizeof(chgr));
+    (void)reg_write_changed(p_charger, CHGR_BASE, CHGR_OFFSET_ITERM_SEL, &iterm, sizeof(iterm));
+    (void)reg_write_changed(p_charger, VBUS_BASE, VBUS_OFFSET_ILIM, &ilim, sizeof(ilim));
+
+    init_table_apply(p_charger, npm1300_charger_init_table, npm1300_charger_init_table_len, true);
+
+#if NPM1300_EVENTS_ENABLED
+    events_setup(p_charger);
+#endif
+}
+
+void npm1300_charger_retained_get(npm1300_charger_t const *p_charger,
+                                  npm1300_charger_retained_t *p_retained)
+{
+    memcpy(p_retained->shadow, p_charger->shadow, sizeof(p_retained->shadow));
+}
+
+ret_code_t npm1300_charger_init_warm(npm1300_charger_t *p_charger,
+                                     npm1300_charger_config_t const *p_config,
+                                     npm1300_charger_retained_t const *p_retained)
+{
+    uint8_t chgr[CHGR_RETAINED_LEN];
+    uint8_t buck[BUCK_RETAINED_LEN];
+    uint8_t iterm;
+    uint8_t ilim;
+
+    memset(p_charger, 0, sizeof(*p_charger));
+    p_charger->config = *p_config;
+    p_charger->trigger_ms = uptime_get();
+    fetch_xfers_init(p_charger);
+
+    memcpy(p_charger->shadow, p_retained->shadow, sizeof(p_charger->shadow));
+
+    /* A PMIC reset restores the defaults of the charger and buck settings, which the init
+     * sequence changes. Two bursts check them against the retained shadow.
+     */
+    reg_read_burst(p_charger, CHGR_BASE, CHGR_OFFSET_ISET, chgr, sizeof(chgr));
+    reg_read_burst(p_charger, BUCK_BASE, BUCK_OFFSET_BUCK2_NORM_VOUT, buck, sizeof(buck));
+
+    if ((memcmp(chgr, shadow_reg(p_charger, CHGR_BASE, CHGR_OFFSET_ISET), sizeof(chgr)) != 0) ||
+        (memcmp(buck, shadow_reg(p_charger, BUCK_BASE, BUCK_OFFSET_BUCK2_NORM_VOUT), sizeof(buck)) != 0)) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_charger->shadow_valid = true;
+
+    /* Only a configuration changed by a firmware update is written. The charger keeps
+     * running, it is restarted around changed charger registers like with the setters.
+     */
+    config_encode(&p_charger->config, chgr, &iterm, &ilim);
+    (void)chgr_config_write(p_charger, CHGR_OFFSET_ISET, chgr, sizeof(chgr),
+                            p_charger->config.charging_enable);
+    (void)chgr_config_write(p_charger, CHGR_OFFSET_ITERM_SEL, &iterm, sizeof(iterm),
+                            p_charger->config.charging_enable);
+    if (reg_write_changed(p_charger, VBUS_BASE, VBUS_OFFSET_ILIM, &ilim, sizeof(ilim))) {
+        reg_write_task(p_charger, VBUS_BASE, VBUS_OFFSET_TASK_UPDATE);
+    }
+
+    init_table_apply(p_charger, npm1300_charger_init_table, npm1300_charger_init_table_len, false);
+
+#if NPM1300_EVENTS_ENABLED
+    events_setup(p_charger);
+#endif
+
+    return NRF_SUCCESS;
+}
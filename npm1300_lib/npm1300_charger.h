@@ -3,12 +3,433 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#ifndef ZEPHYR_INCLUDE_DRIVERS_SENSOR_NPM1300_CHARGER_H_
-#define ZEPHYR_INCLUDE_DRIVERS_SENSOR_NPM1300_CHARGER_H_
+#ifndef NPM1300_CHARGER_H__
+#define NPM1300_CHARGER_H__
 
-void npm1300_charger_sample_fetch(void);
-int npm1300_charger_channel_get(enum sensor_channel chan,struct sensor_value *valp);
-void npm1300_charger_init(void);
-void twi_master_init(void);
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "sensor.h"
+#include "twi_queue.h"
+#if NPM1300_CHARGER_FETCH_FRESH
+#include "app_timer.h"
+#endif
+#if NPM1300_EVENTS_ENABLED
+#include "npm1300_events.h"
+#endif
+
+/** @brief Default 7-bit TWI address of the nPM1300. */
+#define NPM1300_CHARGER_ADDR 0x6BU
+
+/** @brief Init table entry is a task register, always written and never shadowed. */
+#define NPM1300_REG_INIT_TASK 0x01U
+
+/**
+ * @brief nPM1300 register initialization entry.
+ */
+typedef struct
+{
+    uint8_t base;   /**< Register base address. */
+    uint8_t offset; /**< Register offset. */
+    uint8_t value;  /**< Value to write. */
+    uint8_t flags;  /**< NPM1300_REG_INIT_* flags. */
+} npm1300_reg_init_t;
+
+/** @brief Register initialization sequence applied by @ref npm1300_charger_init. */
+extern const npm1300_reg_init_t npm1300_charger_init_table[];
+
+/** @brief Number of entries in @ref npm1300_charger_init_table. */
+extern const size_t npm1300_charger_init_table_len;
+
+/**
+ * @brief Charger configuration.
+ *
+ * @details Copied by @ref npm1300_charger_init. The currents and voltages are the initial
+ *          values, they can be changed later with the setters.
+ */
+typedef struct
+{
+    twi_queue_t * p_queue;               /**< Queue of the bus the PMIC is on. */
+    uint8_t       address;               /**< 7-bit PMIC address. */
+    int32_t       term_microvolt;        /**< Termination voltage. */
+    int32_t       term_warm_microvolt;   /**< Termination voltage in the warm region. */
+    int32_t       current_microamp;      /**< Charge current. */
+    int32_t       dischg_limit_microamp; /**< Battery discharge current limit. */
+    int32_t       vbus_limit_microamp;   /**< VBUS input current limit. */
+    uint8_t       term_current_percent;  /**< Termination current in percent of the charge current, 10 or 20. */
+    uint16_t      thermistor_beta;       /**< Beta of the battery NTC thermistor. */
+    bool          charging_enable;       /**< Charger is enabled, restarted around changes. */
+    uint32_t      int_pin;               /**< nRF pin of the PMIC interrupt output, with NPM1300_EVENTS_ENABLED. */
+    uint8_t       int_pmic_gpio;         /**< PMIC GPIO used as interrupt output. */
+} npm1300_charger_config_t;
+
+/**
+ * @brief Default configuration of a charger on the given TWI queue.
+ */
+#define NPM1300_CHARGER_DEFAULT_CONFIG(_p_queue)                               \
+    {                                                                          \
+        .p_queue               = (_p_queue),                                   \
+        .address               = NPM1300_CHARGER_ADDR,                         \
+        .term_microvolt        = 4150000,                                      \
+        .term_warm_microvolt   = 4000000,                                      \
+        .current_microamp      = 150000,                                       \
+        .dischg_limit_microamp = 1000000,                                      \
+        .vbus_limit_microamp   = 500000,                                       \
+        .term_current_percent  = 10,                                           \
+        .thermistor_beta       = 3380,                                         \
+        .charging_enable       = true,                                         \
+        .int_pin               = NPM1300_EVENTS_INT_PIN,                       \
+        .int_pmic_gpio         = NPM1300_EVENTS_PMIC_GPIO,                     \
+    }
+
+/**
+ * @brief Bus usage of the sample fetch.
+ */
+typedef struct
+{
+    uint32_t samples;        /**< Number of completed sample fetches. */
+    uint32_t status_updates; /**< Status reads triggered by PMIC events. */
+    uint32_t xfers;          /**< TWI transactions used by all completed fetches and status reads. */
+    uint8_t  last_xfers;     /**< TWI transactions used by the last fetch. */
+} npm1300_charger_stats_t;
+
+
+/**
+ * @brief All channels of one fetched sample.
+ *
+ * @details Fixed-point and float fields hold the same values. Die temperature, VSYS and
+ *          VBUS come with the same ADC burst as the battery channels, their conversions
+ *          are triggered on every NPM1300_CHARGER_AUX_ADC_PERIOD-th fetch.
+ */
+typedef struct
+{
+    uint32_t generation;    /**< Incremented by every completed sample fetch and status read. */
+    int64_t  time_ms;       /**< Uptime at which the battery channels were converted. */
+    int32_t  voltage_uv;    /**< Battery voltage. */
+    int32_t  current_ua;    /**< Battery current, positive when discharging. */
+    int32_t  temp_mdeg;     /**< Battery temperature in millidegrees Celsius. */
+    int32_t  die_temp_mdeg; /**< Die temperature in millidegrees Celsius. */
+    int32_t  vsys_uv;       /**< VSYS voltage. */
+    int32_t  vbus_uv;       /**< VBUS voltage. */
+    float    voltage;       /**< Battery voltage in volts. */
+    float    current;       /**< Battery current in amperes, positive when discharging. */
+    float    temp;          /**< Battery temperature in degrees Celsius. */
+    float    die_temp;      /**< Die temperature in degrees Celsius. */
+    float    vsys;          /**< VSYS voltage in volts. */
+    float    vbus;          /**< VBUS voltage in volts. */
+    uint8_t  status;        /**< CHG_STAT register. */
+    uint8_t  error;         /**< ERR_REASON register. */
+    uint8_t  vbus_stat;     /**< VBUS status register. */
+    uint8_t  ibat_stat;     /**< IBAT measurement status. */
+} npm1300_charger_snapshot_t;
+
+/* Raw decoder inputs of one sample */
+struct npm1300_charger_data {
+	uint16_t voltage;
+	uint16_t current;
+	uint16_t temp;
+	uint8_t status;
+	uint8_t error;
+	uint8_t ibat_stat;
+	uint8_t vbus_stat;
+	uint16_t die_temp;
+	uint16_t vsys;
+	uint16_t vbus;
+	int64_t time_ms;
+};
+
+/** @brief Length of the ADC result burst. */
+#define NPM1300_CHARGER_ADC_RESULTS_LEN 11U
+
+/** @brief ADC task registers read back ahead of the results in a sample list entry. */
+#define NPM1300_CHARGER_LIST_SKIP_LEN 14U
+
+/** @brief Length of a sample list entry, see @ref npm1300_charger_list_xfer_get. */
+#define NPM1300_CHARGER_LIST_ENTRY_LEN (NPM1300_CHARGER_LIST_SKIP_LEN + NPM1300_CHARGER_ADC_RESULTS_LEN)
+
+/** @brief CHG_STAT up to ERR_REASON. */
+#define NPM1300_CHARGER_STATUS_LEN 3U
+
+/** @brief Transfers of the longest sample fetch. */
+#define NPM1300_CHARGER_FETCH_XFERS_MAX 8U
+
+/** @brief Writable configuration registers mirrored in RAM. */
+#define NPM1300_CHARGER_SHADOW_SIZE 18U
+
+/** @brief Values of the IBAT measurement status, ibat_stat in the snapshot. */
+#define NPM1300_CHARGER_IBAT_STAT_DISCHARGE      0x04U
+#define NPM1300_CHARGER_IBAT_STAT_CHARGE_TRICKLE 0x0CU
+#define NPM1300_CHARGER_IBAT_STAT_CHARGE_COOL    0x0DU
+#define NPM1300_CHARGER_IBAT_STAT_CHARGE_NORMAL  0x0FU
+
+typedef struct npm1300_charger_s npm1300_charger_t;
+
+/**
+ * @brief PMIC state to keep across an nRF reset, for @ref npm1300_charger_init_warm.
+ */
+typedef struct
+{
+    uint8_t shadow[NPM1300_CHARGER_SHADOW_SIZE]; /**< Configuration registers as last written. */
+} npm1300_charger_retained_t;
+
+/**
+ * @brief Sample fetch completion handler.
+ *
+ * @details Called from the TWI interrupt context once the new sample has been decoded.
+ *
+ * @param[in] p_charger Instance the sample was fetched from.
+ * @param[in] result    NRF_SUCCESS or the TWI error that aborted the fetch.
+ */
+typedef void (*npm1300_charger_fetch_handler_t)(npm1300_charger_t * p_charger, ret_code_t result);
+
+/**
+ * @brief Charger instance, one per PMIC. Use @ref NPM1300_CHARGER_DEF to create one.
+ *
+ * @details Fields are private to the driver. The raw buffers and transfers are used by
+ *          queued transactions, so the instance must stay in RAM for EasyDMA. Instances on
+ *          the same bus share its queue, their fetches are interleaved transaction by
+ *          transaction.
+ */
+struct npm1300_charger_s
+{
+    npm1300_charger_config_t        config;
+    struct npm1300_charger_data     data;
+    uint8_t                         adc_raw[NPM1300_CHARGER_ADC_RESULTS_LEN];
+    uint8_t                         status_raw[NPM1300_CHARGER_STATUS_LEN];
+    uint8_t                         vbus_stat_raw;
+    twi_queue_xfer_t                fetch_xfers[NPM1300_CHARGER_FETCH_XFERS_MAX];
+    twi_queue_xfer_t                vbus_update_xfer;
+    twi_queue_transaction_t         fetch_transaction;
+    twi_queue_transaction_t         fetch_aux_transaction;
+    twi_queue_transaction_t         status_transaction;
+    twi_queue_transaction_t         vbus_update_transaction;
+    twi_queue_transaction_t const * p_fetch_current;
+    npm1300_charger_fetch_handler_t fetch_handler;
+    volatile bool                   fetch_busy;
+    volatile bool                   fetch_sync_done;
+    ret_code_t                      fetch_sync_result;
+    volatile bool                   status_busy;
+    volatile bool                   status_pending;
+    uint32_t                        aux_countdown;
+    int64_t                         trigger_ms;
+#if NPM1300_CHARGER_FETCH_FRESH
+    twi_queue_transaction_t         results_transaction;
+    app_timer_t                     conversion_timer_data;
+    app_timer_id_t                  conversion_timer;
+#endif
+    volatile uint32_t               generation;
+    npm1300_charger_snapshot_t      snapshot;
+    uint8_t                         snapshot_decoded;
+    npm1300_charger_stats_t         stats;
+    uint8_t                         shadow[NPM1300_CHARGER_SHADOW_SIZE];
+    bool                            shadow_valid;
+#if NPM1300_EVENTS_ENABLED
+    npm1300_events_t                events;
+#endif
+};
 
+/**
+ * @brief Macro for defining a charger instance.
+ *
+ * @param _name Name of the instance.
+ */
+#define NPM1300_CHARGER_DEF(_name) static npm1300_charger_t _name
+
+/**
+ * @brief Start a sample fetch without waiting for the bus.
+ *
+ * @details All register transfers of the sample are queued as one transaction, so the
+ *          CPU can sleep until @p handler is called. With NPM1300_EVENTS_ENABLED the fetch
+ *          only reads the ADC, charger and VBUS status are read when the PMIC reports
+ *          a change on its interrupt line. Fetches of several instances can be started
+ *          back to back and run concurrently, also on different buses.
+ *
+ *          By default the fetch reads the results of the conversions triggered by the
+ *          previous one, and triggers the next. With NPM1300_CHARGER_FETCH_FRESH the
+ *          conversions are triggered first, and the results are read in a second
+ *          transaction once they are complete: an app_timer waits
+ *          NPM1300_CHARGER_CONVERSION_US per conversion in between.
+ *
+ * @retval NRF_SUCCESS      Fetch started.
+ * @retval NRF_ERROR_BUSY   A fetch of this instance is already in progress.
+ * @retval NRF_ERROR_NO_MEM TWI queue is full.
+ */
+ret_code_t npm1300_charger_sample_fetch_async(npm1300_charger_t             * p_charger,
+                                              npm1300_charger_fetch_handler_t handler);
+
+/**
+ * @brief Get the transfer of a sample taken without the CPU, e.g. started through PPI.
+ *
+ * @details One write-then-read transfer: the write triggers the VBAT and NTC conversions,
+ *          the read continues at the register after the last one written and runs through
+ *          the ADC results, NPM1300_CHARGER_LIST_ENTRY_LEN bytes in total. As with the
+ *          pipelined sample fetch, the results are the ones of the conversions triggered
+ *          by the previous transfer. The receive buffer is left NULL for the caller to fill in.
+ *
+ * @param[in]  p_charger Instance.
+ * @param[out] p_xfer    Transfer.
+ */
+void npm1300_charger_list_xfer_get(npm1300_charger_t const * p_charger, twi_queue_xfer_t * p_xfer);
+
+/**
+ * @brief Take a sample read by the transfer of @ref npm1300_charger_list_xfer_get.
+ *
+ * @details The entry becomes the last fetched sample and counts as a completed fetch. Charger
+ *          and VBUS status are not part of it, they keep the values of the last status read.
+ *          Must be called from thread mode.
+ *
+ * @param[in] p_charger Instance.
+ * @param[in] p_entry   NPM1300_CHARGER_LIST_ENTRY_LEN bytes read by the transfer.
+ * @param[in] time_ms   Uptime at which the entry was converted, as known to the caller.
+ */
+void npm1300_charger_list_entry_load(npm1300_charger_t * p_charger, uint8_t const * p_entry,
+                                     int64_t time_ms);
+
+/**
+ * @brief Get the TWI transaction counters of the sample fetch.
+ */
+void npm1300_charger_stats_get(npm1300_charger_t const * p_charger, npm1300_charger_stats_t * p_stats);
+
+/**
+ * @brief Get all channels of the last fetched sample.
+ *
+ * @details The raw ADC codes are converted once per sample, further calls for the same
+ *          sample only copy the result. Must be called from thread mode.
+ */
+void npm1300_charger_snapshot_get(npm1300_charger_t * p_charger, npm1300_charger_snapshot_t * p_snapshot);
+
+/**
+ * @brief Get the generation of the last fetched sample.
+ *
+ * @details Same counter as the generation field of the snapshot. A reader that kept the
+ *          value of its last read has nothing new to process while it is unchanged. Can be
+ *          called from any context.
+ */
+static inline uint32_t npm1300_charger_generation_get(npm1300_charger_t const * p_charger)
+{
+    return p_charger->generation;
+}
+
+/**
+ * @brief Fetch a sample and sleep until it has been decoded.
+ */
+void npm1300_charger_sample_fetch(npm1300_charger_t * p_charger);
+
+/**
+ * @brief Get one channel of the last fetched sample.
+ *
+ * @details Shares the cache of @ref npm1300_charger_snapshot_get, but converts only the
+ *          requested channel, once per sample. Repeated reads between two fetches cost
+ *          a generation compare. Must be called from thread mode.
+ */
+int npm1300_charger_channel_get(npm1300_charger_t * p_charger, enum sensor_channel chan,
+                                struct sensor_value *valp);
+
+/**
+ * @brief Set the charge current.
+ *
+ * @details The current is set in 2 mA steps, a value between two steps is rounded down to
+ *          the lower one. Registers are only written when the encoded value differs from the
+ *          one in the register shadow, the charger is stopped and restarted around the change.
+ *          Must be called from thread mode after @ref npm1300_charger_init.
+ *
+ * @retval NRF_SUCCESS             Current set or already set.
+ * @retval NRF_ERROR_INVALID_PARAM Current out of the 32 mA to 800 mA range.
+ */
+ret_code_t npm1300_charger_current_set(npm1300_charger_t * p_charger, int32_t microamp);
+
+/**
+ * @brief Set the battery discharge current limit.
+ *
+ * @details The limit is set in 3.23 mA steps and rounded down like
+ *          @ref npm1300_charger_current_set.
+ *
+ * @retval NRF_SUCCESS             Limit set or already set.
+ * @retval NRF_ERROR_INVALID_PARAM Limit out of the 268.09 mA to 1340.45 mA range.
+ */
+ret_code_t npm1300_charger_dischg_limit_set(npm1300_charger_t * p_charger, int32_t microamp);
+
+/**
+ * @brief Set the normal and warm termination voltages.
+ *
+ * @details Both values must be exact steps of the termination voltage ranges, see
+ *          @ref npm1300_charger_current_set.
+ *
+ * @retval NRF_SUCCESS             Voltages set or already set.
+ * @retval NRF_ERROR_INVALID_PARAM Voltage not supported by the charger.
+ */
+ret_code_t npm1300_charger_term_voltage_set(npm1300_charger_t * p_charger,
+                                            int32_t             microvolt,
+                                            int32_t             warm_microvolt);
+
+/**
+ * @brief Set the VBUS input current limit.
+ *
+ * @details The limit must be 100 mA or a 100 mA step from 500 mA to 1500 mA. A changed
+ *          limit is applied right away with the VBUS update task.
+ *
+ * @retval NRF_SUCCESS             Limit set or already set.
+ * @retval NRF_ERROR_INVALID_PARAM Limit not supported.
+ */
+ret_code_t npm1300_charger_vbus_limit_set(npm1300_charger_t * p_charger, int32_t microamp);
+
+/**
+ * @brief Configure the PMIC from @ref npm1300_charger_init_table.
+ *
+ * @details The writable configuration registers are read into a RAM shadow with a
+ *          few burst reads first, so registers that already hold the wanted value
+ *          are not written again. The charger current, voltage and VBUS limit registers
+ *          are encoded from the charger configuration before the table is applied.
+ *          With NPM1300_EVENTS_ENABLED the event engine is set up as well, see
+ *          @ref npm1300_events. Must be called from thread mode after the TWI queue has
+ *          been initialized.
+ *
+ * @param[out] p_charger Instance.
+ * @param[in]  p_config  Bus, address and initial charger settings.
+ */
+void npm1300_charger_init(npm1300_charger_t * p_charger, npm1300_charger_config_t const * p_config);
+
+/**
+ * @brief Get the state to retain for a warm restart.
+ *
+ * @details Take it again after the setters, the register shadow follows every write.
+ */
+void npm1300_charger_retained_get(npm1300_charger_t const * p_charger,
+                                  npm1300_charger_retained_t * p_retained);
+
+/**
+ * @brief Take over a PMIC that was configured before an nRF reset.
+ *
+ * @details The PMIC keeps its configuration across soft, pin and watchdog resets of the nRF.
+ *          The register shadow is taken from @p p_retained and checked against the charger
+ *          and buck registers with two burst reads, instead of reading all configuration
+ *          registers. Registers that differ from the charger configuration or from
+ *          @ref npm1300_charger_init_table are still written, e.g. after a firmware update,
+ *          but no task is triggered: the charger keeps running and the first fetch reads the
+ *          conversions triggered before the reset. The event engine is set up as in
+ *          @ref npm1300_charger_init.
+ *
+ * @param[out] p_charger  Instance.
+ * @param[in]  p_config   Bus, address and charger settings.
+ * @param[in]  p_retained State taken with @ref npm1300_charger_retained_get before the reset.
+ *
+ * @retval NRF_SUCCESS             PMIC taken over.
+ * @retval NRF_ERROR_INVALID_STATE PMIC registers do not match, it has been reset or
+ *                                 reconfigured. Use @ref npm1300_charger_init.
+ */
+ret_code_t npm1300_charger_init_warm(npm1300_charger_t                * p_charger,
+                                     npm1300_charger_config_t const   * p_config,
+                                     npm1300_charger_retained_t const * p_retained);
+
+#if NPM1300_EVENTS_ENABLED
+/**
+ * @brief Get the event engine of the PMIC, to subscribe to further events.
+ */
+static inline npm1300_events_t * npm1300_charger_events_get(npm1300_charger_t * p_charger)
+{
+    return &p_charger->events;
+}
 #endif
+
+#endif // NPM1300_CHARGER_H__
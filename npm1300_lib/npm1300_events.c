@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "npm1300_events.h"
+#include "nrfx_gpiote.h"
+#include "app_util_platform.h"
+#include "nrf_assert.h"
+
+#define MAIN_BASE 0x00U
+#define GPIO_BASE 0x06U
+
+/* GPIO mode registers, one per PMIC GPIO */
+#define GPIO_OFFSET_MODE 0x00U
+#define GPIO_MODE_GPOIRQ 0x05U
+#define PMIC_GPIO_COUNT  5U
+
+/* Event groups in the MAIN block: SET, CLR, INTENSET and INTENCLR registers. Reading SET or
+ * CLR returns the pending events, writing a one to CLR or INTENCLR clears the bit and
+ * writing zeros has no effect, so a burst may span the registers between the groups.
+ */
+#define EVENTS_BCHARGER1       0x0AU
+#define EVENTS_BCHARGER2       0x0EU
+#define EVENTS_SHPHLD          0x12U
+#define EVENTS_VBUSIN0         0x16U
+#define EVENTS_OFFSET_CLR      0x01U
+#define EVENTS_OFFSET_INTENSET 0x02U
+#define EVENTS_OFFSET_INTENCLR 0x03U
+
+#define EVENTS_GROUP_FIRST EVENTS_BCHARGER1
+#define EVENTS_GROUP_LAST  EVENTS_VBUSIN0
+#define EVENTS_SPAN_MAX    (EVENTS_GROUP_LAST - EVENTS_GROUP_FIRST + 1U)
+
+STATIC_ASSERT(EVENTS_SPAN_MAX == NPM1300_EVENTS_SPAN_MAX);
+
+typedef struct
+{
+    uint8_t group;
+    uint8_t mask;
+} event_reg_t;
+
+static const event_reg_t m_event_regs[NPM1300_EVENT_COUNT] =
+{
+    [NPM1300_EVENT_CHG_SUPPLEMENT]   = { EVENTS_BCHARGER1, 0x01U },
+    [NPM1300_EVENT_CHG_TRICKLE]      = { EVENTS_BCHARGER1, 0x02U },
+    [NPM1300_EVENT_CHG_CC]           = { EVENTS_BCHARGER1, 0x04U },
+    [NPM1300_EVENT_CHG_CV]           = { EVENTS_BCHARGER1, 0x08U },
+    [NPM1300_EVENT_CHG_COMPLETED]    = { EVENTS_BCHARGER1, 0x10U },
+    [NPM1300_EVENT_CHG_ERROR]        = { EVENTS_BCHARGER1, 0x20U },
+    [NPM1300_EVENT_BATTERY_DETECTED] = { EVENTS_BCHARGER2, 0x01U },
+    [NPM1300_EVENT_BATTERY_REMOVED]  = { EVENTS_BCHARGER2, 0x02U },
+    [NPM1300_EVENT_SHIPHOLD_PRESS]   = { EVENTS_SHPHLD,    0x01U },
+    [NPM1300_EVENT_SHIPHOLD_RELEASE] = { EVENTS_SHPHLD,    0x02U },
+    [NPM1300_EVENT_WATCHDOG_WARN]    = { EVENTS_SHPHLD,    0x08U },
+    [NPM1300_EVENT_VBUS_DETECTED]    = { EVENTS_VBUSIN0,   0x01U },
+    [NPM1300_EVENT_VBUS_REMOVED]     = { EVENTS_VBUSIN0,   0x02U },
+};
+
+#define EVENT_MASK_ALL (NPM1300_EVENT_MASK(NPM1300_EVENT_COUNT) - 1UL)
+
+/* Instances by interrupt pin, for the GPIOTE handler. */
+static npm1300_events_t * m_instances[NPM1300_EVENTS_INSTANCES_MAX];
+static uint8_t            m_instance_count;
+
+static void read_done(ret_code_t result, void * p_context);
+static void clear_done(ret_code_t result, void * p_context);
+
+static ret_code_t reg_write(npm1300_events_t const * p_events,
+                            uint8_t                  base,
+                            uint8_t                  offset,
+                            uint8_t const          * p_data,
+                            size_t                   len)
+{
+    uint8_t buffer[2 + EVENTS_SPAN_MAX + EVENTS_OFFSET_INTENCLR];
+    twi_queue_xfer_t const xfer = TWI_QUEUE_WRITE(p_events->config.address, buffer, 2U + len);
+
+    ASSERT(len <= (sizeof(buffer) - 2U));
+
+    buffer[0] = base;
+    buffer[1] = offset;
+    memcpy(&buffer[2], p_data, len);
+
+    return twi_queue_perform(p_events->config.p_queue, &xfer, 1U);
+}
+
+/* Start a cycle by reading the SET registers of all enabled groups. The span is set up from
+ * the enabled groups here and stays fixed until the cycle has ended.
+ */
+static void read_start(npm1300_events_t * p_events)
+{
+    ret_code_t ret;
+
+    p_events->span_first = p_events->group_first;
+    p_events->span_len   = (uint8_t)(p_events->group_last - p_events->group_first + 1U);
+
+    p_events->set_reg[0] = MAIN_BASE;
+    p_events->set_reg[1] = p_events->span_first;
+
+    p_events->read_xfer = (twi_queue_xfer_t)TWI_QUEUE_READ(p_events->config.address,
+                                                           p_events->set_reg,
+                                                           sizeof(p_events->set_reg),
+                                                           p_events->set_raw,
+                                                           p_events->span_len);
+
+    p_events->stats.reads++;
+
+    ret = twi_queue_schedule(p_events->config.p_queue, &p_events->read_transaction);
+    if (ret != NRF_SUCCESS)
+    {
+        p_events->stats.errors++;
+        p_events->busy = false;
+    }
+}
+
+static void cycle_start(npm1300_events_t * p_events)
+{
+    bool start;
+
+    CRITICAL_REGION_ENTER();
+    start = !p_events->busy;
+    if (start)
+    {
+        p_events->busy = true;
+    }
+    else
+    {
+        p_events->pending = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (start)
+    {
+        read_start(p_events);
+    }
+}
+
+static void read_done(ret_code_t result, void * p_context)
+{
+    npm1300_events_t * p_events = (npm1300_events_t *)p_context;
+
+    if (result != NRF_SUCCESS)
+    {
+        p_events->stats.errors++;
+        p_events->busy = false;
+        return;
+    }
+
+    /* Clear exactly the enabled events that were seen, so that an event raised after the
+     * read stays pending and keeps the line high.
+     */
+    memset(p_events->clr_data, 0, sizeof(p_events->clr_data));
+    p_events->clr_data[0] = MAIN_BASE;
+    p_events->clr_data[1] = p_events->span_first + EVENTS_OFFSET_CLR;
+    p_events->events      = 0;
+
+    for (uint32_t i = 0; i < NPM1300_EVENT_COUNT; i++)
+    {
+        event_reg_t const * p_reg = &m_event_regs[i];
+        uint8_t             idx   = p_reg->group - p_events->span_first;
+
+        if (((p_events->enabled & NPM1300_EVENT_MASK(i)) == 0) ||
+            (p_reg->group < p_events->span_first) || (idx >= p_events->span_len))
+        {
+            continue;
+        }
+
+        if ((p_events->set_raw[idx] & p_reg->mask) != 0)
+        {
+            p_events->events            |= NPM1300_EVENT_MASK(i);
+            p_events->clr_data[2 + idx] |= p_reg->mask;
+        }
+    }
+
+    p_events->clear_xfer = (twi_queue_xfer_t)TWI_QUEUE_WRITE(p_events->config.address,
+                                                             p_events->clr_data,
+                                                             2U + p_events->span_len);
+
+    if (twi_queue_schedule(p_events->config.p_queue, &p_events->clear_transaction) != NRF_SUCCESS)
+    {
+        p_events->stats.errors++;
+        p_events->busy = false;
+    }
+}
+
+static void clear_done(ret_code_t result, void * p_context)
+{
+    npm1300_events_t * p_events = (npm1300_events_t *)p_context;
+    uint32_t           events   = p_events->events;
+    bool               restart;
+
+    if (result != NRF_SUCCESS)
+    {
+        p_events->stats.errors++;
+        p_events->busy = false;
+        return;
+    }
+
+    for (uint8_t i = 0; i < p_events->subscriber_count; i++)
+    {
+        npm1300_events_subscriber_t const * p_sub = &p_events->subscribers[i];
+        uint32_t                            mine  = events & p_sub->events;
+
+        if (mine != 0)
+        {
+            p_sub->handler(mine, p_sub->p_context);
+        }
+    }
+
+    p_events->stats.events += (uint32_t)__builtin_popcount(events);
+
+    /* The line only has an edge when it goes low in between, so check the level for events
+     * that arrived during the cycle.
+     */
+    CRITICAL_REGION_ENTER();
+    restart           = p_events->pending || nrfx_gpiote_in_is_set(p_events->config.int_pin);
+    p_events->pending = false;
+    p_events->busy    = restart;
+    CRITICAL_REGION_EXIT();
+
+    if (restart)
+    {
+        read_start(p_events);
+    }
+}
+
+static void int_pin_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    UNUSED_PARAMETER(action);
+
+    for (uint8_t i = 0; i < m_instance_count; i++)
+    {
+        if (m_instances[i]->config.int_pin == pin)
+        {
+            m_instances[i]->stats.interrupts++;
+            cycle_start(m_instances[i]);
+        }
+    }
+}
+
+ret_code_t npm1300_events_init(npm1300_events_t * p_events, npm1300_events_config_t const * p_config)
+{
+    uint8_t    clr[EVENTS_SPAN_MAX + EVENTS_OFFSET_INTENCLR];
+    uint8_t    mode = GPIO_MODE_GPOIRQ;
+    ret_code_t ret;
+
+    if (p_config->pmic_gpio >= PMIC_GPIO_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (m_instance_count == NPM1300_EVENTS_INSTANCES_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memset(p_events, 0, sizeof(*p_events));
+    p_events->config = *p_config;
+
+    /* The read and clear cycle goes ahead of sampling and bulk transfers on the bus, it only
+     * waits for the transaction in progress.
+     */
+    p_events->read_transaction.callback   = read_done;
+    p_events->read_transaction.p_context  = p_events;
+    p_events->read_transaction.p_xfers    = &p_events->read_xfer;
+    p_events->read_transaction.count      = 1U;
+    p_events->read_transaction.priority   = TWI_QUEUE_PRIORITY_HIGH;
+    p_events->clear_transaction.callback  = clear_done;
+    p_events->clear_transaction.p_context = p_events;
+    p_events->clear_transaction.p_xfers   = &p_events->clear_xfer;
+    p_events->clear_transaction.count     = 1U;
+    p_events->clear_transaction.priority  = TWI_QUEUE_PRIORITY_HIGH;
+
+    /* Disable and clear all events of the known groups with one burst: CLR and INTENCLR of
+     * every group, zeros in between.
+     */
+    memset(clr, 0, sizeof(clr));
+    for (uint8_t group = EVENTS_GROUP_FIRST; group <= EVENTS_GROUP_LAST; group += 4U)
+    {
+        clr[group - EVENTS_GROUP_FIRST] = 0xFFU;
+        clr[group - EVENTS_GROUP_FIRST + EVENTS_OFFSET_INTENCLR - EVENTS_OFFSET_CLR] = 0xFFU;
+    }
+
+    ret = reg_write(p_events, MAIN_BASE, EVENTS_GROUP_FIRST + EVENTS_OFFSET_CLR, clr,
+                    EVENTS_SPAN_MAX + EVENTS_OFFSET_INTENCLR - EVENTS_OFFSET_CLR);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret = reg_write(p_events, GPIO_BASE, GPIO_OFFSET_MODE + p_config->pmic_gpio, &mode, 1U);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (!nrfx_gpiote_is_init())
+    {
+        ret = nrfx_gpiote_init();
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    /* Low power PORT event without pull, the line is driven by the PMIC. */
+    nrfx_gpiote_in_config_t const config = NRFX_GPIOTE_CONFIG_IN_SENSE_LOTOHI(false);
+
+    ret = nrfx_gpiote_in_init(p_config->int_pin, &config, int_pin_handler);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    m_instances[m_instance_count++] = p_events;
+    nrfx_gpiote_in_event_enable(p_config->int_pin, true);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t npm1300_events_subscribe(npm1300_events_t      * p_events,
+                                    uint32_t                events,
+                                    npm1300_event_handler_t handler,
+                                    void                  * p_context)
+{
+    npm1300_events_subscriber_t * p_sub;
+    uint32_t                      new_events;
+    uint8_t                       inten[EVENTS_SPAN_MAX];
+    uint8_t                       first     = EVENTS_GROUP_LAST;
+    uint8_t                       last      = EVENTS_GROUP_FIRST;
+    uint8_t                       new_first = EVENTS_GROUP_LAST;
+    uint8_t                       new_last  = EVENTS_GROUP_FIRST;
+    ret_code_t                    ret;
+
+    if ((handler == NULL) || (events == 0) || ((events & ~EVENT_MASK_ALL) != 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (p_events->subscriber_count == NPM1300_EVENTS_SUBSCRIBERS_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    new_events = events & ~p_events->enabled;
+
+    memset(inten, 0, sizeof(inten));
+    for (uint32_t i = 0; i < NPM1300_EVENT_COUNT; i++)
+    {
+        event_reg_t const * p_reg = &m_event_regs[i];
+
+        if ((new_events & NPM1300_EVENT_MASK(i)) != 0)
+        {
+            inten[p_reg->group - EVENTS_GROUP_FIRST] |= p_reg->mask;
+            new_first = MIN(new_first, p_reg->group);
+            new_last  = MAX(new_last, p_reg->group);
+        }
+        if (((events | p_events->enabled) & NPM1300_EVENT_MASK(i)) != 0)
+        {
+            first = MIN(first, p_reg->group);
+            last  = MAX(last, p_reg->group);
+        }
+    }
+
+    /* INTENSET of the new events in one burst, zeros leave the others unchanged. */
+    if (new_events != 0)
+    {
+        ret = reg_write(p_events, MAIN_BASE, new_first + EVENTS_OFFSET_INTENSET,
+                        &inten[new_first - EVENTS_GROUP_FIRST], new_last - new_first + 1U);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    CRITICAL_REGION_ENTER();
+    p_sub = &p_events->subscribers[p_events->subscriber_count];
+    p_sub->events         = events;
+    p_sub->handler        = handler;
+    p_sub->p_context      = p_context;
+    p_events->subscriber_count++;
+    p_events->enabled    |= events;
+    p_events->group_first = first;
+    p_events->group_last  = last;
+    CRITICAL_REGION_EXIT();
+
+    /* Events that were already pending raise the line without an edge. */
+    if (nrfx_gpiote_in_is_set(p_events->config.int_pin))
+    {
+        cycle_start(p_events);
+    }
+
+    return NRF_SUCCESS;
+}
+
+void npm1300_events_stats_get(npm1300_events_t const * p_events, npm1300_events_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_events->stats;
+    CRITICAL_REGION_EXIT();
+}
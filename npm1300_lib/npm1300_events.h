@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup npm1300_events nPM1300 event engine
+ * @{
+ * @brief PMIC events delivered through the interrupt output instead of status polling.
+ *
+ * @details One PMIC GPIO is configured as interrupt output. It is high while an enabled
+ *          event is pending and is sensed by GPIOTE with a low power PORT event, so no
+ *          GPIOTE channel is used and nothing runs while the line is idle.
+ *
+ *          On a rising edge the event registers of all subscribed groups are read with one
+ *          burst, the pending events are cleared with one burst write, and the subscribers
+ *          are called from the TWI interrupt. If the line is still high after the clear,
+ *          because a new event arrived in between, the cycle is repeated.
+ *
+ *          Every PMIC has its own instance and interrupt pin, up to
+ *          @ref NPM1300_EVENTS_INSTANCES_MAX. Each pin uses one low power GPIOTE event, see
+ *          NRFX_GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS.
+ */
+
+#ifndef NPM1300_EVENTS_H__
+#define NPM1300_EVENTS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "twi_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of subscribers. */
+#ifndef NPM1300_EVENTS_SUBSCRIBERS_MAX
+#define NPM1300_EVENTS_SUBSCRIBERS_MAX 4
+#endif
+
+/** @brief Maximum number of instances, one per PMIC. */
+#ifndef NPM1300_EVENTS_INSTANCES_MAX
+#define NPM1300_EVENTS_INSTANCES_MAX 2
+#endif
+
+/** @brief Event registers from the first to the last known group, read in one burst. */
+#define NPM1300_EVENTS_SPAN_MAX 13U
+
+/** @brief PMIC events. */
+typedef enum
+{
+    NPM1300_EVENT_CHG_SUPPLEMENT,    /**< Charger entered supplement mode. */
+    NPM1300_EVENT_CHG_TRICKLE,       /**< Trickle charge started. */
+    NPM1300_EVENT_CHG_CC,            /**< Constant current charge started. */
+    NPM1300_EVENT_CHG_CV,            /**< Constant voltage charge started. */
+    NPM1300_EVENT_CHG_COMPLETED,     /**< Charging completed. */
+    NPM1300_EVENT_CHG_ERROR,         /**< Charger error. */
+    NPM1300_EVENT_BATTERY_DETECTED,  /**< Battery connected. */
+    NPM1300_EVENT_BATTERY_REMOVED,   /**< Battery removed. */
+    NPM1300_EVENT_SHIPHOLD_PRESS,    /**< Ship/hold button pressed. */
+    NPM1300_EVENT_SHIPHOLD_RELEASE,  /**< Ship/hold button released. */
+    NPM1300_EVENT_WATCHDOG_WARN,     /**< Watchdog about to expire. */
+    NPM1300_EVENT_VBUS_DETECTED,     /**< VBUS connected. */
+    NPM1300_EVENT_VBUS_REMOVED,      /**< VBUS removed. */
+    NPM1300_EVENT_COUNT
+} npm1300_event_t;
+
+/** @brief Mask bit of an event. */
+#define NPM1300_EVENT_MASK(_event) (1UL << (_event))
+
+/** @brief All charger state events. */
+#define NPM1300_EVENT_MASK_CHARGER                                             \
+    (NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_SUPPLEMENT) |                        \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_TRICKLE)    |                        \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_CC)         |                        \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_CV)         |                        \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_COMPLETED)  |                        \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_ERROR))
+
+/** @brief Battery connection events. */
+#define NPM1300_EVENT_MASK_BATTERY                                             \
+    (NPM1300_EVENT_MASK(NPM1300_EVENT_BATTERY_DETECTED) |                      \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_BATTERY_REMOVED))
+
+/** @brief VBUS connection events. */
+#define NPM1300_EVENT_MASK_VBUS                                                \
+    (NPM1300_EVENT_MASK(NPM1300_EVENT_VBUS_DETECTED) |                         \
+     NPM1300_EVENT_MASK(NPM1300_EVENT_VBUS_REMOVED))
+
+/**
+ * @brief Event handler.
+ *
+ * @details Called from the TWI interrupt context, after the events have been cleared in
+ *          the PMIC. May schedule TWI transactions.
+ *
+ * @param[in] events    Mask of the subscribed events that occurred.
+ * @param[in] p_context Subscriber context.
+ */
+typedef void (*npm1300_event_handler_t)(uint32_t events, void * p_context);
+
+/** @brief Event engine configuration. */
+typedef struct
+{
+    twi_queue_t * p_queue;   /**< Queue of the PMIC bus. */
+    uint8_t       address;   /**< 7-bit PMIC address. */
+    uint32_t      int_pin;   /**< nRF pin connected to the PMIC interrupt output. */
+    uint8_t       pmic_gpio; /**< PMIC GPIO configured as interrupt output. */
+} npm1300_events_config_t;
+
+/** @brief Counters of the event engine. */
+typedef struct
+{
+    uint32_t interrupts; /**< Rising edges of the interrupt line. */
+    uint32_t reads;      /**< Read and clear cycles. */
+    uint32_t events;     /**< Events dispatched to subscribers. */
+    uint32_t errors;     /**< Cycles aborted by a TWI error. */
+} npm1300_events_stats_t;
+
+/** @brief Subscriber of an instance. */
+typedef struct
+{
+    uint32_t                events;
+    npm1300_event_handler_t handler;
+    void                  * p_context;
+} npm1300_events_subscriber_t;
+
+/**
+ * @brief Event engine instance.
+ *
+ * @details Fields are private to the module. The buffers are used by the queued transfers,
+ *          so the instance must be located in RAM and stay valid while it is in use.
+ */
+typedef struct
+{
+    npm1300_events_config_t     config;
+    npm1300_events_subscriber_t subscribers[NPM1300_EVENTS_SUBSCRIBERS_MAX];
+    uint8_t                     subscriber_count;
+    uint32_t                    enabled;
+    uint8_t                     group_first;
+    uint8_t                     group_last;
+    volatile bool               busy;
+    volatile bool               pending;
+    npm1300_events_stats_t      stats;
+    uint8_t                     set_reg[2];
+    uint8_t                     set_raw[NPM1300_EVENTS_SPAN_MAX];
+    uint8_t                     clr_data[2 + NPM1300_EVENTS_SPAN_MAX];
+    uint8_t                     span_first;
+    uint8_t                     span_len;
+    uint32_t                    events;
+    twi_queue_xfer_t            read_xfer;
+    twi_queue_xfer_t            clear_xfer;
+    twi_queue_transaction_t     read_transaction;
+    twi_queue_transaction_t     clear_transaction;
+} npm1300_events_t;
+
+/**
+ * @brief Function for configuring the interrupt output and the GPIOTE sense.
+ *
+ * @details All PMIC events are disabled and cleared, events are then enabled by
+ *          @ref npm1300_events_subscribe. Blocking, must be called from thread mode after
+ *          the TWI queue has been initialized.
+ *
+ * @param[out] p_events Instance.
+ * @param[in]  p_config PMIC bus, address and interrupt line.
+ *
+ * @retval NRF_ERROR_NO_MEM        @ref NPM1300_EVENTS_INSTANCES_MAX reached.
+ * @retval NRF_ERROR_INVALID_PARAM Unknown PMIC GPIO.
+ * @return NRF_SUCCESS or the error of the TWI or GPIOTE driver.
+ */
+ret_code_t npm1300_events_init(npm1300_events_t * p_events, npm1300_events_config_t const * p_config);
+
+/**
+ * @brief Function for subscribing to events.
+ *
+ * @details Enables the interrupt of the events in the PMIC. Blocking, must be called from
+ *          thread mode after @ref npm1300_events_init.
+ *
+ * @param[in] p_events  Instance.
+ * @param[in] events    Mask of events, see @ref NPM1300_EVENT_MASK.
+ * @param[in] handler   Handler called with the events that occurred.
+ * @param[in] p_context Passed to the handler.
+ *
+ * @retval NRF_SUCCESS             Subscribed.
+ * @retval NRF_ERROR_INVALID_PARAM No handler or unknown events.
+ * @retval NRF_ERROR_NO_MEM        @ref NPM1300_EVENTS_SUBSCRIBERS_MAX reached.
+ */
+ret_code_t npm1300_events_subscribe(npm1300_events_t      * p_events,
+                                    uint32_t                events,
+                                    npm1300_event_handler_t handler,
+                                    void                  * p_context);
+
+/**
+ * @brief Function for getting the event engine counters.
+ */
+void npm1300_events_stats_get(npm1300_events_t const * p_events, npm1300_events_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NPM1300_EVENTS_H__
+
+/** @} */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include "ntc_temp.h"
+
+static const ntc_table_t ntc_table = {
+#include "ntc_table.inc"
+};
+
+uint16_t ntc_temp_lut_beta_get(void)
+{
+    return ntc_table.beta;
+}
+
+int32_t ntc_temp_lut_get(uint16_t code)
+{
+    uint32_t idx;
+    int32_t  frac;
+
+    /* Shorted and open NTCs read as the ends of the range */
+    if (code < ntc_table.code_min)
+    {
+        code = ntc_table.code_min;
+    }
+    else if (code > ntc_table.code_max)
+    {
+        code = ntc_table.code_max;
+    }
+
+    idx  = code / NTC_TABLE_STEP;
+    frac = (int32_t)(code % NTC_TABLE_STEP);
+
+    return ntc_table.millicelsius[idx] +
+           (((ntc_table.millicelsius[idx + 1U] - ntc_table.millicelsius[idx]) * frac) / NTC_TABLE_STEP);
+}
+
+float ntc_temp_calc(uint16_t code, uint16_t beta)
+{
+    /* Ref: Datasheet Figure 42: Battery temperature (Kelvin) */
+    float log_result = log((1024.f / (float)code) - 1);
+    float inv_temp_k = (1.f / 298.15f) - (log_result / (float)beta);
+
+    return (1.f / inv_temp_k) - 273.15f;
+}
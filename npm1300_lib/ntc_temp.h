@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup ntc_temp NTC battery temperature conversion
+ * @{
+ * @brief Conversion of the nPM1300 NTC ADC code to the battery temperature.
+ *
+ * @details @ref ntc_temp_lut_get interpolates in a table generated from the thermistor
+ *          beta by tools/ntc_table and included from ntc_table.inc, with integer arithmetic
+ *          only. The table covers -40 to 125 C, codes beyond it saturate to the nearest
+ *          end, down to a shorted NTC on the hot side and up to an open one on the cold
+ *          side. Within the range the worst case error against @ref ntc_temp_calc is
+ *          written at the top of ntc_table.inc, below 0.04 C for beta 3380.
+ *
+ *          @ref ntc_temp_calc evaluates the datasheet formula and costs a logarithm and
+ *          several divisions, which are library calls on parts without an FPU.
+ */
+
+#ifndef NTC_TEMP_H__
+#define NTC_TEMP_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief ADC codes between two table entries. */
+#define NTC_TABLE_STEP 4
+
+/** @brief Number of table entries, covering the codes 0 to 1024. */
+#define NTC_TABLE_LEN ((1024 / NTC_TABLE_STEP) + 1)
+
+/** @brief Temperature table for one thermistor beta. */
+typedef struct
+{
+    uint16_t beta;                        /**< Thermistor beta the table was generated for. */
+    uint16_t code_min;                    /**< Lowest code within the range, the hot end. */
+    uint16_t code_max;                    /**< Highest code within the range, the cold end. */
+    int32_t  millicelsius[NTC_TABLE_LEN]; /**< Temperature at every NTC_TABLE_STEP codes. */
+} ntc_table_t;
+
+/**
+ * @brief Function for getting the thermistor beta of the built-in table.
+ */
+uint16_t ntc_temp_lut_beta_get(void);
+
+/**
+ * @brief Function for converting an NTC ADC code with the built-in table.
+ *
+ * @param[in] code 10-bit ADC code.
+ *
+ * @return Temperature in millidegrees Celsius, saturated to the range of the table.
+ */
+int32_t ntc_temp_lut_get(uint16_t code);
+
+/**
+ * @brief Function for converting an NTC ADC code with the datasheet formula.
+ *
+ * @param[in] code 10-bit ADC code.
+ * @param[in] beta Thermistor beta.
+ *
+ * @return Temperature in degrees Celsius.
+ */
+float ntc_temp_calc(uint16_t code, uint16_t beta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NTC_TEMP_H__
+
+/** @} */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sdk_common.h"
+
+#if PROFILE_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "SEGGER_RTT.h"
+#include "profile.h"
+
+/* The nRF52 CPU runs at 64 MHz */
+#define CYCLES_PER_US 64U
+
+static profile_stats_t m_stats[PROFILE_SCOPE_COUNT];
+
+static char const * const m_names[PROFILE_SCOPE_COUNT] =
+{
+    [PROFILE_SCOPE_FETCH]    = "fetch",
+    [PROFILE_SCOPE_CONVERT]  = "convert",
+    [PROFILE_SCOPE_PROCESS]  = "process",
+    [PROFILE_SCOPE_ESTIMATE] = "tte/ttf",
+    [PROFILE_SCOPE_LOG]      = "log",
+};
+
+/* Index of the highest set bit, 0 for 0 and 1 */
+static uint32_t bin_get(uint32_t cycles)
+{
+    uint32_t bin = 0U;
+
+    while ((cycles >>= 1) != 0U)
+    {
+        bin++;
+    }
+
+    return MIN(bin, PROFILE_BINS - 1U);
+}
+
+void profile_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0U;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    profile_reset();
+}
+
+void profile_record(profile_scope_t scope, uint32_t cycles)
+{
+    profile_stats_t * p_stats = &m_stats[scope];
+
+    CRITICAL_REGION_ENTER();
+    if ((p_stats->count == 0U) || (cycles < p_stats->min))
+    {
+        p_stats->min = cycles;
+    }
+    if (cycles > p_stats->max)
+    {
+        p_stats->max = cycles;
+    }
+    p_stats->count++;
+    p_stats->sum += cycles;
+    p_stats->bins[bin_get(cycles)]++;
+    CRITICAL_REGION_EXIT();
+}
+
+void profile_get(profile_scope_t scope, profile_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats[scope];
+    CRITICAL_REGION_EXIT();
+}
+
+uint32_t profile_mean_get(profile_stats_t const * p_stats)
+{
+    if (p_stats->count == 0U)
+    {
+        return 0U;
+    }
+
+    return (uint32_t)(p_stats->sum / p_stats->count);
+}
+
+char const * profile_scope_name_get(profile_scope_t scope)
+{
+    return m_names[scope];
+}
+
+void profile_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(m_stats, 0, sizeof(m_stats));
+    CRITICAL_REGION_EXIT();
+}
+
+void profile_dump(void)
+{
+    profile_stats_t stats;
+
+    printf("scope        count      min     mean      max  [cycles, mean us]\r\n");
+
+    for (uint32_t scope = 0U; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        uint32_t mean;
+
+        profile_get((profile_scope_t)scope, &stats);
+        mean = profile_mean_get(&stats);
+
+        printf("%-8s %9lu %8lu %8lu %8lu  %lu\r\n", m_names[scope], (unsigned long)stats.count,
+               (unsigned long)stats.min, (unsigned long)mean, (unsigned long)stats.max,
+               (unsigned long)(mean / CYCLES_PER_US));
+
+        /* Non-empty bins as log2 of the lower bound and count */
+        printf("        ");
+        for (uint32_t bin = 0U; bin < PROFILE_BINS; bin++)
+        {
+            if (stats.bins[bin] != 0U)
+            {
+                printf(" 2^%lu:%lu", (unsigned long)bin, (unsigned long)stats.bins[bin]);
+            }
+        }
+        printf("\r\n");
+    }
+}
+
+void profile_command_poll(void)
+{
+    while (SEGGER_RTT_HasKey())
+    {
+        switch (SEGGER_RTT_GetKey())
+        {
+            case 'p':
+                profile_dump();
+                break;
+
+            case 'r':
+                profile_reset();
+                printf("profile cleared\r\n");
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+#endif // PROFILE_ENABLED
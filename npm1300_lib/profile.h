@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup profile Cycle count profiling
+ * @{
+ * @brief CPU cycles spent in the stages of a fuel gauge update, from the DWT cycle counter.
+ *
+ * @details A scope is the code between @ref PROFILE_BEGIN and @ref PROFILE_END. Every pass
+ *          adds its cycle count to the statistics of the scope: count, minimum, maximum, sum
+ *          for the mean and a histogram with one bin per power of two.
+ *
+ *          The counter stops while the CPU sleeps in WFE, so the scope of a bus transaction
+ *          measures what the transaction costs the CPU, not how long it takes. Interrupts
+ *          served inside a scope are counted in.
+ *
+ *          Without PROFILE_ENABLED the macros expand to nothing and the statistics take no
+ *          RAM. With it, 'p' typed into the RTT terminal prints the statistics and 'r' clears
+ *          them, see @ref profile_command_poll.
+ */
+
+#ifndef PROFILE_H__
+#define PROFILE_H__
+
+#include <stdint.h>
+#include "sdk_common.h"
+
+#if PROFILE_ENABLED
+#include "nrf.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Histogram bins. Bin n counts passes of 2^n to 2^(n+1) - 1 cycles, the last one all above. */
+#define PROFILE_BINS 20
+
+/** @brief Instrumented stages of an update. */
+typedef enum
+{
+    PROFILE_SCOPE_FETCH,    /**< Sample fetch, bus transactions included. */
+    PROFILE_SCOPE_CONVERT,  /**< Conversion of ADC codes to temperature, current and voltage. */
+    PROFILE_SCOPE_PROCESS,  /**< nrf_fuel_gauge_process. */
+    PROFILE_SCOPE_ESTIMATE, /**< Time to empty or time to full estimate. */
+    PROFILE_SCOPE_LOG,      /**< Telemetry record or log line of an update. */
+    PROFILE_SCOPE_COUNT
+} profile_scope_t;
+
+/** @brief Statistics of a scope, in CPU cycles. */
+typedef struct
+{
+    uint32_t count;              /**< Passes. */
+    uint32_t min;                /**< Shortest pass, 0 before the first one. */
+    uint32_t max;                /**< Longest pass. */
+    uint64_t sum;                /**< Sum of all passes. */
+    uint32_t bins[PROFILE_BINS]; /**< Passes per power of two. */
+} profile_stats_t;
+
+#if PROFILE_ENABLED
+
+/** @brief Macro for starting a scope. Declares a variable, so it goes where declarations may. */
+#define PROFILE_BEGIN(_scope) uint32_t const profile_start_##_scope = DWT->CYCCNT
+
+/** @brief Macro for ending a scope started in the same block. */
+#define PROFILE_END(_scope) profile_record((_scope), DWT->CYCCNT - profile_start_##_scope)
+
+#else
+
+#define PROFILE_BEGIN(_scope)
+#define PROFILE_END(_scope)
+
+#endif // PROFILE_ENABLED
+
+/**
+ * @brief Function for starting the cycle counter and clearing the statistics.
+ *
+ * @details The counter is part of the debug unit and keeps running with a debugger attached.
+ */
+void profile_init(void);
+
+/**
+ * @brief Function for adding a pass to the statistics of a scope.
+ *
+ * @details Called by @ref PROFILE_END. Scopes may be recorded from interrupt handlers.
+ */
+void profile_record(profile_scope_t scope, uint32_t cycles);
+
+/**
+ * @brief Function for getting a copy of the statistics of a scope.
+ */
+void profile_get(profile_scope_t scope, profile_stats_t * p_stats);
+
+/**
+ * @brief Function for getting the mean of a scope in cycles, 0 before the first pass.
+ */
+uint32_t profile_mean_get(profile_stats_t const * p_stats);
+
+/**
+ * @brief Function for getting the name of a scope.
+ */
+char const * profile_scope_name_get(profile_scope_t scope);
+
+/**
+ * @brief Function for clearing the statistics of all scopes.
+ */
+void profile_reset(void);
+
+/**
+ * @brief Function for printing the statistics of all scopes to RTT terminal 0.
+ */
+void profile_dump(void);
+
+/**
+ * @brief Function for serving a command typed into the RTT terminal.
+ *
+ * @details 'p' prints the statistics, 'r' clears them, other keys are ignored. To be called
+ *          from the main loop.
+ */
+void profile_command_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILE_H__
+
+/** @} */
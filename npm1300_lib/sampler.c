@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sampler.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+/* Longest timeout app_timer accepts: the 24-bit counter range minus its safe window. */
+#define SAMPLER_TICKS_MAX  (APP_TIMER_MAX_CNT_VAL - APP_TIMER_TICKS(APP_TIMER_SAFE_WINDOW_MS))
+
+APP_TIMER_DEF(m_sample_timer);
+
+static uint32_t      m_period_ticks;
+static uint32_t      m_deadline;
+static bool          m_phase_align;
+static bool          m_running;
+static volatile bool m_sample_pending;
+
+/* Arm the one-shot timer for the next deadline, skipping deadlines that have already passed. */
+static ret_code_t timer_arm(void)
+{
+    uint32_t now = app_timer_cnt_get();
+    uint32_t timeout;
+
+    if (!m_phase_align)
+    {
+        m_deadline = now;
+    }
+
+    for (;;)
+    {
+        m_deadline = (m_deadline + m_period_ticks) & APP_TIMER_MAX_CNT_VAL;
+        timeout    = app_timer_cnt_diff_compute(m_deadline, now);
+
+        if ((timeout >= APP_TIMER_MIN_TIMEOUT_TICKS) && (timeout <= m_period_ticks))
+        {
+            break;
+        }
+    }
+
+    return app_timer_start(m_sample_timer, timeout, NULL);
+}
+
+static void sample_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    m_sample_pending = true;
+    (void)timer_arm();
+
+    /* Wake up the main loop if the interrupt arrived just before it went to sleep. */
+    __SEV();
+}
+
+static uint32_t period_ticks_get(uint32_t period_ms)
+{
+    uint64_t ticks = ((uint64_t)period_ms * APP_TIMER_CLOCK_FREQ) /
+                     ((APP_TIMER_CONFIG_RTC_FREQUENCY + 1) * 1000);
+
+    if ((ticks < APP_TIMER_MIN_TIMEOUT_TICKS) || (ticks > SAMPLER_TICKS_MAX))
+    {
+        return 0;
+    }
+
+    return (uint32_t)ticks;
+}
+
+ret_code_t sampler_init(void)
+{
+    return app_timer_create(&m_sample_timer, APP_TIMER_MODE_SINGLE_SHOT, sample_timeout_handler);
+}
+
+ret_code_t sampler_start(sampler_config_t const * p_config)
+{
+    uint32_t ticks = period_ticks_get(p_config->period_ms);
+
+    if (ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    ret_code_t ret = sampler_stop();
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    m_period_ticks   = ticks;
+    m_phase_align    = p_config->phase_align;
+    m_deadline       = app_timer_cnt_get();
+    m_sample_pending = false;
+    m_running        = true;
+
+    return timer_arm();
+}
+
+ret_code_t sampler_period_set(uint32_t period_ms)
+{
+    uint32_t ticks = period_ticks_get(period_ms);
+
+    if (ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (!m_running)
+    {
+        m_period_ticks = ticks;
+        return NRF_SUCCESS;
+    }
+
+    ret_code_t ret = app_timer_stop(m_sample_timer);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* Step back to the last deadline that was reached, then re-arm with the new period. */
+    CRITICAL_REGION_ENTER();
+    m_deadline     = (m_deadline - m_period_ticks) & APP_TIMER_MAX_CNT_VAL;
+    m_period_ticks = ticks;
+    CRITICAL_REGION_EXIT();
+
+    return timer_arm();
+}
+
+ret_code_t sampler_stop(void)
+{
+    m_running = false;
+
+    return app_timer_stop(m_sample_timer);
+}
+
+void sampler_sample_request(void)
+{
+    m_sample_pending = true;
+    __SEV();
+}
+
+bool sampler_sample_pending_take(void)
+{
+    bool pending;
+
+    CRITICAL_REGION_ENTER();
+    pending          = m_sample_pending;
+    m_sample_pending = false;
+    CRITICAL_REGION_EXIT();
+
+    return pending;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup sampler Fuel gauge sampling scheduler
+ * @{
+ * @brief Periodic sample trigger running on the RTC through app_timer.
+ *
+ * @details The timer handler only raises a flag and sends an event, so the main loop can
+ *          sleep in WFE between samples. With phase alignment enabled, each deadline is
+ *          computed from the previous deadline rather than from the time the timer fired,
+ *          so the sample grid does not drift with handling latency.
+ */
+
+#ifndef SAMPLER_H__
+#define SAMPLER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Sampler configuration. */
+typedef struct
+{
+    uint32_t period_ms;   /**< Time between two samples. */
+    bool     phase_align; /**< Schedule from the previous deadline instead of from now. */
+} sampler_config_t;
+
+/**
+ * @brief Function for creating the sampling timer.
+ *
+ * @details app_timer must be initialized and the LFCLK running before the sampler is started.
+ */
+ret_code_t sampler_init(void);
+
+/**
+ * @brief Function for starting periodic sampling.
+ *
+ * @details The first sample is due one period after the call.
+ *
+ * @retval NRF_SUCCESS             Sampling started.
+ * @retval NRF_ERROR_INVALID_PARAM Period is zero or does not fit the RTC counter range.
+ */
+ret_code_t sampler_start(sampler_config_t const * p_config);
+
+/**
+ * @brief Function for changing the period of a running sampler.
+ *
+ * @details The new period is applied from the next deadline, which keeps the phase of the
+ *          sample grid when phase alignment is enabled.
+ */
+ret_code_t sampler_period_set(uint32_t period_ms);
+
+/**
+ * @brief Function for stopping periodic sampling.
+ */
+ret_code_t sampler_stop(void);
+
+/**
+ * @brief Function for requesting a sample ahead of the period, e.g. on a PMIC event.
+ *
+ * @details Can be called from interrupt handlers. The periodic deadlines are not moved.
+ */
+void sampler_sample_request(void);
+
+/**
+ * @brief Function for checking and clearing the sample request.
+ *
+ * @return True if a sample has become due since the last call.
+ */
+bool sampler_sample_pending_take(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLER_H__
+
+/** @} */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_ringbuf.h"
+#include "SEGGER_RTT.h"
+#include "telemetry.h"
+
+/* RTT buffer read by the debugger, a few records are enough as the queue holds the rest. */
+#define TELEMETRY_RTT_BUF_SIZE  (8U * sizeof(telemetry_record_t))
+
+/* The host decoder reads the record as laid out here. */
+STATIC_ASSERT(sizeof(telemetry_record_t) == 32U);
+
+/* Records never wrap in the queue, so a record is always allocated in one piece. */
+STATIC_ASSERT((FUEL_GAUGE_TELEMETRY_BUF_SIZE % sizeof(telemetry_record_t)) == 0U);
+
+NRF_RINGBUF_DEF(m_telemetry_buf, FUEL_GAUGE_TELEMETRY_BUF_SIZE);
+
+static uint8_t           m_rtt_buf[TELEMETRY_RTT_BUF_SIZE];
+static uint8_t           m_seq;
+static telemetry_stats_t m_stats;
+
+ret_code_t telemetry_init(void)
+{
+    nrf_ringbuf_init(&m_telemetry_buf);
+
+    m_seq = 0U;
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    if (SEGGER_RTT_ConfigUpBuffer(FUEL_GAUGE_TELEMETRY_RTT_CHANNEL, "Telemetry", m_rtt_buf,
+                                  sizeof(m_rtt_buf), SEGGER_RTT_MODE_NO_BLOCK_TRIM) < 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+void telemetry_put(telemetry_record_t * p_record)
+{
+    uint8_t * p_data;
+    size_t    length = sizeof(*p_record);
+
+    p_record->sync = TELEMETRY_RECORD_SYNC;
+    p_record->seq  = m_seq++;
+    m_stats.records++;
+
+    if (nrf_ringbuf_alloc(&m_telemetry_buf, &p_data, &length, true) != NRF_SUCCESS)
+    {
+        m_stats.dropped++;
+        return;
+    }
+
+    /* Less than a record is left until the read position, the queue is full. */
+    if (length < sizeof(*p_record))
+    {
+        (void)nrf_ringbuf_put(&m_telemetry_buf, 0);
+        m_stats.dropped++;
+        return;
+    }
+
+    memcpy(p_data, p_record, sizeof(*p_record));
+    (void)nrf_ringbuf_put(&m_telemetry_buf, sizeof(*p_record));
+}
+
+void telemetry_flush(void)
+{
+    uint8_t * p_data;
+    size_t    length;
+    unsigned  written;
+
+    /* The queue hands out contiguous data only, so a wrapped queue takes two rounds. */
+    do
+    {
+        length = FUEL_GAUGE_TELEMETRY_BUF_SIZE;
+        if (nrf_ringbuf_get(&m_telemetry_buf, &p_data, &length, true) != NRF_SUCCESS)
+        {
+            return;
+        }
+
+        written = (length != 0U) ?
+                  SEGGER_RTT_Write(FUEL_GAUGE_TELEMETRY_RTT_CHANNEL, p_data, (unsigned)length) : 0U;
+        m_stats.bytes += written;
+
+        (void)nrf_ringbuf_free(&m_telemetry_buf, written);
+    } while ((length != 0U) && (written == length));
+}
+
+void telemetry_stats_get(telemetry_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
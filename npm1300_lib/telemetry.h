@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup telemetry Fuel gauge telemetry
+ * @{
+ * @brief Binary fuel gauge records, queued in RAM and sent over SEGGER RTT at idle.
+ *
+ * @details A record is copied into an nrf_ringbuf when the sample is processed and
+ *          nothing is formatted on the device. @ref telemetry_flush moves the queued
+ *          bytes to a dedicated RTT up channel without blocking, whatever does not fit
+ *          stays queued for the next call. When the queue is full new records are
+ *          dropped, the host sees the gap in the record counter.
+ *          tools/telemetry_decode turns the channel output into CSV.
+ */
+
+#ifndef TELEMETRY_H__
+#define TELEMETRY_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief First byte of every record. */
+#define TELEMETRY_RECORD_SYNC 0xA5U
+
+/**
+ * @brief Telemetry record, little endian as stored in RAM.
+ *
+ * @details Battery channels are the fixed-point values of the charger snapshot, gauge
+ *          outputs are the floats returned by the gauge library, bit for bit.
+ */
+typedef struct
+{
+    uint8_t  sync;       /**< TELEMETRY_RECORD_SYNC. */
+    uint8_t  seq;        /**< Record counter, incremented for dropped records as well. */
+    uint8_t  chg_status; /**< CHG_STAT register. */
+    uint8_t  vbus_stat;  /**< VBUS status register. */
+    uint32_t time_ms;    /**< Uptime of the sample. */
+    int32_t  voltage_uv; /**< Battery voltage. */
+    int32_t  current_ua; /**< Battery current, positive when discharging. */
+    int32_t  temp_mdeg;  /**< Battery temperature in millidegrees Celsius. */
+    float    soc;        /**< State of charge in percent. */
+    float    tte;        /**< Time to empty in seconds, NaN when unknown, charging or not estimated. */
+    float    ttf;        /**< Time to full in seconds, NaN when unknown, discharging or not estimated. */
+} telemetry_record_t;
+
+/** @brief Record statistics. */
+typedef struct
+{
+    uint32_t records; /**< Records passed to @ref telemetry_put. */
+    uint32_t dropped; /**< Records dropped because the queue was full. */
+    uint32_t bytes;   /**< Bytes written to the RTT channel. */
+} telemetry_stats_t;
+
+/**
+ * @brief Function for setting up the queue and the RTT up channel.
+ *
+ * @details The channel is FUEL_GAUGE_TELEMETRY_RTT_CHANNEL, in non-blocking trim mode.
+ */
+ret_code_t telemetry_init(void);
+
+/**
+ * @brief Function for queuing a record.
+ *
+ * @details The sync byte and the record counter are filled in. Must be called from
+ *          thread mode.
+ *
+ * @param[in,out] p_record Record to queue.
+ */
+void telemetry_put(telemetry_record_t * p_record);
+
+/**
+ * @brief Function for writing queued records to the RTT channel.
+ *
+ * @details Never blocks. Call from the idle loop before going to sleep.
+ */
+void telemetry_flush(void);
+
+/**
+ * @brief Function for getting the record statistics.
+ */
+void telemetry_stats_get(telemetry_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H__
+
+/** @} */
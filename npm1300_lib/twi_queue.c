@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "twi_queue.h"
+#include "app_util_platform.h"
+
+typedef struct
+{
+    volatile bool done;
+    ret_code_t    result;
+} perform_ctx_t;
+
+/* Start the transfer (or the read phase of it) the queue is positioned at. */
+static ret_code_t xfer_start(twi_queue_t * p_queue)
+{
+    twi_queue_xfer_t const * p_xfer = &p_queue->p_current->p_xfers[p_queue->xfer_idx];
+
+#if TWI_QUEUE_USE_TWIM
+    if (p_xfer->rx_len != 0)
+    {
+        /* Register address and read-back go out in one EasyDMA transfer with a repeated start. */
+        nrfx_twim_xfer_desc_t const desc = NRFX_TWIM_XFER_DESC_TXRX(p_xfer->address,
+                                                                    (uint8_t *)p_xfer->p_tx,
+                                                                    p_xfer->tx_len,
+                                                                    p_xfer->p_rx,
+                                                                    p_xfer->rx_len);
+
+        return nrfx_twim_xfer(&p_queue->twi, &desc, 0);
+    }
+
+    nrfx_twim_xfer_desc_t const desc = NRFX_TWIM_XFER_DESC_TX(p_xfer->address,
+                                                              (uint8_t *)p_xfer->p_tx,
+                                                              p_xfer->tx_len);
+
+    return nrfx_twim_xfer(&p_queue->twi, &desc, 0);
+#else
+    if (p_queue->rx_phase)
+    {
+        return nrfx_twi_rx(&p_queue->twi, p_xfer->address, p_xfer->p_rx, p_xfer->rx_len);
+    }
+
+    /* No stop condition between the register address and the read. */
+    return nrfx_twi_tx(&p_queue->twi, p_xfer->address, p_xfer->p_tx, p_xfer->tx_len,
+                       p_xfer->rx_len != 0);
+#endif
+}
+
+static void transaction_end(twi_queue_t * p_queue, ret_code_t result)
+{
+    twi_queue_transaction_t const * p_transaction = p_queue->p_current;
+
+    p_queue->p_current = NULL;
+
+    if (p_transaction->callback != NULL)
+    {
+        p_transaction->callback(result, p_transaction->p_context);
+    }
+}
+
+/* Order in which the priority classes are served. */
+static const twi_queue_priority_t m_priority_order[TWI_QUEUE_PRIORITY_COUNT] =
+{
+    TWI_QUEUE_PRIORITY_HIGH,
+    TWI_QUEUE_PRIORITY_NORMAL,
+    TWI_QUEUE_PRIORITY_LOW,
+};
+
+#if TWI_QUEUE_USE_TWIM
+/* Take the bus back from the hook before a transaction is started, and hand it over once
+ * the queue has run dry. Called with interrupts disabled.
+ */
+static void bus_handover(twi_queue_t * p_queue, bool start)
+{
+    twi_queue_bus_hook_t const * p_hook = p_queue->p_bus_hook;
+
+    if (p_hook == NULL)
+    {
+        return;
+    }
+
+    if (start && !p_queue->bus_owned)
+    {
+        p_hook->acquire(p_hook->p_context);
+        p_queue->bus_owned = true;
+    }
+    else if (!start && p_queue->bus_owned && (p_queue->p_current == NULL))
+    {
+        p_hook->release(p_hook->p_context);
+        p_queue->bus_owned = false;
+    }
+}
+#endif
+
+static void transaction_start_next(twi_queue_t * p_queue)
+{
+    for (;;)
+    {
+        twi_queue_transaction_t const * p_next = NULL;
+
+        CRITICAL_REGION_ENTER();
+        for (uint8_t i = 0; (i < TWI_QUEUE_PRIORITY_COUNT) && (p_queue->p_current == NULL); i++)
+        {
+            twi_queue_priority_t prio = m_priority_order[i];
+
+            if (p_queue->head[prio] != p_queue->tail[prio])
+            {
+                p_next = p_queue->p_pending[prio][p_queue->head[prio]];
+                p_queue->head[prio] = (p_queue->head[prio] + 1) % TWI_QUEUE_SIZE;
+
+                p_queue->p_current = p_next;
+                p_queue->xfer_idx  = 0;
+                p_queue->rx_phase  = false;
+            }
+        }
+#if TWI_QUEUE_USE_TWIM
+        bus_handover(p_queue, p_next != NULL);
+#endif
+        CRITICAL_REGION_EXIT();
+
+        if (p_next == NULL)
+        {
+            return;
+        }
+
+        ret_code_t ret = xfer_start(p_queue);
+        if (ret == NRF_SUCCESS)
+        {
+            return;
+        }
+
+        transaction_end(p_queue, ret);
+    }
+}
+
+static void xfer_done(twi_queue_t * p_queue, ret_code_t result)
+{
+    if (result == NRF_SUCCESS)
+    {
+#if !TWI_QUEUE_USE_TWIM
+        twi_queue_xfer_t const * p_xfer = &p_queue->p_current->p_xfers[p_queue->xfer_idx];
+
+        if (!p_queue->rx_phase && (p_xfer->rx_len != 0))
+        {
+            p_queue->rx_phase = true;
+        }
+        else
+#endif
+        {
+            p_queue->xfer_count++;
+            p_queue->xfer_idx++;
+            p_queue->rx_phase = false;
+
+            if (p_queue->xfer_idx == p_queue->p_current->count)
+            {
+                transaction_end(p_queue, NRF_SUCCESS);
+                transaction_start_next(p_queue);
+                return;
+            }
+        }
+
+        result = xfer_start(p_queue);
+        if (result == NRF_SUCCESS)
+        {
+            return;
+        }
+    }
+
+    transaction_end(p_queue, result);
+    transaction_start_next(p_queue);
+}
+
+#if TWI_QUEUE_USE_TWIM
+/**
+ * @brief TWIM events handler.
+ */
+static void twim_handler(nrfx_twim_evt_t const * p_event, void * p_context)
+{
+    twi_queue_t * p_queue = (twi_queue_t *)p_context;
+    ret_code_t    result;
+
+    /* Error of a transfer started by the bus hook user */
+    if (p_queue->p_current == NULL)
+    {
+        return;
+    }
+
+    switch (p_event->type)
+    {
+        case NRFX_TWIM_EVT_DONE:
+            result = NRF_SUCCESS;
+            break;
+
+        case NRFX_TWIM_EVT_ADDRESS_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_ANACK;
+            break;
+
+        case NRFX_TWIM_EVT_DATA_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_DNACK;
+            break;
+
+        default:
+            result = NRF_ERROR_INTERNAL;
+            break;
+    }
+
+    xfer_done(p_queue, result);
+}
+#else
+/**
+ * @brief TWI events handler.
+ */
+static void twi_handler(nrfx_twi_evt_t const * p_event, void * p_context)
+{
+    ret_code_t result;
+
+    switch (p_event->type)
+    {
+        case NRFX_TWI_EVT_DONE:
+            result = NRF_SUCCESS;
+            break;
+
+        case NRFX_TWI_EVT_ADDRESS_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_ANACK;
+            break;
+
+        case NRFX_TWI_EVT_DATA_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_DNACK;
+            break;
+
+        default:
+            result = NRF_ERROR_INTERNAL;
+            break;
+    }
+
+    xfer_done((twi_queue_t *)p_context, result);
+}
+#endif
+
+ret_code_t twi_queue_init(twi_queue_t * p_queue, twi_queue_config_t const * p_config)
+{
+    ret_code_t ret;
+#if TWI_QUEUE_USE_TWIM
+    const nrfx_twim_config_t config =
+    {
+       .scl                = p_config->scl,
+       .sda                = p_config->sda,
+       .frequency          = (nrf_twim_frequency_t)p_config->frequency,
+       .interrupt_priority = p_config->interrupt_priority,
+       .hold_bus_uninit    = false
+    };
+#else
+    const nrfx_twi_config_t config =
+    {
+       .scl                = p_config->scl,
+       .sda                = p_config->sda,
+       .frequency          = (p_config->frequency == TWI_QUEUE_FREQ_400K) ?
+                             NRF_TWI_FREQ_400K : (nrf_twi_frequency_t)p_config->frequency,
+       .interrupt_priority = p_config->interrupt_priority,
+       .hold_bus_uninit    = false
+    };
+#endif
+
+    memset(p_queue->head, 0, sizeof(p_queue->head));
+    memset(p_queue->tail, 0, sizeof(p_queue->tail));
+    p_queue->p_current  = NULL;
+    p_queue->xfer_count = 0;
+
+#if TWI_QUEUE_USE_TWIM
+    p_queue->p_bus_hook = NULL;
+    p_queue->bus_owned  = true;
+
+    ret = nrfx_twim_init(&p_queue->twi, &config, twim_handler, p_queue);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    nrfx_twim_enable(&p_queue->twi);
+#else
+    ret = nrfx_twi_init(&p_queue->twi, &config, twi_handler, p_queue);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    nrfx_twi_enable(&p_queue->twi);
+#endif
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t twi_queue_schedule(twi_queue_t * p_queue, twi_queue_transaction_t const * p_transaction)
+{
+    ret_code_t           ret  = NRF_SUCCESS;
+    twi_queue_priority_t prio = p_transaction->priority;
+
+    if ((p_transaction->p_xfers == NULL) || (p_transaction->count == 0) ||
+        (prio >= TWI_QUEUE_PRIORITY_COUNT))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    uint8_t next_tail = (p_queue->tail[prio] + 1) % TWI_QUEUE_SIZE;
+
+    if (next_tail == p_queue->head[prio])
+    {
+        ret = NRF_ERROR_NO_MEM;
+    }
+    else
+    {
+        p_queue->p_pending[prio][p_queue->tail[prio]] = p_transaction;
+        p_queue->tail[prio] = next_tail;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (ret == NRF_SUCCESS)
+    {
+        transaction_start_next(p_queue);
+    }
+
+    return ret;
+}
+
+static void perform_callback(ret_code_t result, void * p_context)
+{
+    perform_ctx_t * p_ctx = (perform_ctx_t *)p_context;
+
+    p_ctx->result = result;
+    p_ctx->done   = true;
+}
+
+ret_code_t twi_queue_perform(twi_queue_t * p_queue, twi_queue_xfer_t const * p_xfers, uint8_t count)
+{
+    perform_ctx_t ctx = { .done = false, .result = NRF_SUCCESS };
+    twi_queue_transaction_t const transaction =
+    {
+        .callback  = perform_callback,
+        .p_context = &ctx,
+        .p_xfers   = p_xfers,
+        .count     = count,
+        .priority  = TWI_QUEUE_PRIORITY_NORMAL,
+    };
+
+    ret_code_t ret = twi_queue_schedule(p_queue, &transaction);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* The TWI interrupt wakes the core up, so sleep instead of spinning on the flag. */
+    while (!ctx.done)
+    {
+        __WFE();
+    }
+
+    return ctx.result;
+}
+
+#if TWI_QUEUE_USE_TWIM
+void twi_queue_bus_hook_set(twi_queue_t * p_queue, twi_queue_bus_hook_t const * p_hook)
+{
+    CRITICAL_REGION_ENTER();
+    if (!p_queue->bus_owned)
+    {
+        p_queue->p_bus_hook->acquire(p_queue->p_bus_hook->p_context);
+        p_queue->bus_owned = true;
+    }
+    p_queue->p_bus_hook = p_hook;
+    CRITICAL_REGION_EXIT();
+
+    /* Hands the bus over right away when the queue is idle */
+    transaction_start_next(p_queue);
+}
+#endif
+
+bool twi_queue_is_idle(twi_queue_t const * p_queue)
+{
+    if (p_queue->p_current != NULL)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < TWI_QUEUE_PRIORITY_COUNT; i++)
+    {
+        if (p_queue->head[i] != p_queue->tail[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
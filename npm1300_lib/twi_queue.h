@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup twi_queue TWI transaction queue
+ * @{
+ * @brief Non-blocking queue of TWI transactions driven from the TWI interrupt.
+ *
+ * @details A transaction is a chain of transfers that is executed back to back from the
+ *          TWI event handler. The owner of the transaction is notified through a callback
+ *          once the last transfer has finished, so the CPU can sleep while the bus is busy.
+ *          The queue only talks to the nrfx_twi or nrfx_twim driver API, so it can be run
+ *          on a host against a mocked driver backend.
+ *
+ *          With @ref TWI_QUEUE_USE_TWIM set, the TWIM peripheral is used and every transfer,
+ *          including write-then-read with a repeated start, is a single EasyDMA transaction.
+ *          Otherwise the legacy TWI peripheral is used, and a read takes two driver calls
+ *          with an interrupt per byte.
+ *
+ *          Several devices can share a bus through one queue. Every transaction has a
+ *          priority class with its own FIFO, and when the bus becomes free the oldest
+ *          transaction of the highest non-empty class is started. A transaction that has
+ *          started is never interrupted, so a multi-transfer sequence stays atomic, and a
+ *          high priority transaction waits at most for the one on the bus.
+ */
+
+#ifndef TWI_QUEUE_H__
+#define TWI_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_common.h"
+
+#if TWI_QUEUE_USE_TWIM
+#include "nrfx_twim.h"
+#else
+#include "nrfx_twi.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of transactions waiting in each priority class. */
+#ifndef TWI_QUEUE_SIZE
+#define TWI_QUEUE_SIZE 8
+#endif
+
+#if TWI_QUEUE_USE_TWIM
+typedef nrfx_twim_t twi_queue_instance_t;
+#define TWI_QUEUE_INSTANCE(_idx) NRFX_TWIM_INSTANCE(_idx)
+#else
+typedef nrfx_twi_t twi_queue_instance_t;
+#define TWI_QUEUE_INSTANCE(_idx) NRFX_TWI_INSTANCE(_idx)
+#endif
+
+/**
+ * @brief Bus frequencies, as FREQUENCY register values of the TWIM peripheral.
+ *
+ * @details The legacy TWI peripheral uses a different value for 400 kbps, the
+ *          translation is done in @ref twi_queue_init.
+ */
+typedef enum
+{
+    TWI_QUEUE_FREQ_100K = 0x01980000UL, /**< 100 kbps. */
+    TWI_QUEUE_FREQ_250K = 0x04000000UL, /**< 250 kbps. */
+    TWI_QUEUE_FREQ_400K = 0x06400000UL, /**< 400 kbps. */
+} twi_queue_frequency_t;
+
+/**
+ * @brief Transaction priority classes.
+ *
+ * @details The zero value is the default of transactions that do not set a priority.
+ */
+typedef enum
+{
+    TWI_QUEUE_PRIORITY_NORMAL, /**< Periodic sampling. */
+    TWI_QUEUE_PRIORITY_HIGH,   /**< Time-critical transactions, such as interrupt status reads. */
+    TWI_QUEUE_PRIORITY_LOW,    /**< Bulk transfers that can wait, such as FIFO reads. */
+    TWI_QUEUE_PRIORITY_COUNT
+} twi_queue_priority_t;
+
+/**
+ * @brief Single bus transfer.
+ *
+ * @details @p p_tx is written first. If @p rx_len is not zero, @p p_rx is then read
+ *          after a repeated start, which is the usual register read.
+ *          Buffers must stay valid until the transaction has completed. With the TWIM
+ *          backend they must also be located in RAM, EasyDMA cannot read from flash.
+ */
+typedef struct
+{
+    uint8_t         address; /**< 7-bit slave address. */
+    uint8_t const * p_tx;    /**< Data to write (register address followed by payload). */
+    uint8_t         tx_len;  /**< Number of bytes to write. */
+    uint8_t       * p_rx;    /**< Buffer for the read data, NULL for write-only transfers. */
+    uint8_t         rx_len;  /**< Number of bytes to read. */
+} twi_queue_xfer_t;
+
+/** @brief Write-only transfer initializer. */
+#define TWI_QUEUE_WRITE(_addr, _p_tx, _tx_len)                                 \
+    {                                                                          \
+        .address = (_addr),                                                    \
+        .p_tx    = (uint8_t const *)(_p_tx),                                   \
+        .tx_len  = (_tx_len),                                                  \
+        .p_rx    = NULL,                                                       \
+        .rx_len  = 0,                                                          \
+    }
+
+/** @brief Write-then-read transfer initializer. */
+#define TWI_QUEUE_READ(_addr, _p_tx, _tx_len, _p_rx, _rx_len)                  \
+    {                                                                          \
+        .address = (_addr),                                                    \
+        .p_tx    = (uint8_t const *)(_p_tx),                                   \
+        .tx_len  = (_tx_len),                                                  \
+        .p_rx    = (uint8_t *)(_p_rx),                                         \
+        .rx_len  = (_rx_len),                                                  \
+    }
+
+/**
+ * @brief Transaction completion callback.
+ *
+ * @details Called from the TWI interrupt context.
+ *
+ * @param[in] result    NRF_SUCCESS or the error of the first failing transfer.
+ * @param[in] p_context User context from the transaction.
+ */
+typedef void (*twi_queue_callback_t)(ret_code_t result, void * p_context);
+
+/**
+ * @brief Chain of transfers executed without other transactions in between.
+ *
+ * @details The structure is referenced by the queue, not copied, and must stay valid
+ *          until the callback has been called.
+ */
+typedef struct
+{
+    twi_queue_callback_t     callback;  /**< Completion callback, can be NULL. */
+    void                   * p_context; /**< Passed to the callback. */
+    twi_queue_xfer_t const * p_xfers;   /**< Transfers to execute. */
+    uint8_t                  count;     /**< Number of transfers. */
+    twi_queue_priority_t     priority;  /**< Priority class, normal when not set. */
+} twi_queue_transaction_t;
+
+#if TWI_QUEUE_USE_TWIM
+/**
+ * @brief Handover of the bus to a user that starts transfers without the queue.
+ *
+ * @details Such a user drives the peripheral behind the queue directly, e.g. through PPI.
+ *          It owns the bus while the queue is idle. Both functions are called with
+ *          interrupts disabled, see @ref twi_queue_bus_hook_set.
+ */
+typedef struct
+{
+    void (*acquire)(void * p_context); /**< Stop starting transfers and wait for the one in progress. */
+    void (*release)(void * p_context); /**< Resume, the peripheral registers must be set up again. */
+    void * p_context;                  /**< Passed to both functions. */
+} twi_queue_bus_hook_t;
+#endif
+
+/** @brief Bus configuration. */
+typedef struct
+{
+    uint32_t              scl;                /**< SCL pin number. */
+    uint32_t              sda;                /**< SDA pin number. */
+    twi_queue_frequency_t frequency;          /**< Bus frequency. */
+    uint8_t               interrupt_priority; /**< TWI interrupt priority. */
+} twi_queue_config_t;
+
+/** @brief Queue instance. Use @ref TWI_QUEUE_DEF to create one. */
+typedef struct
+{
+    twi_queue_instance_t            twi;
+    twi_queue_transaction_t const * p_pending[TWI_QUEUE_PRIORITY_COUNT][TWI_QUEUE_SIZE];
+    uint8_t                         head[TWI_QUEUE_PRIORITY_COUNT];
+    uint8_t                         tail[TWI_QUEUE_PRIORITY_COUNT];
+    twi_queue_transaction_t const * volatile p_current;
+    uint8_t                         xfer_idx;
+    bool                            rx_phase;
+    volatile uint32_t               xfer_count;
+#if TWI_QUEUE_USE_TWIM
+    twi_queue_bus_hook_t const    * p_bus_hook;
+    bool                            bus_owned;
+#endif
+} twi_queue_t;
+
+/**
+ * @brief Macro for defining a queue bound to a TWI peripheral.
+ *
+ * @param _name    Name of the instance.
+ * @param _twi_idx Index of the TWI or TWIM peripheral.
+ */
+#define TWI_QUEUE_DEF(_name, _twi_idx)                                         \
+    static twi_queue_t _name = { .twi = TWI_QUEUE_INSTANCE(_twi_idx) }
+
+/**
+ * @brief Function for initializing the TWI peripheral behind a queue.
+ *
+ * @param[in] p_queue  Queue instance.
+ * @param[in] p_config Bus configuration.
+ *
+ * @return Error code returned by the TWI driver.
+ */
+ret_code_t twi_queue_init(twi_queue_t * p_queue, twi_queue_config_t const * p_config);
+
+/**
+ * @brief Function for adding a transaction to the queue.
+ *
+ * @details The transaction is started immediately when the bus is idle, otherwise it
+ *          waits behind the transactions of the same or a higher priority class.
+ *          Can be called from thread mode and from interrupt handlers, including
+ *          transaction callbacks.
+ *
+ * @param[in] p_queue       Queue instance.
+ * @param[in] p_transaction Transaction to execute.
+ *
+ * @retval NRF_SUCCESS             Transaction queued.
+ * @retval NRF_ERROR_NO_MEM        Queue of the priority class is full.
+ * @retval NRF_ERROR_INVALID_PARAM Transaction has no transfers or an unknown priority.
+ */
+ret_code_t twi_queue_schedule(twi_queue_t * p_queue, twi_queue_transaction_t const * p_transaction);
+
+/**
+ * @brief Function for executing transfers and sleeping until they complete.
+ *
+ * @details The transfers are queued with normal priority. The CPU waits in WFE
+ *          instead of polling the bus. Must not be called from an
+ *          interrupt with priority equal to or higher than the TWI interrupt.
+ *
+ * @param[in] p_queue Queue instance.
+ * @param[in] p_xfers Transfers to execute.
+ * @param[in] count   Number of transfers.
+ *
+ * @return Result of the transaction.
+ */
+ret_code_t twi_queue_perform(twi_queue_t * p_queue, twi_queue_xfer_t const * p_xfers, uint8_t count);
+
+#if TWI_QUEUE_USE_TWIM
+/**
+ * @brief Function for sharing the bus with a user that starts transfers without the queue.
+ *
+ * @details The bus is released to the hook as soon as the queue is idle, and acquired back
+ *          before the next transaction is started. Transactions scheduled meanwhile wait for
+ *          @p acquire to return, which must not take longer than one transfer of the other
+ *          user. Removing the hook acquires the bus for the queue for good.
+ *          Only available with @ref TWI_QUEUE_USE_TWIM, the legacy TWI driver does not leave
+ *          the peripheral to others between transfers.
+ *
+ * @param[in] p_queue Queue instance.
+ * @param[in] p_hook  Hook to hand the bus over to, NULL to remove the hook.
+ */
+void twi_queue_bus_hook_set(twi_queue_t * p_queue, twi_queue_bus_hook_t const * p_hook);
+#endif
+
+/**
+ * @brief Function for checking if the queue has no transaction in progress or pending.
+ */
+bool twi_queue_is_idle(twi_queue_t const * p_queue);
+
+/**
+ * @brief Function for getting the number of completed bus transfers.
+ *
+ * @details A write-then-read transfer counts as one bus transaction.
+ */
+static inline uint32_t twi_queue_xfer_count_get(twi_queue_t const * p_queue)
+{
+    return p_queue->xfer_count;
+}
+
+/**
+ * @brief Function for getting the driver instance of the peripheral behind the queue.
+ *
+ * @details For the user of a bus hook, which may only start transfers while it owns the bus.
+ */
+static inline twi_queue_instance_t const * twi_queue_instance_get(twi_queue_t const * p_queue)
+{
+    return &p_queue->twi;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TWI_QUEUE_H__
+
+/** @} */
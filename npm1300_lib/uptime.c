@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "uptime.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+#define UPTIME_TICK_FREQ   (APP_TIMER_CLOCK_FREQ / (APP_TIMER_CONFIG_RTC_FREQUENCY + 1))
+
+/* Well inside the counter wrap period and the longest timeout app_timer accepts. */
+#define UPTIME_KEEPALIVE_MS  (60UL * 1000UL)
+
+APP_TIMER_DEF(m_keepalive_timer);
+
+static uint64_t m_ticks;
+static uint32_t m_last_cnt;
+
+static void keepalive_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    (void)uptime_ticks_get();
+}
+
+ret_code_t uptime_init(void)
+{
+    ret_code_t ret;
+
+    m_ticks    = 0;
+    m_last_cnt = app_timer_cnt_get();
+
+    ret = app_timer_create(&m_keepalive_timer, APP_TIMER_MODE_REPEATED, keepalive_handler);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    return app_timer_start(m_keepalive_timer, APP_TIMER_TICKS(UPTIME_KEEPALIVE_MS), NULL);
+}
+
+uint64_t uptime_ticks_get(void)
+{
+    uint64_t ticks;
+
+    CRITICAL_REGION_ENTER();
+    uint32_t cnt = app_timer_cnt_get();
+
+    m_ticks   += app_timer_cnt_diff_compute(cnt, m_last_cnt);
+    m_last_cnt = cnt;
+    ticks      = m_ticks;
+    CRITICAL_REGION_EXIT();
+
+    return ticks;
+}
+
+int64_t uptime_get(void)
+{
+    uint64_t ticks = uptime_ticks_get();
+
+    /* Split the conversion so the multiplication cannot overflow. */
+    return (int64_t)(((ticks / UPTIME_TICK_FREQ) * 1000U) +
+                     (((ticks % UPTIME_TICK_FREQ) * 1000U) / UPTIME_TICK_FREQ));
+}
+
+int64_t uptime_delta(int64_t * p_reftime)
+{
+    int64_t now   = uptime_get();
+    int64_t delta = now - *p_reftime;
+
+    *p_reftime = now;
+
+    return delta;
+}
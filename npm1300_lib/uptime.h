@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup uptime Monotonic uptime
+ * @{
+ * @brief 64-bit system uptime built on the app_timer RTC counter.
+ *
+ * @details The 24-bit RTC counter wraps every 512 s at 32768 Hz. It is extended to 64 bits
+ *          by accumulating the counter difference on every read, and a keep-alive timer
+ *          reads it often enough that no wrap is ever missed, even when nothing else asks
+ *          for the time. The API follows k_uptime_get() and k_uptime_delta() from Zephyr.
+ */
+
+#ifndef UPTIME_H__
+#define UPTIME_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function for starting the uptime counter.
+ *
+ * @details app_timer must be initialized and the LFCLK running. Uptime counts from this call.
+ */
+ret_code_t uptime_init(void);
+
+/**
+ * @brief Function for getting the uptime in RTC ticks.
+ */
+uint64_t uptime_ticks_get(void);
+
+/**
+ * @brief Function for getting the uptime in milliseconds.
+ */
+int64_t uptime_get(void);
+
+/**
+ * @brief Function for getting the time elapsed since a reference time.
+ *
+ * @param[in,out] p_reftime Reference time in milliseconds, updated to the current uptime.
+ *
+ * @return Elapsed time in milliseconds.
+ */
+int64_t uptime_delta(int64_t * p_reftime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UPTIME_H__
+
+/** @} */
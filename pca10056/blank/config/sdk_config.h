@@ -119,6 +119,140 @@
 #define NRF_STRERROR_ENABLED 1
 #endif
 
+// <q> CRC32_ENABLED  - crc32 - CRC32 calculation routines
+ 
+
+#ifndef CRC32_ENABLED
+#define CRC32_ENABLED 1
+#endif
+
+// <e> NRF_FSTORAGE_ENABLED - nrf_fstorage - Flash abstraction library
+//==========================================================
+#ifndef NRF_FSTORAGE_ENABLED
+#define NRF_FSTORAGE_ENABLED 1
+#endif
+// <h> nrf_fstorage - Common settings
+
+// <i> Common settings to all fstorage implementations
+//==========================================================
+// <q> NRF_FSTORAGE_PARAM_CHECK_DISABLED  - Disable user input validation
+ 
+
+// <i> If selected, use ASSERT to validate user input.
+// <i> This effectively removes user input validation in production code.
+// <i> Recommended setting: OFF, only enable this setting if size is a major concern.
+
+#ifndef NRF_FSTORAGE_PARAM_CHECK_DISABLED
+#define NRF_FSTORAGE_PARAM_CHECK_DISABLED 0
+#endif
+
+// </h> 
+//==========================================================
+
+// </e>
+
+// <e> APP_TIMER_ENABLED - app_timer - Application timer functionality
+//==========================================================
+#ifndef APP_TIMER_ENABLED
+#define APP_TIMER_ENABLED 1
+#endif
+// <o> APP_TIMER_CONFIG_RTC_FREQUENCY  - Configure RTC prescaler.
+ 
+// <0=> 32768 Hz 
+// <1=> 16384 Hz 
+// <3=> 8192 Hz 
+// <7=> 4096 Hz 
+// <15=> 2048 Hz 
+// <31=> 1024 Hz 
+
+#ifndef APP_TIMER_CONFIG_RTC_FREQUENCY
+#define APP_TIMER_CONFIG_RTC_FREQUENCY 0
+#endif
+
+// <o> APP_TIMER_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+
+// <i> Priorities 0,2 (nRF51) and 0,1,4,5 (nRF52) are reserved for SoftDevice
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef APP_TIMER_CONFIG_IRQ_PRIORITY
+#define APP_TIMER_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// <o> APP_TIMER_CONFIG_OP_QUEUE_SIZE - Capacity of timer requests queue. 
+// <i> Size of the queue depends on how many timers are used
+// <i> in the system, how often timers are started and overall
+// <i> system latency. If queue size is too small app_timer calls
+// <i> will fail.
+
+#ifndef APP_TIMER_CONFIG_OP_QUEUE_SIZE
+#define APP_TIMER_CONFIG_OP_QUEUE_SIZE 10
+#endif
+
+// <q> APP_TIMER_CONFIG_USE_SCHEDULER  - Enable scheduling app_timer events to app_scheduler
+ 
+
+#ifndef APP_TIMER_CONFIG_USE_SCHEDULER
+#define APP_TIMER_CONFIG_USE_SCHEDULER 0
+#endif
+
+// <q> APP_TIMER_KEEPS_RTC_ACTIVE  - Enable RTC always on
+ 
+
+// <i> If option is enabled RTC is kept running even if there is no active timers.
+// <i> This option can be used when app_timer is used for timestamping.
+
+#ifndef APP_TIMER_KEEPS_RTC_ACTIVE
+#define APP_TIMER_KEEPS_RTC_ACTIVE 1
+#endif
+
+// <o> APP_TIMER_SAFE_WINDOW_MS - Maximum possible latency (in milliseconds) of handling app_timer event. 
+// <i> Maximum possible timeout that can be set is reduced by safe window.
+// <i> Example: RTC frequency 16384 Hz, maximum possible timeout 1024 seconds - APP_TIMER_SAFE_WINDOW_MS.
+// <i> Since RTC is not stopped when processor is halted in debugging session, this value
+// <i> must cover it if debugging is needed. It is possible to halt processor for APP_TIMER_SAFE_WINDOW_MS
+// <i> without corrupting app_timer behavior.
+
+#ifndef APP_TIMER_SAFE_WINDOW_MS
+#define APP_TIMER_SAFE_WINDOW_MS 300000
+#endif
+
+// <h> App Timer Legacy configuration - Legacy configuration.
+
+//==========================================================
+// <q> APP_TIMER_WITH_PROFILER  - Enable app_timer profiling
+ 
+
+#ifndef APP_TIMER_WITH_PROFILER
+#define APP_TIMER_WITH_PROFILER 0
+#endif
+
+// <q> APP_TIMER_CONFIG_SWI_NUMBER  - Configure SWI instance used.
+ 
+
+#ifndef APP_TIMER_CONFIG_SWI_NUMBER
+#define APP_TIMER_CONFIG_SWI_NUMBER 0
+#endif
+
+// </h> 
+//==========================================================
+
+// </e>
+
+// <q> NRF_SORTLIST_ENABLED  - nrf_sortlist - Sorted list
+ 
+
+#ifndef NRF_SORTLIST_ENABLED
+#define NRF_SORTLIST_ENABLED 1
+#endif
+
 // <h> nrf_fprintf - fprintf function.
 
 //==========================================================
@@ -2995,16 +3129,501 @@
 // </e>
 
 
+// <e> NRF_CLOCK_ENABLED - nrf_drv_clock - CLOCK peripheral driver - legacy layer
+//==========================================================
+#ifndef NRF_CLOCK_ENABLED
+#define NRF_CLOCK_ENABLED 1
+#endif
+// <o> CLOCK_CONFIG_LF_SRC  - LF Clock Source
+ 
+// <0=> RC 
+// <1=> XTAL 
+// <2=> Synth 
+// <131073=> External Low Swing 
+// <196609=> External Full Swing 
+
+#ifndef CLOCK_CONFIG_LF_SRC
+#define CLOCK_CONFIG_LF_SRC 1
+#endif
+
+// <q> CLOCK_CONFIG_LF_CAL_ENABLED  - Calibration enable for LF Clock Source
+ 
+
+#ifndef CLOCK_CONFIG_LF_CAL_ENABLED
+#define CLOCK_CONFIG_LF_CAL_ENABLED 0
+#endif
+
+// <o> CLOCK_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+
+// <i> Priorities 0,2 (nRF51) and 0,1,4,5 (nRF52) are reserved for SoftDevice
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef CLOCK_CONFIG_IRQ_PRIORITY
+#define CLOCK_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// </e>
+
+// <e> NRFX_CLOCK_ENABLED - nrfx_clock - CLOCK peripheral driver
+//==========================================================
+#ifndef NRFX_CLOCK_ENABLED
+#define NRFX_CLOCK_ENABLED 1
+#endif
+// <o> NRFX_CLOCK_CONFIG_LF_SRC  - LF Clock Source
+ 
+// <0=> RC 
+// <1=> XTAL 
+// <2=> Synth 
+// <131073=> External Low Swing 
+// <196609=> External Full Swing 
+
+#ifndef NRFX_CLOCK_CONFIG_LF_SRC
+#define NRFX_CLOCK_CONFIG_LF_SRC 1
+#endif
+
+// <q> NRFX_CLOCK_CONFIG_LF_CAL_ENABLED  - Calibration enable for LF Clock Source
+ 
+
+#ifndef NRFX_CLOCK_CONFIG_LF_CAL_ENABLED
+#define NRFX_CLOCK_CONFIG_LF_CAL_ENABLED 0
+#endif
+
+// <o> NRFX_CLOCK_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef NRFX_CLOCK_CONFIG_IRQ_PRIORITY
+#define NRFX_CLOCK_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// </e>
+
+// <e> NRFX_GPIOTE_ENABLED - nrfx_gpiote - GPIOTE peripheral driver
+//==========================================================
+#ifndef NRFX_GPIOTE_ENABLED
+#define NRFX_GPIOTE_ENABLED NPM1300_EVENTS_ENABLED
+#endif
+// <o> NRFX_GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS - Number of lower power input pins 
+#ifndef NRFX_GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS
+#define NRFX_GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS 1
+#endif
+
+// <o> NRFX_GPIOTE_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef NRFX_GPIOTE_CONFIG_IRQ_PRIORITY
+#define NRFX_GPIOTE_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// <e> NRFX_GPIOTE_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef NRFX_GPIOTE_CONFIG_LOG_ENABLED
+#define NRFX_GPIOTE_CONFIG_LOG_ENABLED 0
+#endif
+// <o> NRFX_GPIOTE_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRFX_GPIOTE_CONFIG_LOG_LEVEL
+#define NRFX_GPIOTE_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> NRFX_GPIOTE_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_GPIOTE_CONFIG_INFO_COLOR
+#define NRFX_GPIOTE_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> NRFX_GPIOTE_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_GPIOTE_CONFIG_DEBUG_COLOR
+#define NRFX_GPIOTE_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
+// </e>
+
+// <q> NRFX_NVMC_ENABLED  - nrfx_nvmc - NVMC peripheral driver
+ 
+
+#ifndef NRFX_NVMC_ENABLED
+#define NRFX_NVMC_ENABLED 1
+#endif
+
+// <e> NRFX_PPI_ENABLED - nrfx_ppi - PPI peripheral allocator
+//==========================================================
+#ifndef NRFX_PPI_ENABLED
+#define NRFX_PPI_ENABLED HW_SAMPLER_ENABLED
+#endif
+// <e> NRFX_PPI_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef NRFX_PPI_CONFIG_LOG_ENABLED
+#define NRFX_PPI_CONFIG_LOG_ENABLED 0
+#endif
+// <o> NRFX_PPI_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRFX_PPI_CONFIG_LOG_LEVEL
+#define NRFX_PPI_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> NRFX_PPI_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_PPI_CONFIG_INFO_COLOR
+#define NRFX_PPI_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> NRFX_PPI_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_PPI_CONFIG_DEBUG_COLOR
+#define NRFX_PPI_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
+// </e>
+
+// <e> NRFX_RTC_ENABLED - nrfx_rtc - RTC peripheral driver
+//==========================================================
+#ifndef NRFX_RTC_ENABLED
+#define NRFX_RTC_ENABLED HW_SAMPLER_ENABLED
+#endif
+// <q> NRFX_RTC0_ENABLED  - Enable RTC0 instance
+ 
+
+#ifndef NRFX_RTC0_ENABLED
+#define NRFX_RTC0_ENABLED 0
+#endif
+
+// <q> NRFX_RTC1_ENABLED  - Enable RTC1 instance
+ 
+
+#ifndef NRFX_RTC1_ENABLED
+#define NRFX_RTC1_ENABLED 0
+#endif
+
+// <q> NRFX_RTC2_ENABLED  - Enable RTC2 instance
+ 
+
+#ifndef NRFX_RTC2_ENABLED
+#define NRFX_RTC2_ENABLED HW_SAMPLER_ENABLED
+#endif
+
+// <o> NRFX_RTC_MAXIMUM_LATENCY_US - Maximum possible time[us] in highest priority interrupt 
+#ifndef NRFX_RTC_MAXIMUM_LATENCY_US
+#define NRFX_RTC_MAXIMUM_LATENCY_US 2000
+#endif
+
+// <o> NRFX_RTC_DEFAULT_CONFIG_FREQUENCY - Frequency  <16-32768> 
+
+
+#ifndef NRFX_RTC_DEFAULT_CONFIG_FREQUENCY
+#define NRFX_RTC_DEFAULT_CONFIG_FREQUENCY 32768
+#endif
+
+// <q> NRFX_RTC_DEFAULT_CONFIG_RELIABLE  - Ensures safe compare event triggering
+ 
+
+#ifndef NRFX_RTC_DEFAULT_CONFIG_RELIABLE
+#define NRFX_RTC_DEFAULT_CONFIG_RELIABLE 0
+#endif
+
+// <o> NRFX_RTC_DEFAULT_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef NRFX_RTC_DEFAULT_CONFIG_IRQ_PRIORITY
+#define NRFX_RTC_DEFAULT_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// <e> NRFX_RTC_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef NRFX_RTC_CONFIG_LOG_ENABLED
+#define NRFX_RTC_CONFIG_LOG_ENABLED 0
+#endif
+// <o> NRFX_RTC_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRFX_RTC_CONFIG_LOG_LEVEL
+#define NRFX_RTC_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> NRFX_RTC_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_RTC_CONFIG_INFO_COLOR
+#define NRFX_RTC_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> NRFX_RTC_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_RTC_CONFIG_DEBUG_COLOR
+#define NRFX_RTC_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
+// </e>
+
+// <e> NRFX_TIMER_ENABLED - nrfx_timer - TIMER periperal driver
+//==========================================================
+#ifndef NRFX_TIMER_ENABLED
+#define NRFX_TIMER_ENABLED HW_SAMPLER_ENABLED
+#endif
+// <q> NRFX_TIMER0_ENABLED  - Enable TIMER0 instance
+ 
+
+#ifndef NRFX_TIMER0_ENABLED
+#define NRFX_TIMER0_ENABLED 0
+#endif
+
+// <q> NRFX_TIMER1_ENABLED  - Enable TIMER1 instance
+ 
+
+#ifndef NRFX_TIMER1_ENABLED
+#define NRFX_TIMER1_ENABLED HW_SAMPLER_ENABLED
+#endif
+
+// <q> NRFX_TIMER2_ENABLED  - Enable TIMER2 instance
+ 
+
+#ifndef NRFX_TIMER2_ENABLED
+#define NRFX_TIMER2_ENABLED 0
+#endif
+
+// <q> NRFX_TIMER3_ENABLED  - Enable TIMER3 instance
+ 
+
+#ifndef NRFX_TIMER3_ENABLED
+#define NRFX_TIMER3_ENABLED 0
+#endif
+
+// <q> NRFX_TIMER4_ENABLED  - Enable TIMER4 instance
+ 
+
+#ifndef NRFX_TIMER4_ENABLED
+#define NRFX_TIMER4_ENABLED 0
+#endif
+
+// <o> NRFX_TIMER_DEFAULT_CONFIG_FREQUENCY  - Timer frequency if in Timer mode
+ 
+// <0=> 16 MHz 
+// <1=> 8 MHz 
+// <2=> 4 MHz 
+// <3=> 2 MHz 
+// <4=> 1 MHz 
+// <5=> 500 kHz 
+// <6=> 250 kHz 
+// <7=> 125 kHz 
+// <8=> 62.5 kHz 
+// <9=> 31.25 kHz 
+
+#ifndef NRFX_TIMER_DEFAULT_CONFIG_FREQUENCY
+#define NRFX_TIMER_DEFAULT_CONFIG_FREQUENCY 0
+#endif
+
+// <o> NRFX_TIMER_DEFAULT_CONFIG_MODE  - Timer mode or operation
+ 
+// <0=> Timer 
+// <1=> Counter 
+
+#ifndef NRFX_TIMER_DEFAULT_CONFIG_MODE
+#define NRFX_TIMER_DEFAULT_CONFIG_MODE 0
+#endif
+
+// <o> NRFX_TIMER_DEFAULT_CONFIG_BIT_WIDTH  - Timer counter bit width
+ 
+// <0=> 16 bit 
+// <1=> 8 bit 
+// <2=> 24 bit 
+// <3=> 32 bit 
+
+#ifndef NRFX_TIMER_DEFAULT_CONFIG_BIT_WIDTH
+#define NRFX_TIMER_DEFAULT_CONFIG_BIT_WIDTH 0
+#endif
+
+// <o> NRFX_TIMER_DEFAULT_CONFIG_IRQ_PRIORITY  - Interrupt priority
+ 
+// <0=> 0 (highest) 
+// <1=> 1 
+// <2=> 2 
+// <3=> 3 
+// <4=> 4 
+// <5=> 5 
+// <6=> 6 
+// <7=> 7 
+
+#ifndef NRFX_TIMER_DEFAULT_CONFIG_IRQ_PRIORITY
+#define NRFX_TIMER_DEFAULT_CONFIG_IRQ_PRIORITY 6
+#endif
+
+// <e> NRFX_TIMER_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef NRFX_TIMER_CONFIG_LOG_ENABLED
+#define NRFX_TIMER_CONFIG_LOG_ENABLED 0
+#endif
+// <o> NRFX_TIMER_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRFX_TIMER_CONFIG_LOG_LEVEL
+#define NRFX_TIMER_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> NRFX_TIMER_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_TIMER_CONFIG_INFO_COLOR
+#define NRFX_TIMER_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> NRFX_TIMER_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRFX_TIMER_CONFIG_DEBUG_COLOR
+#define NRFX_TIMER_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
+// </e>
+
 // <e> NRFX_TWIM_ENABLED - nrfx_twim - TWIM peripheral driver
 //==========================================================
 #ifndef NRFX_TWIM_ENABLED
-#define NRFX_TWIM_ENABLED 1
+#define NRFX_TWIM_ENABLED TWI_QUEUE_USE_TWIM
 #endif
 // <q> NRFX_TWIM0_ENABLED  - Enable TWIM0 instance
  
 
 #ifndef NRFX_TWIM0_ENABLED
-#define NRFX_TWIM0_ENABLED 0
+#define NRFX_TWIM0_ENABLED TWI_QUEUE_USE_TWIM
 #endif
 
 // <q> NRFX_TWIM1_ENABLED  - Enable TWIM1 instance
@@ -3250,13 +3869,13 @@
 // <e> NRFX_TWI_ENABLED - nrfx_twi - TWI peripheral driver
 //==========================================================
 #ifndef NRFX_TWI_ENABLED
-#define NRFX_TWI_ENABLED 1
+#define NRFX_TWI_ENABLED (!TWI_QUEUE_USE_TWIM)
 #endif
 // <q> NRFX_TWI0_ENABLED  - Enable TWI0 instance
  
 
 #ifndef NRFX_TWI0_ENABLED
-#define NRFX_TWI0_ENABLED 1
+#define NRFX_TWI0_ENABLED (!TWI_QUEUE_USE_TWIM)
 #endif
 
 // <q> NRFX_TWI1_ENABLED  - Enable TWI1 instance
@@ -3365,6 +3984,298 @@
 // </h> 
 //==========================================================
 
+// <h> nRF_Segger_RTT 
+
+//==========================================================
+// <h> segger_rtt - SEGGER RTT
+
+//==========================================================
+// <o> SEGGER_RTT_CONFIG_BUFFER_SIZE_UP - Size of upstream buffer. 
+// <i> Note that either @ref NRF_LOG_BACKEND_RTT_OUTPUT_BUFFER_SIZE
+// <i> or this value is actually used. It depends on which one is bigger.
+
+#ifndef SEGGER_RTT_CONFIG_BUFFER_SIZE_UP
+#define SEGGER_RTT_CONFIG_BUFFER_SIZE_UP 512
+#endif
+
+// <o> SEGGER_RTT_CONFIG_MAX_NUM_UP_BUFFERS - Maximum number of upstream buffers. 
+#ifndef SEGGER_RTT_CONFIG_MAX_NUM_UP_BUFFERS
+#define SEGGER_RTT_CONFIG_MAX_NUM_UP_BUFFERS 2
+#endif
+
+// <o> SEGGER_RTT_CONFIG_BUFFER_SIZE_DOWN - Size of downstream buffer. 
+#ifndef SEGGER_RTT_CONFIG_BUFFER_SIZE_DOWN
+#define SEGGER_RTT_CONFIG_BUFFER_SIZE_DOWN 16
+#endif
+
+// <o> SEGGER_RTT_CONFIG_MAX_NUM_DOWN_BUFFERS - Maximum number of downstream buffers. 
+#ifndef SEGGER_RTT_CONFIG_MAX_NUM_DOWN_BUFFERS
+#define SEGGER_RTT_CONFIG_MAX_NUM_DOWN_BUFFERS 2
+#endif
+
+// <o> SEGGER_RTT_CONFIG_DEFAULT_MODE  - RTT behavior if the buffer is full.
+ 
+
+// <i> The following modes are supported:
+// <i> - SKIP  - Do not block, output nothing.
+// <i> - TRIM  - Do not block, output as much as fits.
+// <i> - BLOCK - Wait until there is space in the buffer.
+// <0=> SKIP 
+// <1=> TRIM 
+// <2=> BLOCK_IF_FIFO_FULL 
+
+#ifndef SEGGER_RTT_CONFIG_DEFAULT_MODE
+#define SEGGER_RTT_CONFIG_DEFAULT_MODE 0
+#endif
+
+// </h> 
+//==========================================================
+
+// </h> 
+//==========================================================
+
+// <h> nPM1300_fuel_gauge 
+
+//==========================================================
+// <q> NPM1300_CHARGER_FETCH_COALESCED  - Coalesce sample fetch registers into burst transfers
+ 
+
+// <i> Status registers are read in one burst and the VBAT and NTC
+// <i> measurement tasks are triggered with a single write.
+
+#ifndef NPM1300_CHARGER_FETCH_COALESCED
+#define NPM1300_CHARGER_FETCH_COALESCED 1
+#endif
+
+// <q> TWI_QUEUE_USE_TWIM  - Use the TWIM peripheral with EasyDMA for the PMIC bus
+ 
+
+// <i> Register reads are done as one TX-then-RX EasyDMA transfer with a
+// <i> repeated start. Selects which of the nrfx_twi and nrfx_twim drivers
+// <i> and instance 0 of the peripheral are enabled.
+
+#ifndef TWI_QUEUE_USE_TWIM
+#define TWI_QUEUE_USE_TWIM 1
+#endif
+
+// <o> NPM1300_TWI_FREQUENCY  - PMIC bus frequency
+ 
+// <26738688=> 100k 
+// <67108864=> 250k 
+// <104857600=> 400k 
+
+#ifndef NPM1300_TWI_FREQUENCY
+#define NPM1300_TWI_FREQUENCY 104857600
+#endif
+
+// <o> FUEL_GAUGE_SAMPLE_PERIOD_MS - Fuel gauge sampling period in milliseconds 
+#ifndef FUEL_GAUGE_SAMPLE_PERIOD_MS
+#define FUEL_GAUGE_SAMPLE_PERIOD_MS 1000
+#endif
+
+// <q> FUEL_GAUGE_SAMPLE_PHASE_ALIGN  - Keep samples on a fixed time grid
+ 
+
+// <i> Each sample is scheduled from the previous deadline instead of from
+// <i> the time the sample was handled, so handling latency and period
+// <i> changes never shift the sampling phase.
+
+#ifndef FUEL_GAUGE_SAMPLE_PHASE_ALIGN
+#define FUEL_GAUGE_SAMPLE_PHASE_ALIGN 1
+#endif
+
+// <e> FUEL_GAUGE_ADAPTIVE_ENABLED - Adapt the sampling period to the battery dynamics
+//==========================================================
+#ifndef FUEL_GAUGE_ADAPTIVE_ENABLED
+#define FUEL_GAUGE_ADAPTIVE_ENABLED 1
+#endif
+// <o> FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS - Longest sampling period in steady state 
+// <i> The period starts at FUEL_GAUGE_SAMPLE_PERIOD_MS and doubles on every
+// <i> steady sample up to this value.
+#ifndef FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS
+#define FUEL_GAUGE_SAMPLE_PERIOD_MAX_MS 64000
+#endif
+
+// <o> FUEL_GAUGE_STABLE_CURRENT_UA - Largest battery current change in steady state (uA) 
+#ifndef FUEL_GAUGE_STABLE_CURRENT_UA
+#define FUEL_GAUGE_STABLE_CURRENT_UA 5000
+#endif
+
+// <o> FUEL_GAUGE_STABLE_VOLTAGE_MV - Largest battery voltage change in steady state (mV) 
+#ifndef FUEL_GAUGE_STABLE_VOLTAGE_MV
+#define FUEL_GAUGE_STABLE_VOLTAGE_MV 10
+#endif
+
+// <o> FUEL_GAUGE_IDLE_CURRENT_UA - Known system idle current (uA) 
+// <i> Reported to the fuel gauge for gaps of at least FUEL_GAUGE_IDLE_PERIOD_MS
+// <i> while on battery with no measurable load. 0 disables idle reporting.
+#ifndef FUEL_GAUGE_IDLE_CURRENT_UA
+#define FUEL_GAUGE_IDLE_CURRENT_UA 50
+#endif
+
+// <o> FUEL_GAUGE_IDLE_PERIOD_MS - Shortest sampling gap treated as idle 
+#ifndef FUEL_GAUGE_IDLE_PERIOD_MS
+#define FUEL_GAUGE_IDLE_PERIOD_MS 8000
+#endif
+
+// </e>
+
+// <o> FUEL_GAUGE_LOG_ESTIMATE_INTERVAL - Updates per logged TTE/TTF estimate 
+// <i> The time to empty or time to full estimate is only computed when read.
+// <i> Every update logs the estimate if it has been read since the update,
+// <i> and every FUEL_GAUGE_LOG_ESTIMATE_INTERVAL-th update computes it for the
+// <i> log. The others log NaN. 0 never computes an estimate for the log.
+#ifndef FUEL_GAUGE_LOG_ESTIMATE_INTERVAL
+#define FUEL_GAUGE_LOG_ESTIMATE_INTERVAL 10
+#endif
+
+// <e> FUEL_GAUGE_TELEMETRY_ENABLED - Log binary fuel gauge records over RTT
+// <i> Each update queues a 32 byte record instead of formatting floats
+// <i> with printf. The queue is written to the RTT channel at idle, decode
+// <i> with tools/telemetry_decode.
+//==========================================================
+#ifndef FUEL_GAUGE_TELEMETRY_ENABLED
+#define FUEL_GAUGE_TELEMETRY_ENABLED 1
+#endif
+// <o> FUEL_GAUGE_TELEMETRY_BUF_SIZE - Record queue size in bytes, power of 2 
+#ifndef FUEL_GAUGE_TELEMETRY_BUF_SIZE
+#define FUEL_GAUGE_TELEMETRY_BUF_SIZE 1024
+#endif
+
+// <o> FUEL_GAUGE_TELEMETRY_RTT_CHANNEL - RTT up channel of the records <1-7> 
+// <i> Must be below SEGGER_RTT_CONFIG_MAX_NUM_UP_BUFFERS.
+#ifndef FUEL_GAUGE_TELEMETRY_RTT_CHANNEL
+#define FUEL_GAUGE_TELEMETRY_RTT_CHANNEL 1
+#endif
+
+// </e>
+
+// <q> PROFILE_ENABLED  - Count the CPU cycles of each fuel gauge update
+ 
+
+// <i> DWT cycle counter scopes around the sample fetch, the ADC code
+// <i> conversion, nrf_fuel_gauge_process, the TTE/TTF estimate and the
+// <i> logging. Minimum, maximum, mean and a log2 histogram per scope are
+// <i> kept in RAM, type p into the RTT terminal to print them, r to clear.
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+// <q> FUEL_GAUGE_WARM_BOOT_ENABLED  - Take over the configured PMIC after a soft reset
+ 
+
+// <i> GPREGRET and retained RAM mark a PMIC configured by a previous boot.
+// <i> After a soft, pin or watchdog reset its registers are checked with two
+// <i> burst reads instead of running the init sequence, and the gauge is
+// <i> seeded with the inputs of the last update before the reset.
+
+#ifndef FUEL_GAUGE_WARM_BOOT_ENABLED
+#define FUEL_GAUGE_WARM_BOOT_ENABLED 1
+#endif
+
+// <e> FUEL_GAUGE_CHECKPOINT_ENABLED - Keep the fuel gauge state in flash across power cycles
+// <i> A 32 byte record with the state of charge, the averaged battery inputs
+// <i> and the operating time is appended to a log in flash every time the
+// <i> state of charge has moved by FUEL_GAUGE_CHECKPOINT_SOC_STEP. A cold
+// <i> start seeds the gauge with the newest record. The pages must be kept
+// <i> out of the application, FLASH_SIZE of the project ends below them.
+//==========================================================
+#ifndef FUEL_GAUGE_CHECKPOINT_ENABLED
+#define FUEL_GAUGE_CHECKPOINT_ENABLED 1
+#endif
+// <o> FUEL_GAUGE_CHECKPOINT_START_ADDR - First flash page of the log 
+#ifndef FUEL_GAUGE_CHECKPOINT_START_ADDR
+#define FUEL_GAUGE_CHECKPOINT_START_ADDR 0xFE000
+#endif
+
+// <o> FUEL_GAUGE_CHECKPOINT_PAGES - Flash pages of the log <2-16> 
+// <i> Each 4 kB page holds 128 records and is erased once per pass of the log.
+#ifndef FUEL_GAUGE_CHECKPOINT_PAGES
+#define FUEL_GAUGE_CHECKPOINT_PAGES 2
+#endif
+
+// <o> FUEL_GAUGE_CHECKPOINT_SOC_STEP - State of charge change that writes a record (%) <1-100> 
+// <i> With 1 %, a full discharge writes 100 records.
+#ifndef FUEL_GAUGE_CHECKPOINT_SOC_STEP
+#define FUEL_GAUGE_CHECKPOINT_SOC_STEP 1
+#endif
+
+// <o> FUEL_GAUGE_CHECKPOINT_MAX_SOC_DIFF - Largest difference to the first sample (%) <0-100> 
+// <i> The checkpoint is not used when the state of charge estimated from the
+// <i> first sample after a cold start differs more, the battery has been
+// <i> charged or discharged while the device was off.
+#ifndef FUEL_GAUGE_CHECKPOINT_MAX_SOC_DIFF
+#define FUEL_GAUGE_CHECKPOINT_MAX_SOC_DIFF 20
+#endif
+
+// </e>
+
+// <e> NPM1300_EVENTS_ENABLED - Track charger and VBUS state from PMIC interrupts
+// <i> A PMIC GPIO is configured as interrupt output and wired to an nRF pin.
+// <i> Charger and VBUS status registers are only read when the PMIC reports
+// <i> a change, the periodic sample fetch reads the ADC results only.
+//==========================================================
+#ifndef NPM1300_EVENTS_ENABLED
+#define NPM1300_EVENTS_ENABLED 1
+#endif
+// <o> NPM1300_EVENTS_INT_PIN - nRF pin connected to the PMIC interrupt output <0-47> 
+#ifndef NPM1300_EVENTS_INT_PIN
+#define NPM1300_EVENTS_INT_PIN 30
+#endif
+
+// <o> NPM1300_EVENTS_PMIC_GPIO - PMIC GPIO used as interrupt output <0-4> 
+#ifndef NPM1300_EVENTS_PMIC_GPIO
+#define NPM1300_EVENTS_PMIC_GPIO 3
+#endif
+
+// </e>
+
+// <o> NPM1300_CHARGER_AUX_ADC_PERIOD - Samples between die temperature, VSYS and VBUS conversions <0-255> 
+// <i> The results are read with the battery channels at no extra cost, only
+// <i> triggering the conversions takes two short writes. 0 never triggers them.
+#ifndef NPM1300_CHARGER_AUX_ADC_PERIOD
+#define NPM1300_CHARGER_AUX_ADC_PERIOD 8
+#endif
+
+// <e> NPM1300_CHARGER_FETCH_FRESH - Read the results of conversions triggered by the same fetch
+// <i> The fetch triggers VBAT, IBAT and NTC, waits for the conversions and reads the
+// <i> results in a second transaction, so voltage, current and temperature are
+// <i> sampled together and at the time of the fetch. Costs one app_timer per charger.
+// <i> When disabled, the fetch reads the results triggered by the previous one and
+// <i> triggers the next, one transaction but a full period old.
+//==========================================================
+#ifndef NPM1300_CHARGER_FETCH_FRESH
+#define NPM1300_CHARGER_FETCH_FRESH 1
+#endif
+// <o> NPM1300_CHARGER_CONVERSION_US - Wait per triggered conversion in microseconds <50-10000> 
+// <i> Long enough for one ADC conversion, die temperature included.
+#ifndef NPM1300_CHARGER_CONVERSION_US
+#define NPM1300_CHARGER_CONVERSION_US 250
+#endif
+
+// </e>
+
+// <e> HW_SAMPLER_ENABLED - Sample the PMIC through PPI without waking the CPU
+// <i> RTC2 starts the ADC trigger and result read as one TWIM transfer through
+// <i> PPI on every period, TWIM writes the results to a list in RAM and TIMER1
+// <i> counts them. The CPU wakes up once per batch and feeds it to the fuel
+// <i> gauge. Needs TWI_QUEUE_USE_TWIM, RTC2 and TIMER1.
+//==========================================================
+#ifndef HW_SAMPLER_ENABLED
+#define HW_SAMPLER_ENABLED 0
+#endif
+// <o> HW_SAMPLER_BATCH - Samples per CPU wakeup <1-1000> 
+// <i> The list in RAM holds two batches of 25 bytes per sample.
+#ifndef HW_SAMPLER_BATCH
+#define HW_SAMPLER_BATCH 16
+#endif
+
+// </e>
+
+// </h> 
+//==========================================================
+
 // <<< end of configuration section >>>
 #endif //SDK_CONFIG_H
 
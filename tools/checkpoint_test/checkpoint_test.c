@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Runs checkpoint.c against the emulated flash of the nPM1300 host emulator: recovery of the
+ * newest record after a restart, wear over many passes of the log, and writes cut by a reset.
+ * A restart is a new checkpoint_init() on the flash left by the previous one.
+ */
+
+#include <stdio.h>
+#include "sdk_common.h"
+#include "checkpoint.h"
+#include "emu_flash.h"
+
+#define LOG_PAGES    FUEL_GAUGE_CHECKPOINT_PAGES
+#define LOG_SLOTS    (LOG_PAGES * (EMU_FLASH_PAGE_SIZE / sizeof(checkpoint_t)))
+#define FIRST_PAGE   (FUEL_GAUGE_CHECKPOINT_START_ADDR / EMU_FLASH_PAGE_SIZE)
+
+static uint32_t m_failures;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(expr))                                                       \
+        {                                                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #expr);   \
+            m_failures++;                                                  \
+        }                                                                  \
+    } while (0)
+
+/* Record with every field derived from n, so the one loaded tells which was stored */
+static checkpoint_t record_make(uint32_t n)
+{
+    return (checkpoint_t) {
+        .time_s     = n * 60U,
+        .soc        = (float)(n % 100U),
+        .voltage    = 3.f + ((float)(n % 100U) / 100.f),
+        .current    = 0.01f,
+        .temp       = 25.f,
+        .chg_status = (uint8_t)n,
+        .vbus_stat  = 0U,
+        .samples    = (uint16_t)n,
+    };
+}
+
+static void restart(void)
+{
+    CHECK(checkpoint_init() == NRF_SUCCESS);
+}
+
+/* The newest record must be the one made from n */
+static void newest_check(uint32_t n)
+{
+    checkpoint_t loaded;
+    checkpoint_t expected = record_make(n);
+
+    CHECK(checkpoint_load(&loaded) == NRF_SUCCESS);
+    CHECK(loaded.time_s == expected.time_s);
+    CHECK(loaded.samples == expected.samples);
+    CHECK(loaded.soc == expected.soc);
+}
+
+static void store(uint32_t n)
+{
+    checkpoint_t record = record_make(n);
+
+    CHECK(checkpoint_store(&record) == NRF_SUCCESS);
+}
+
+static void test_erased(void)
+{
+    checkpoint_t loaded;
+
+    emu_flash_reset();
+    restart();
+    CHECK(checkpoint_load(&loaded) == NRF_ERROR_NOT_FOUND);
+
+    store(1U);
+    newest_check(1U);
+    restart();
+    newest_check(1U);
+}
+
+/* Several passes over the log, with restarts in between: all pages wear the same. */
+static void test_wear(void)
+{
+    emu_flash_stats_t stats;
+    uint32_t          records = (5U * LOG_SLOTS) + 7U;
+    uint32_t          min_erases = UINT32_MAX;
+    uint32_t          max_erases = 0U;
+
+    emu_flash_reset();
+    restart();
+
+    for (uint32_t n = 0U; n < records; n++)
+    {
+        store(n);
+        if ((n % 37U) == 0U)
+        {
+            restart();
+            newest_check(n);
+        }
+    }
+
+    restart();
+    newest_check(records - 1U);
+
+    emu_flash_stats_get(&stats);
+    for (uint32_t page = FIRST_PAGE; page < (FIRST_PAGE + LOG_PAGES); page++)
+    {
+        min_erases = MIN(min_erases, stats.page_erases[page]);
+        max_erases = MAX(max_erases, stats.page_erases[page]);
+    }
+
+    CHECK(stats.overwrites == 0U);
+    CHECK((max_erases - min_erases) <= 1U);
+    CHECK(stats.erases == CEIL_DIV(records, LOG_SLOTS / LOG_PAGES));
+
+    printf("wear       %u records, %u page erases (%u..%u per page), %u words\n",
+           (unsigned)records, (unsigned)stats.erases, (unsigned)min_erases,
+           (unsigned)max_erases, (unsigned)stats.words);
+}
+
+/* A reset in the middle of every word of a record, in the middle of a page and right after
+ * the erase of the next page, also when the log wraps: the previous record is found, and the
+ * next one is written without programming a word twice.
+ */
+static void test_cut(void)
+{
+    emu_flash_stats_t stats;
+    uint32_t          n = 0U;
+    uint32_t          cuts = 0U;
+    uint32_t          positions[] = { 10U, LOG_SLOTS / LOG_PAGES, LOG_SLOTS };
+
+    for (size_t p = 0U; p < ARRAY_SIZE(positions); p++)
+    {
+        for (uint32_t words = 0U; words < (sizeof(checkpoint_t) / sizeof(uint32_t)); words++)
+        {
+            checkpoint_t record;
+
+            emu_flash_reset();
+            restart();
+            for (n = 0U; n < positions[p]; n++)
+            {
+                store(n);
+            }
+
+            /* Reset during the write of the next record */
+            emu_flash_cut_set(words);
+            record = record_make(n);
+            (void)checkpoint_store(&record);
+            cuts++;
+
+            restart();
+            newest_check(n - 1U);
+
+            store(n + 1U);
+            newest_check(n + 1U);
+            restart();
+            newest_check(n + 1U);
+
+            emu_flash_stats_get(&stats);
+            CHECK(stats.overwrites == 0U);
+        }
+    }
+
+    printf("cut writes %u resets, previous record recovered\n", (unsigned)cuts);
+}
+
+int main(void)
+{
+    test_erased();
+    test_wear();
+    test_cut();
+
+    if (m_failures != 0U)
+    {
+        printf("FAILED     %u checks\n", (unsigned)m_failures);
+        return 1;
+    }
+
+    printf("passed\n");
+
+    return 0;
+}
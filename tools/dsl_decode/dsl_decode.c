@@ -0,0 +1,889 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Decodes the I2C traffic of a DSLogic capture (.dsl) block by block and reports the
+ * nPM1300 transactions, bus utilization, gaps between transactions and transaction counts
+ * per register access and per driver function.
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "i2c_decoder.h"
+#include "zip_stream.h"
+
+#define CHUNK_SIZE       65536U
+#define SEGMENTS_MAX     4U
+#define SEGMENT_DATA_MAX 32U
+#define FUNCTIONS_MAX    128U
+#define GAP_BUCKETS      7U
+
+#define NPM1300_ADDR_DEFAULT 0x6BU
+
+typedef struct
+{
+    uint8_t     base;
+    uint8_t     offset;
+    const char *p_name;
+} reg_name_t;
+
+/* Register names as used by npm1300_charger.c */
+static const reg_name_t m_bases[] =
+{
+    { 0x02U, 0xFFU, "VBUS" },
+    { 0x03U, 0xFFU, "CHGR" },
+    { 0x04U, 0xFFU, "BUCK" },
+    { 0x05U, 0xFFU, "ADC"  },
+    { 0x08U, 0xFFU, "LDSW" },
+};
+
+static const reg_name_t m_regs[] =
+{
+    { 0x02U, 0x00U, "TASK_UPDATE" },
+    { 0x02U, 0x01U, "ILIM" },
+    { 0x02U, 0x07U, "STATUS" },
+    { 0x03U, 0x04U, "EN_SET" },
+    { 0x03U, 0x05U, "EN_CLR" },
+    { 0x03U, 0x08U, "ISET" },
+    { 0x03U, 0x0AU, "ISET_DISCHG" },
+    { 0x03U, 0x0CU, "VTERM" },
+    { 0x03U, 0x0DU, "VTERM_R" },
+    { 0x03U, 0x34U, "CHG_STAT" },
+    { 0x03U, 0x36U, "ERR_REASON" },
+    { 0x04U, 0x0AU, "BUCK2_NORM_VOUT" },
+    { 0x04U, 0x0BU, "BUCK2_RET_VOUT" },
+    { 0x04U, 0x0CU, "EN_CTRL" },
+    { 0x04U, 0x0DU, "VRET_CTRL" },
+    { 0x04U, 0x0EU, "PWM_CTRL" },
+    { 0x04U, 0x0FU, "SW_CTRL" },
+    { 0x05U, 0x00U, "TASK_VBAT" },
+    { 0x05U, 0x01U, "TASK_TEMP" },
+    { 0x05U, 0x09U, "CONFIG" },
+    { 0x05U, 0x0AU, "NTCR_SEL" },
+    { 0x05U, 0x10U, "RESULTS" },
+    { 0x05U, 0x24U, "IBAT_EN" },
+    { 0x08U, 0x05U, "GPISEL" },
+};
+
+typedef struct
+{
+    uint8_t  address;
+    bool     read;
+    bool     nack;
+    uint8_t  len;                    /**< Data bytes, may exceed the stored ones. */
+    uint8_t  data[SEGMENT_DATA_MAX];
+} segment_t;
+
+typedef struct
+{
+    uint64_t  start;
+    uint64_t  stop;
+    uint8_t   count;
+    segment_t segments[SEGMENTS_MAX];
+} transaction_t;
+
+typedef struct
+{
+    char     key[40];
+    uint32_t count;
+    uint64_t bytes;
+    uint64_t busy;
+} function_t;
+
+/* Driver functions, told apart by the registers their transactions access */
+typedef enum
+{
+    DRIVER_INIT,
+    DRIVER_FETCH,
+    DRIVER_STATUS,
+    DRIVER_EVENTS,
+    DRIVER_SETTER,
+    DRIVER_OTHER,
+    DRIVER_UNKNOWN,
+    DRIVER_COUNT
+} driver_fn_t;
+
+static const char * const m_driver_names[DRIVER_COUNT] =
+{
+    [DRIVER_INIT]    = "npm1300_charger_init",
+    [DRIVER_FETCH]   = "npm1300_charger_sample_fetch",
+    [DRIVER_STATUS]  = "status read on a PMIC event",
+    [DRIVER_EVENTS]  = "npm1300_events",
+    [DRIVER_SETTER]  = "npm1300_charger_*_set",
+    [DRIVER_OTHER]   = "other devices",
+    [DRIVER_UNKNOWN] = "unknown",
+};
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t bytes;
+    uint64_t busy;
+} driver_stats_t;
+
+typedef struct
+{
+    /* Options */
+    uint8_t  address;
+    bool     verbose;
+    double   burst_gap_us;
+    double   samplerate;
+
+    transaction_t current;
+    bool          active;
+    uint64_t      last_stop;
+    bool          have_last;
+
+    uint32_t transactions;
+    uint32_t foreign;
+    uint32_t nacks;
+    uint64_t bytes;
+    uint64_t busy;
+    uint64_t bit_samples;
+    uint64_t bit_bytes;
+
+    uint32_t gaps;
+    double   gap_sum_us;
+    double   gap_min_us;
+    double   gap_max_us;
+    uint32_t gap_hist[GAP_BUCKETS];
+
+    uint32_t bursts;
+    uint32_t burst_len_max;
+    uint32_t burst_len;
+
+    function_t functions[FUNCTIONS_MAX];
+    size_t     function_count;
+
+    driver_stats_t drivers[DRIVER_COUNT];
+    driver_stats_t burst_status; /**< Status reads of the burst, a fetch when it converts. */
+    bool           burst_adc;     /**< The burst started or read ADC conversions. */
+    bool           burst_results; /**< The burst read ADC results. */
+    bool           fetched;       /**< A burst before read ADC results, init is done. */
+} profile_t;
+
+static const char * base_name(uint8_t base)
+{
+    for (size_t i = 0; i < sizeof(m_bases) / sizeof(m_bases[0]); i++)
+    {
+        if (m_bases[i].base == base)
+        {
+            return m_bases[i].p_name;
+        }
+    }
+
+    return NULL;
+}
+
+static void reg_name(uint8_t base, uint8_t offset, char * p_buf, size_t size)
+{
+    const char * p_base = base_name(base);
+
+    for (size_t i = 0; i < sizeof(m_regs) / sizeof(m_regs[0]); i++)
+    {
+        if ((m_regs[i].base == base) && (m_regs[i].offset == offset))
+        {
+            snprintf(p_buf, size, "%s.%s", p_base, m_regs[i].p_name);
+            return;
+        }
+    }
+
+    if (p_base != NULL)
+    {
+        snprintf(p_buf, size, "%s+0x%02X", p_base, offset);
+    }
+    else
+    {
+        snprintf(p_buf, size, "0x%02X+0x%02X", base, offset);
+    }
+}
+
+static double to_us(profile_t const * p_prof, uint64_t samples)
+{
+    return (double)samples * 1e6 / p_prof->samplerate;
+}
+
+/* Describe the transaction as a register access. The key groups transactions of the same
+ * kind, the text adds the data.
+ */
+static void transaction_describe(profile_t const * p_prof, transaction_t const * p_tr,
+                                 char * p_key, size_t key_size, char * p_text, size_t text_size)
+{
+    segment_t const * p_seg = &p_tr->segments[0];
+    char              name[32];
+    size_t            pos;
+
+    if (p_seg->address != p_prof->address)
+    {
+        snprintf(p_key, key_size, "%s 0x%02X", p_seg->read ? "R" : "W", p_seg->address);
+        snprintf(p_text, text_size, "%s", p_key);
+        return;
+    }
+
+    if (p_seg->read || (p_seg->len < 2U))
+    {
+        snprintf(p_key, key_size, "%s [%u]", p_seg->read ? "R" : "W", p_seg->len);
+        snprintf(p_text, text_size, "%s", p_key);
+        return;
+    }
+
+    reg_name(p_seg->data[0], p_seg->data[1], name, sizeof(name));
+
+    if ((p_tr->count > 1U) && p_tr->segments[1].read)
+    {
+        segment_t const * p_rd = &p_tr->segments[1];
+
+        snprintf(p_key, key_size, "R %s [%u]", name, p_rd->len);
+        pos = (size_t)snprintf(p_text, text_size, "R %s =", name);
+        for (uint8_t i = 0; (i < p_rd->len) && (i < SEGMENT_DATA_MAX) && (pos < text_size); i++)
+        {
+            pos += (size_t)snprintf(&p_text[pos], text_size - pos, " %02X", p_rd->data[i]);
+        }
+        return;
+    }
+
+    snprintf(p_key, key_size, "W %s [%u]", name, p_seg->len - 2U);
+    pos = (size_t)snprintf(p_text, text_size, "W %s =", name);
+    for (uint8_t i = 2; (i < p_seg->len) && (i < SEGMENT_DATA_MAX) && (pos < text_size); i++)
+    {
+        pos += (size_t)snprintf(&p_text[pos], text_size - pos, " %02X", p_seg->data[i]);
+    }
+}
+
+static void function_count(profile_t * p_prof, const char * p_key, uint64_t bytes, uint64_t busy)
+{
+    function_t * p_fn = NULL;
+
+    for (size_t i = 0; i < p_prof->function_count; i++)
+    {
+        if (strcmp(p_prof->functions[i].key, p_key) == 0)
+        {
+            p_fn = &p_prof->functions[i];
+            break;
+        }
+    }
+
+    if (p_fn == NULL)
+    {
+        if (p_prof->function_count == FUNCTIONS_MAX)
+        {
+            p_key = "(other)";
+            p_fn  = &p_prof->functions[FUNCTIONS_MAX - 1U];
+        }
+        else
+        {
+            p_fn = &p_prof->functions[p_prof->function_count++];
+        }
+        snprintf(p_fn->key, sizeof(p_fn->key), "%s", p_key);
+    }
+
+    p_fn->count++;
+    p_fn->bytes += bytes;
+    p_fn->busy  += busy;
+}
+
+static void driver_count(driver_stats_t * p_stats, uint32_t count, uint64_t bytes, uint64_t busy)
+{
+    p_stats->count += count;
+    p_stats->bytes += bytes;
+    p_stats->busy  += busy;
+}
+
+/* Status reads belong to a sample fetch when their burst also converts, otherwise they
+ * follow a PMIC event.
+ */
+static void burst_end(profile_t * p_prof)
+{
+    driver_stats_t * p_status = &p_prof->burst_status;
+
+    driver_count(&p_prof->drivers[p_prof->burst_adc ? DRIVER_FETCH : DRIVER_STATUS],
+                 p_status->count, p_status->bytes, p_status->busy);
+    memset(p_status, 0, sizeof(*p_status));
+    p_prof->fetched      |= p_prof->burst_results;
+    p_prof->burst_adc     = false;
+    p_prof->burst_results = false;
+}
+
+/* Attribute a transaction to the driver function issuing it, by the register it accesses
+ * as npm1300_charger.c and npm1300_events.c use them. Configuration registers are written
+ * by init up to the burst of the first sample fetch, by the runtime setters after that.
+ */
+static void driver_classify(profile_t * p_prof, transaction_t const * p_tr, uint64_t bytes,
+                            uint64_t busy)
+{
+    segment_t const * p_seg = &p_tr->segments[0];
+    bool              read  = (p_tr->count > 1U) && p_tr->segments[1].read;
+    driver_fn_t       fn;
+    uint8_t           base;
+    uint8_t           offset;
+
+    if (p_seg->address != p_prof->address)
+    {
+        driver_count(&p_prof->drivers[DRIVER_OTHER], 1U, bytes, busy);
+        return;
+    }
+    if (p_seg->read || (p_seg->len < 2U))
+    {
+        driver_count(&p_prof->drivers[DRIVER_UNKNOWN], 1U, bytes, busy);
+        return;
+    }
+
+    base   = p_seg->data[0];
+    offset = p_seg->data[1];
+
+    switch (base)
+    {
+        case 0x00U: /* MAIN events and interrupt enables */
+        case 0x06U: /* GPIO interrupt output */
+            fn = DRIVER_EVENTS;
+            break;
+
+        case 0x05U: /* ADC tasks up to TASK_VBUS, results from IBAT_STAT */
+            if ((!read && (offset <= 0x07U)) || (read && (offset >= 0x10U) && (offset < 0x24U)))
+            {
+                p_prof->burst_adc      = true;
+                p_prof->burst_results |= read;
+                fn = DRIVER_FETCH;
+            }
+            else
+            {
+                fn = p_prof->fetched ? DRIVER_SETTER : DRIVER_INIT;
+            }
+            break;
+
+        case 0x02U: /* VBUS status from 0x07, ILIM and TASK_UPDATE below */
+        case 0x03U: /* CHGR status from CHG_STAT */
+            if (read && (offset >= ((base == 0x02U) ? 0x07U : 0x34U)))
+            {
+                driver_count(&p_prof->burst_status, 1U, bytes, busy);
+                return;
+            }
+            fn = p_prof->fetched ? DRIVER_SETTER : DRIVER_INIT;
+            break;
+
+        case 0x04U: /* BUCK and LDSW are only set up by init */
+        case 0x08U:
+            fn = DRIVER_INIT;
+            break;
+
+        default:
+            fn = DRIVER_UNKNOWN;
+            break;
+    }
+
+    driver_count(&p_prof->drivers[fn], 1U, bytes, busy);
+}
+
+static void gap_add(profile_t * p_prof, double gap_us)
+{
+    uint32_t bucket = 0;
+
+    for (double limit = 10.0; (gap_us >= limit) && (bucket < GAP_BUCKETS - 1U); limit *= 10.0)
+    {
+        bucket++;
+    }
+
+    p_prof->gap_hist[bucket]++;
+    p_prof->gap_sum_us += gap_us;
+    p_prof->gap_min_us  = (p_prof->gaps == 0) || (gap_us < p_prof->gap_min_us) ?
+                          gap_us : p_prof->gap_min_us;
+    p_prof->gap_max_us  = (gap_us > p_prof->gap_max_us) ? gap_us : p_prof->gap_max_us;
+    p_prof->gaps++;
+
+    /* Transactions closer than the burst gap belong to the same driver operation */
+    if (gap_us < p_prof->burst_gap_us)
+    {
+        p_prof->burst_len++;
+    }
+    else
+    {
+        burst_end(p_prof);
+        p_prof->bursts++;
+        p_prof->burst_len = 1;
+    }
+
+    if (p_prof->burst_len > p_prof->burst_len_max)
+    {
+        p_prof->burst_len_max = p_prof->burst_len;
+    }
+}
+
+static void transaction_end(profile_t * p_prof)
+{
+    transaction_t const * p_tr  = &p_prof->current;
+    uint64_t              busy  = p_tr->stop - p_tr->start;
+    uint64_t              bytes = 0;
+    double                gap_us = 0.0;
+    char                  key[40];
+    char                  text[160];
+    bool                  nack = false;
+
+    if (p_tr->count == 0)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < p_tr->count; i++)
+    {
+        bytes += 1U + p_tr->segments[i].len;
+        nack  |= p_tr->segments[i].nack;
+    }
+
+    if (p_prof->have_last)
+    {
+        gap_us = to_us(p_prof, p_tr->start - p_prof->last_stop);
+        gap_add(p_prof, gap_us);
+    }
+    else
+    {
+        p_prof->bursts    = 1;
+        p_prof->burst_len = 1;
+        p_prof->burst_len_max = 1;
+    }
+
+    p_prof->have_last = true;
+    p_prof->last_stop = p_tr->stop;
+
+    p_prof->transactions++;
+    p_prof->bytes += bytes;
+    p_prof->busy  += busy;
+    p_prof->nacks += nack ? 1U : 0U;
+    p_prof->foreign += (p_tr->segments[0].address != p_prof->address) ? 1U : 0U;
+
+    transaction_describe(p_prof, p_tr, key, sizeof(key), text, sizeof(text));
+    function_count(p_prof, key, bytes, busy);
+    driver_classify(p_prof, p_tr, bytes, busy);
+
+    if (p_prof->verbose)
+    {
+        printf("%14.6f s %9.1f us %12.1f us  %s%s\n",
+               (double)p_tr->start / p_prof->samplerate, to_us(p_prof, busy), gap_us, text,
+               nack ? "  NACK" : "");
+    }
+}
+
+static void i2c_evt_handler(i2c_evt_t const * p_evt, void * p_context)
+{
+    profile_t     * p_prof = (profile_t *)p_context;
+    transaction_t * p_tr   = &p_prof->current;
+    segment_t     * p_seg;
+
+    switch (p_evt->type)
+    {
+        case I2C_EVT_START:
+            memset(p_tr, 0, sizeof(*p_tr));
+            p_tr->start    = p_evt->sample;
+            p_prof->active = true;
+            break;
+
+        case I2C_EVT_RESTART:
+            if (p_prof->active && (p_tr->count == SEGMENTS_MAX))
+            {
+                p_prof->active = false;
+            }
+            break;
+
+        case I2C_EVT_BYTE:
+            if (!p_prof->active)
+            {
+                break;
+            }
+
+            p_prof->bit_samples += p_evt->end - p_evt->sample;
+            p_prof->bit_bytes++;
+
+            /* The first byte after a (repeated) start opens a segment */
+            if ((p_tr->count == 0) || (p_tr->segments[p_tr->count - 1U].address == 0xFFU))
+            {
+                if (p_tr->count == 0)
+                {
+                    p_tr->count = 1;
+                }
+                p_seg = &p_tr->segments[p_tr->count - 1U];
+                p_seg->address = p_evt->byte >> 1;
+                p_seg->read    = (p_evt->byte & 1U) != 0U;
+                p_seg->nack    = !p_evt->ack;
+                break;
+            }
+
+            p_seg = &p_tr->segments[p_tr->count - 1U];
+            if (p_seg->len < SEGMENT_DATA_MAX)
+            {
+                p_seg->data[p_seg->len] = p_evt->byte;
+            }
+            p_seg->len  += (p_seg->len < UINT8_MAX) ? 1U : 0U;
+            /* A NACK on the last byte of a read is the normal end of the read */
+            p_seg->nack |= !p_evt->ack && !p_seg->read;
+            break;
+
+        case I2C_EVT_STOP:
+            if (p_prof->active)
+            {
+                p_tr->stop = p_evt->sample;
+                transaction_end(p_prof);
+            }
+            p_prof->active = false;
+            break;
+    }
+
+    /* Mark the segment a repeated start opens, its address byte comes next */
+    if ((p_evt->type == I2C_EVT_RESTART) && p_prof->active && (p_tr->count != 0))
+    {
+        p_tr->segments[p_tr->count].address = 0xFFU;
+        p_tr->count++;
+    }
+}
+
+/* Value of "key = value" in the [header] section, or NULL. */
+static const char * header_get(const char * p_header, const char * p_key, char * p_buf, size_t size)
+{
+    size_t       key_len = strlen(p_key);
+    const char * p_line  = p_header;
+
+    while ((p_line != NULL) && (*p_line != '\0'))
+    {
+        if ((strncmp(p_line, p_key, key_len) == 0) && (p_line[key_len] == ' ' || p_line[key_len] == '='))
+        {
+            const char * p_val = strchr(p_line, '=');
+            size_t       len   = 0;
+
+            if (p_val == NULL)
+            {
+                return NULL;
+            }
+
+            p_val++;
+            while (*p_val == ' ')
+            {
+                p_val++;
+            }
+            while ((p_val[len] != '\0') && (p_val[len] != '\n') && (p_val[len] != '\r') &&
+                   (len + 1U < size))
+            {
+                len++;
+            }
+
+            memcpy(p_buf, p_val, len);
+            p_buf[len] = '\0';
+            return p_buf;
+        }
+
+        p_line = strchr(p_line, '\n');
+        p_line = (p_line != NULL) ? p_line + 1 : NULL;
+    }
+
+    return NULL;
+}
+
+static double samplerate_parse(const char * p_value)
+{
+    char * p_unit;
+    double rate = strtod(p_value, &p_unit);
+
+    while (*p_unit == ' ')
+    {
+        p_unit++;
+    }
+
+    switch (toupper((unsigned char)*p_unit))
+    {
+        case 'K':
+            return rate * 1e3;
+        case 'M':
+            return rate * 1e6;
+        case 'G':
+            return rate * 1e9;
+        default:
+            return rate;
+    }
+}
+
+static int probe_find(const char * p_header, const char * p_name, unsigned probes)
+{
+    char key[16];
+    char value[32];
+
+    for (unsigned i = 0; i < probes; i++)
+    {
+        snprintf(key, sizeof(key), "probe%u", i);
+        if ((header_get(p_header, key, value, sizeof(value)) != NULL) &&
+            (strcasecmp(value, p_name) == 0))
+        {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+static int block_decode(zip_archive_t const * p_zip, i2c_decoder_t * p_dec, int scl_probe,
+                        int sda_probe, unsigned block, uint64_t sample_end)
+{
+    static uint8_t scl[CHUNK_SIZE];
+    static uint8_t sda[CHUNK_SIZE];
+    static zip_member_t scl_member;
+    static zip_member_t sda_member;
+    zip_entry_t const * p_scl;
+    zip_entry_t const * p_sda;
+    char name[32];
+    int  err = 0;
+
+    snprintf(name, sizeof(name), "L-%d/%u", scl_probe, block);
+    p_scl = zip_entry_find(p_zip, name);
+    snprintf(name, sizeof(name), "L-%d/%u", sda_probe, block);
+    p_sda = zip_entry_find(p_zip, name);
+
+    if ((p_scl == NULL) || (p_sda == NULL) || (p_scl->size != p_sda->size))
+    {
+        fprintf(stderr, "block %u missing or inconsistent\n", block);
+        return -1;
+    }
+
+    if (zip_member_open(&scl_member, p_zip, p_scl) != 0)
+    {
+        return -1;
+    }
+    if (zip_member_open(&sda_member, p_zip, p_sda) != 0)
+    {
+        zip_member_close(&scl_member);
+        return -1;
+    }
+
+    for (;;)
+    {
+        long scl_len = zip_member_read(&scl_member, scl, sizeof(scl));
+        long sda_len = zip_member_read(&sda_member, sda, sizeof(sda));
+        size_t len;
+
+        if ((scl_len < 0) || (scl_len != sda_len))
+        {
+            fprintf(stderr, "block %u corrupt\n", block);
+            err = -1;
+            break;
+        }
+
+        /* The last block is padded beyond the sample count */
+        len = (size_t)scl_len;
+        if (p_dec->sample + (uint64_t)len * 8U > sample_end)
+        {
+            len = (size_t)((sample_end - p_dec->sample + 7U) / 8U);
+        }
+
+        if (len == 0)
+        {
+            break;
+        }
+
+        i2c_decoder_feed(p_dec, scl, sda, len);
+    }
+
+    zip_member_close(&sda_member);
+    zip_member_close(&scl_member);
+
+    return err;
+}
+
+static int function_compare(const void * p_a, const void * p_b)
+{
+    function_t const * p_fa = p_a;
+    function_t const * p_fb = p_b;
+
+    if (p_fa->count != p_fb->count)
+    {
+        return (p_fa->count < p_fb->count) ? 1 : -1;
+    }
+
+    return strcmp(p_fa->key, p_fb->key);
+}
+
+static void report(profile_t * p_prof, uint64_t samples)
+{
+    static const char * const gap_labels[GAP_BUCKETS] =
+    {
+        "< 10 us", "< 100 us", "< 1 ms", "< 10 ms", "< 100 ms", "< 1 s", ">= 1 s",
+    };
+    double duration_s = (double)samples / p_prof->samplerate;
+    double busy_s     = (double)p_prof->busy / p_prof->samplerate;
+
+    printf("\ncapture             %.3f s at %.0f Hz\n", duration_s, p_prof->samplerate);
+    printf("transactions        %" PRIu32 " (%" PRIu32 " NACKed, %" PRIu32 " to other addresses)\n",
+           p_prof->transactions, p_prof->nacks, p_prof->foreign);
+    printf("bytes               %" PRIu64 "\n", p_prof->bytes);
+    if (p_prof->bit_bytes != 0)
+    {
+        /* First rising to last falling SCL edge of a byte is 8.5 clock periods */
+        printf("SCL clock           %.0f Hz\n",
+               p_prof->samplerate * 8.5 * (double)p_prof->bit_bytes / (double)p_prof->bit_samples);
+    }
+    printf("bus busy            %.3f ms (%.4f %% utilization)\n", busy_s * 1e3,
+           (duration_s > 0.0) ? busy_s * 100.0 / duration_s : 0.0);
+    if (p_prof->transactions != 0)
+    {
+        printf("transaction time    %.1f us mean\n", busy_s * 1e6 / p_prof->transactions);
+    }
+    if (p_prof->gaps != 0)
+    {
+        printf("gaps                %.1f us min, %.1f us mean, %.1f us max\n", p_prof->gap_min_us,
+               p_prof->gap_sum_us / p_prof->gaps, p_prof->gap_max_us);
+        for (uint32_t i = 0; i < GAP_BUCKETS; i++)
+        {
+            printf("  %-10s %10" PRIu32 "\n", gap_labels[i], p_prof->gap_hist[i]);
+        }
+    }
+    if (p_prof->bursts != 0)
+    {
+        printf("bursts              %" PRIu32 " (gap >= %.0f us), %.2f transactions mean, %" PRIu32
+               " max\n", p_prof->bursts, p_prof->burst_gap_us,
+               (double)p_prof->transactions / p_prof->bursts, p_prof->burst_len_max);
+    }
+
+    burst_end(p_prof);
+
+    printf("\n%-32s %10s %10s %12s\n", "driver function", "count", "bytes", "busy_us");
+    for (uint32_t i = 0; i < DRIVER_COUNT; i++)
+    {
+        driver_stats_t const * p_drv = &p_prof->drivers[i];
+
+        if (p_drv->count != 0)
+        {
+            printf("%-32s %10" PRIu32 " %10" PRIu64 " %12.1f\n", m_driver_names[i], p_drv->count,
+                   p_drv->bytes, to_us(p_prof, p_drv->busy));
+        }
+    }
+
+    qsort(p_prof->functions, p_prof->function_count, sizeof(function_t), function_compare);
+
+    printf("\n%-32s %10s %10s %12s\n", "access", "count", "bytes", "busy_us");
+    for (size_t i = 0; i < p_prof->function_count; i++)
+    {
+        function_t const * p_fn = &p_prof->functions[i];
+
+        printf("%-32s %10" PRIu32 " %10" PRIu64 " %12.1f\n", p_fn->key, p_fn->count, p_fn->bytes,
+               to_us(p_prof, p_fn->busy));
+    }
+}
+
+static void usage(const char * p_name)
+{
+    fprintf(stderr,
+            "usage: %s [-v] [-m] [-a address] [-g gap_us] [-n blocks] capture.dsl\n"
+            "  -v  list every transaction\n"
+            "  -m  sample bytes are MSB first (default LSB first)\n"
+            "  -a  7-bit nPM1300 address (default 0x%02X)\n"
+            "  -g  minimum gap between bursts of transactions (default 1000)\n"
+            "  -n  decode only the first blocks\n",
+            p_name, NPM1300_ADDR_DEFAULT);
+}
+
+int main(int argc, char * argv[])
+{
+    static profile_t prof;
+    zip_archive_t    zip;
+    zip_entry_t const * p_entry;
+    i2c_decoder_t    dec;
+    char           * p_header;
+    char             value[64];
+    unsigned         blocks;
+    unsigned         probes;
+    uint64_t         samples;
+    bool             lsb_first = true;
+    int              scl_probe;
+    int              sda_probe;
+    int              opt;
+    int              err = 0;
+
+    prof.address      = NPM1300_ADDR_DEFAULT;
+    prof.burst_gap_us = 1000.0;
+    blocks            = UINT32_MAX;
+
+    while ((opt = getopt(argc, argv, "vma:g:n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'v':
+                prof.verbose = true;
+                break;
+            case 'm':
+                lsb_first = false;
+                break;
+            case 'a':
+                prof.address = (uint8_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'g':
+                prof.burst_gap_us = atof(optarg);
+                break;
+            case 'n':
+                blocks = (unsigned)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (zip_archive_open(&zip, argv[optind]) != 0)
+    {
+        fprintf(stderr, "%s: not a zip archive\n", argv[optind]);
+        return 1;
+    }
+
+    p_entry  = zip_entry_find(&zip, "header");
+    p_header = (p_entry != NULL) ? zip_entry_load(&zip, p_entry) : NULL;
+    if ((p_header == NULL) ||
+        (header_get(p_header, "samplerate", value, sizeof(value)) == NULL))
+    {
+        fprintf(stderr, "%s: no DSLogic header\n", argv[optind]);
+        zip_archive_close(&zip);
+        return 1;
+    }
+
+    prof.samplerate = samplerate_parse(value);
+    samples = strtoull(header_get(p_header, "total samples", value, sizeof(value)) ? value : "0",
+                       NULL, 0);
+    probes  = (unsigned)strtoul(header_get(p_header, "total probes", value, sizeof(value)) ?
+                                value : "0", NULL, 0);
+    if (header_get(p_header, "total blocks", value, sizeof(value)) != NULL)
+    {
+        unsigned total = (unsigned)strtoul(value, NULL, 0);
+
+        blocks = (blocks < total) ? blocks : total;
+    }
+
+    scl_probe = probe_find(p_header, "SCL", probes);
+    sda_probe = probe_find(p_header, "SDA", probes);
+    free(p_header);
+
+    if ((prof.samplerate <= 0.0) || (scl_probe < 0) || (sda_probe < 0))
+    {
+        fprintf(stderr, "%s: capture needs probes named SCL and SDA\n", argv[optind]);
+        zip_archive_close(&zip);
+        return 1;
+    }
+
+    i2c_decoder_init(&dec, lsb_first, i2c_evt_handler, &prof);
+
+    for (unsigned block = 0; (block < blocks) && (dec.sample < samples); block++)
+    {
+        err = block_decode(&zip, &dec, scl_probe, sda_probe, block, samples);
+        if (err != 0)
+        {
+            break;
+        }
+    }
+
+    report(&prof, (dec.sample < samples) ? dec.sample : samples);
+    zip_archive_close(&zip);
+
+    return (err == 0) ? 0 : 1;
+}
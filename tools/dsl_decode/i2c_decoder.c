@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "i2c_decoder.h"
+
+#define BITS_PER_FRAME 9U
+
+static void evt_send(i2c_decoder_t * p_dec, i2c_evt_type_t type, uint64_t sample)
+{
+    i2c_evt_t evt =
+    {
+        .type   = type,
+        .sample = sample,
+    };
+
+    p_dec->handler(&evt, p_dec->p_context);
+}
+
+static void sample_process(i2c_decoder_t * p_dec, uint8_t scl, uint8_t sda)
+{
+    uint64_t t = p_dec->sample;
+
+    if ((scl != p_dec->scl) && scl)
+    {
+        /* SCL rising: data bit */
+        if (p_dec->in_frame)
+        {
+            if (p_dec->bit_count == 0)
+            {
+                p_dec->byte_start = t;
+            }
+
+            p_dec->shift = (uint16_t)((p_dec->shift << 1) | sda);
+            p_dec->bit_count++;
+        }
+    }
+    else if ((scl != p_dec->scl) && !scl)
+    {
+        /* SCL falling: the acknowledge bit completes the frame */
+        if (p_dec->in_frame && (p_dec->bit_count == BITS_PER_FRAME))
+        {
+            i2c_evt_t evt =
+            {
+                .type   = I2C_EVT_BYTE,
+                .sample = p_dec->byte_start,
+                .end    = t,
+                .byte   = (uint8_t)(p_dec->shift >> 1),
+                .ack    = (p_dec->shift & 1U) == 0U,
+            };
+
+            p_dec->bit_count = 0;
+            p_dec->shift     = 0;
+            p_dec->handler(&evt, p_dec->p_context);
+        }
+    }
+    else if (scl && p_dec->scl && (sda != p_dec->sda))
+    {
+        /* SDA changing while SCL is high: START or STOP */
+        if (!sda)
+        {
+            evt_send(p_dec, p_dec->in_frame ? I2C_EVT_RESTART : I2C_EVT_START, t);
+            p_dec->in_frame = true;
+        }
+        else if (p_dec->in_frame)
+        {
+            evt_send(p_dec, I2C_EVT_STOP, t);
+            p_dec->in_frame = false;
+        }
+
+        p_dec->bit_count = 0;
+        p_dec->shift     = 0;
+    }
+
+    p_dec->scl = scl;
+    p_dec->sda = sda;
+    p_dec->sample++;
+}
+
+void i2c_decoder_init(i2c_decoder_t * p_dec, bool lsb_first, i2c_evt_handler_t handler,
+                      void * p_context)
+{
+    memset(p_dec, 0, sizeof(*p_dec));
+
+    p_dec->handler   = handler;
+    p_dec->p_context = p_context;
+    p_dec->lsb_first = lsb_first;
+    p_dec->scl       = 1U;
+    p_dec->sda       = 1U;
+}
+
+void i2c_decoder_feed(i2c_decoder_t * p_dec, uint8_t const * p_scl, uint8_t const * p_sda,
+                      size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t scl = p_scl[i];
+        uint8_t sda = p_sda[i];
+
+        /* Most of a capture is an idle or held bus: skip bytes in which no line changes. */
+        if ((scl == (uint8_t)(0U - p_dec->scl)) && (sda == (uint8_t)(0U - p_dec->sda)))
+        {
+            p_dec->sample += 8U;
+            continue;
+        }
+
+        for (uint8_t bit = 0; bit < 8U; bit++)
+        {
+            uint8_t shift = p_dec->lsb_first ? bit : (uint8_t)(7U - bit);
+
+            sample_process(p_dec, (scl >> shift) & 1U, (sda >> shift) & 1U);
+        }
+    }
+}
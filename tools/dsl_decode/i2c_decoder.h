@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* I2C bus decoder working on packed 1-bit sample streams of SCL and SDA. */
+
+#ifndef I2C_DECODER_H__
+#define I2C_DECODER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+    I2C_EVT_START,
+    I2C_EVT_RESTART,
+    I2C_EVT_BYTE,   /**< Eight data bits and the acknowledge bit. */
+    I2C_EVT_STOP,
+} i2c_evt_type_t;
+
+typedef struct
+{
+    i2c_evt_type_t type;
+    uint64_t       sample; /**< START/STOP: SDA edge. BYTE: SCL rising edge of the first bit. */
+    uint64_t       end;    /**< BYTE: SCL falling edge after the acknowledge bit. */
+    uint8_t        byte;
+    bool           ack;
+} i2c_evt_t;
+
+typedef void (*i2c_evt_handler_t)(i2c_evt_t const * p_evt, void * p_context);
+
+typedef struct
+{
+    i2c_evt_handler_t handler;
+    void            * p_context;
+    uint64_t          sample;    /**< Index of the next sample. */
+    uint8_t           scl;
+    uint8_t           sda;
+    bool              in_frame;  /**< Between START and STOP. */
+    uint8_t           bit_count;
+    uint16_t          shift;
+    uint64_t          byte_start;
+    bool              lsb_first; /**< Bit order of the sample bytes. */
+} i2c_decoder_t;
+
+/* Both lines are assumed high (idle) before the first sample. */
+void i2c_decoder_init(i2c_decoder_t * p_dec, bool lsb_first, i2c_evt_handler_t handler,
+                      void * p_context);
+
+/* Decode len bytes of each line, 8 samples per byte. */
+void i2c_decoder_feed(i2c_decoder_t * p_dec, uint8_t const * p_scl, uint8_t const * p_sda,
+                      size_t len);
+
+#endif // I2C_DECODER_H__
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "zip_stream.h"
+
+#define EOCD_SIGNATURE       0x06054b50UL
+#define CDIR_SIGNATURE       0x02014b50UL
+#define LOCAL_SIGNATURE      0x04034b50UL
+#define EOCD_SIZE            22U
+#define EOCD_SEARCH_MAX      (EOCD_SIZE + 0xFFFFU)
+#define CDIR_HEADER_SIZE     46U
+#define LOCAL_HEADER_SIZE    30U
+
+#define METHOD_STORED        0U
+#define METHOD_DEFLATED      8U
+
+static uint16_t get_le16(uint8_t const * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Find the end of central directory record, which is followed only by the archive comment. */
+static int eocd_find(FILE * p_file, uint8_t * p_eocd)
+{
+    long     size;
+    long     search;
+    uint8_t * p_tail;
+
+    if (fseek(p_file, 0, SEEK_END) != 0)
+    {
+        return -1;
+    }
+
+    size   = ftell(p_file);
+    search = (size < (long)EOCD_SEARCH_MAX) ? size : (long)EOCD_SEARCH_MAX;
+    if (search < (long)EOCD_SIZE)
+    {
+        return -1;
+    }
+
+    p_tail = malloc((size_t)search);
+    if ((p_tail == NULL) ||
+        (fseek(p_file, size - search, SEEK_SET) != 0) ||
+        (fread(p_tail, 1, (size_t)search, p_file) != (size_t)search))
+    {
+        free(p_tail);
+        return -1;
+    }
+
+    for (long i = search - (long)EOCD_SIZE; i >= 0; i--)
+    {
+        if (get_le32(&p_tail[i]) == EOCD_SIGNATURE)
+        {
+            memcpy(p_eocd, &p_tail[i], EOCD_SIZE);
+            free(p_tail);
+            return 0;
+        }
+    }
+
+    free(p_tail);
+    return -1;
+}
+
+int zip_archive_open(zip_archive_t * p_zip, const char * p_path)
+{
+    uint8_t   eocd[EOCD_SIZE];
+    uint8_t * p_cdir = NULL;
+    uint32_t  cdir_size;
+    uint32_t  pos = 0;
+    FILE    * p_file;
+
+    memset(p_zip, 0, sizeof(*p_zip));
+    p_zip->p_path = p_path;
+
+    p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+    {
+        return -1;
+    }
+
+    if (eocd_find(p_file, eocd) != 0)
+    {
+        fclose(p_file);
+        return -1;
+    }
+
+    p_zip->count = get_le16(&eocd[10]);
+    cdir_size    = get_le32(&eocd[12]);
+
+    p_cdir          = malloc(cdir_size);
+    p_zip->p_entries = calloc(p_zip->count, sizeof(zip_entry_t));
+    if ((p_cdir == NULL) || (p_zip->p_entries == NULL) ||
+        (fseek(p_file, (long)get_le32(&eocd[16]), SEEK_SET) != 0) ||
+        (fread(p_cdir, 1, cdir_size, p_file) != cdir_size))
+    {
+        goto error;
+    }
+
+    for (size_t i = 0; i < p_zip->count; i++)
+    {
+        zip_entry_t * p_entry = &p_zip->p_entries[i];
+        uint16_t      name_len;
+
+        if ((pos + CDIR_HEADER_SIZE > cdir_size) || (get_le32(&p_cdir[pos]) != CDIR_SIGNATURE))
+        {
+            goto error;
+        }
+
+        name_len = get_le16(&p_cdir[pos + 28]);
+        if (pos + CDIR_HEADER_SIZE + name_len > cdir_size)
+        {
+            goto error;
+        }
+
+        p_entry->method              = get_le16(&p_cdir[pos + 10]);
+        p_entry->compressed_size     = get_le32(&p_cdir[pos + 20]);
+        p_entry->size                = get_le32(&p_cdir[pos + 24]);
+        p_entry->local_header_offset = get_le32(&p_cdir[pos + 42]);
+        p_entry->p_name              = calloc(1, name_len + 1U);
+        if (p_entry->p_name == NULL)
+        {
+            goto error;
+        }
+        memcpy(p_entry->p_name, &p_cdir[pos + CDIR_HEADER_SIZE], name_len);
+
+        pos += CDIR_HEADER_SIZE + name_len + get_le16(&p_cdir[pos + 30]) +
+               get_le16(&p_cdir[pos + 32]);
+    }
+
+    free(p_cdir);
+    fclose(p_file);
+    return 0;
+
+error:
+    free(p_cdir);
+    fclose(p_file);
+    zip_archive_close(p_zip);
+    return -1;
+}
+
+void zip_archive_close(zip_archive_t * p_zip)
+{
+    if (p_zip->p_entries != NULL)
+    {
+        for (size_t i = 0; i < p_zip->count; i++)
+        {
+            free(p_zip->p_entries[i].p_name);
+        }
+    }
+
+    free(p_zip->p_entries);
+    p_zip->p_entries = NULL;
+    p_zip->count     = 0;
+}
+
+zip_entry_t const * zip_entry_find(zip_archive_t const * p_zip, const char * p_name)
+{
+    for (size_t i = 0; i < p_zip->count; i++)
+    {
+        if (strcmp(p_zip->p_entries[i].p_name, p_name) == 0)
+        {
+            return &p_zip->p_entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+char * zip_entry_load(zip_archive_t const * p_zip, zip_entry_t const * p_entry)
+{
+    zip_member_t * p_member = malloc(sizeof(zip_member_t));
+    char         * p_buf    = malloc(p_entry->size + 1U);
+    long           len      = -1;
+
+    if ((p_member != NULL) && (p_buf != NULL) && (zip_member_open(p_member, p_zip, p_entry) == 0))
+    {
+        len = zip_member_read(p_member, (uint8_t *)p_buf, p_entry->size);
+        zip_member_close(p_member);
+    }
+
+    free(p_member);
+
+    if (len != (long)p_entry->size)
+    {
+        free(p_buf);
+        return NULL;
+    }
+
+    p_buf[len] = '\0';
+    return p_buf;
+}
+
+int zip_member_open(zip_member_t * p_member, zip_archive_t const * p_zip,
+                    zip_entry_t const * p_entry)
+{
+    uint8_t local[LOCAL_HEADER_SIZE];
+
+    if ((p_entry->method != METHOD_STORED) && (p_entry->method != METHOD_DEFLATED))
+    {
+        return -1;
+    }
+
+    memset(&p_member->zs, 0, sizeof(p_member->zs));
+    p_member->method   = p_entry->method;
+    p_member->in_left  = p_entry->compressed_size;
+    p_member->out_left = p_entry->size;
+
+    p_member->p_file = fopen(p_zip->p_path, "rb");
+    if (p_member->p_file == NULL)
+    {
+        return -1;
+    }
+
+    /* Data follows the local header, whose name and extra field lengths may differ from
+     * the central directory.
+     */
+    if ((fseek(p_member->p_file, (long)p_entry->local_header_offset, SEEK_SET) != 0) ||
+        (fread(local, 1, sizeof(local), p_member->p_file) != sizeof(local)) ||
+        (get_le32(local) != LOCAL_SIGNATURE) ||
+        (fseek(p_member->p_file, get_le16(&local[26]) + get_le16(&local[28]), SEEK_CUR) != 0))
+    {
+        fclose(p_member->p_file);
+        return -1;
+    }
+
+    if ((p_member->method == METHOD_DEFLATED) && (inflateInit2(&p_member->zs, -MAX_WBITS) != Z_OK))
+    {
+        fclose(p_member->p_file);
+        return -1;
+    }
+
+    return 0;
+}
+
+long zip_member_read(zip_member_t * p_member, uint8_t * p_buf, size_t len)
+{
+    size_t want = (len < p_member->out_left) ? len : p_member->out_left;
+
+    if (want == 0)
+    {
+        return 0;
+    }
+
+    if (p_member->method == METHOD_STORED)
+    {
+        size_t got = fread(p_buf, 1, want, p_member->p_file);
+
+        p_member->out_left -= (uint32_t)got;
+        return (got == want) ? (long)got : -1;
+    }
+
+    p_member->zs.next_out  = p_buf;
+    p_member->zs.avail_out = (uInt)want;
+
+    while (p_member->zs.avail_out != 0)
+    {
+        int ret;
+
+        if ((p_member->zs.avail_in == 0) && (p_member->in_left != 0))
+        {
+            size_t chunk = (p_member->in_left < sizeof(p_member->in)) ?
+                           p_member->in_left : sizeof(p_member->in);
+
+            if (fread(p_member->in, 1, chunk, p_member->p_file) != chunk)
+            {
+                return -1;
+            }
+
+            p_member->in_left    -= (uint32_t)chunk;
+            p_member->zs.next_in  = p_member->in;
+            p_member->zs.avail_in = (uInt)chunk;
+        }
+
+        ret = inflate(&p_member->zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END)
+        {
+            break;
+        }
+        if ((ret != Z_OK) ||
+            ((p_member->zs.avail_out != 0) && (p_member->zs.avail_in == 0) &&
+             (p_member->in_left == 0)))
+        {
+            return -1;
+        }
+    }
+
+    want -= p_member->zs.avail_out;
+    p_member->out_left -= (uint32_t)want;
+
+    return (want != 0) ? (long)want : -1;
+}
+
+void zip_member_close(zip_member_t * p_member)
+{
+    if (p_member->method == METHOD_DEFLATED)
+    {
+        inflateEnd(&p_member->zs);
+    }
+
+    fclose(p_member->p_file);
+    p_member->p_file = NULL;
+}
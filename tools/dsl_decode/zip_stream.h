@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Minimal zip reader: central directory index and streaming inflate of single members,
+ * so large archives can be processed in small chunks.
+ */
+
+#ifndef ZIP_STREAM_H__
+#define ZIP_STREAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <zlib.h>
+
+#define ZIP_STREAM_CHUNK 16384U
+
+typedef struct
+{
+    char   * p_name;
+    uint16_t method;            /**< 0 stored, 8 deflated. */
+    uint32_t compressed_size;
+    uint32_t size;
+    uint32_t local_header_offset;
+} zip_entry_t;
+
+typedef struct
+{
+    const char  * p_path;
+    zip_entry_t * p_entries;
+    size_t        count;
+} zip_archive_t;
+
+typedef struct
+{
+    FILE     * p_file;
+    z_stream   zs;
+    uint16_t   method;
+    uint32_t   in_left;  /**< Compressed bytes not read from the file yet. */
+    uint32_t   out_left; /**< Uncompressed bytes not returned yet. */
+    uint8_t    in[ZIP_STREAM_CHUNK];
+} zip_member_t;
+
+/* Read the central directory. Returns 0 on success. */
+int zip_archive_open(zip_archive_t * p_zip, const char * p_path);
+
+void zip_archive_close(zip_archive_t * p_zip);
+
+/* Entry with the given name, or NULL. */
+zip_entry_t const * zip_entry_find(zip_archive_t const * p_zip, const char * p_name);
+
+/* Read a whole (small) member into a NUL terminated buffer that the caller frees. */
+char * zip_entry_load(zip_archive_t const * p_zip, zip_entry_t const * p_entry);
+
+/* Start streaming a member. Returns 0 on success. */
+int zip_member_open(zip_member_t * p_member, zip_archive_t const * p_zip,
+                    zip_entry_t const * p_entry);
+
+/* Read up to len uncompressed bytes. Returns the number of bytes read, 0 at the end of the
+ * member and -1 on a corrupt stream.
+ */
+long zip_member_read(zip_member_t * p_member, uint8_t * p_buf, size_t len);
+
+void zip_member_close(zip_member_t * p_member);
+
+#endif // ZIP_STREAM_H__
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup gauge_backend Fuel gauge backends
+ * @{
+ * @brief Common interface over the gauge implementations the simulator can drive.
+ *
+ * @details The calls mirror the nRF Fuel Gauge API. Currents are in amperes and positive
+ *          when discharging, state of charge is in percent and times are in seconds.
+ */
+
+#ifndef GAUGE_BACKEND_H__
+#define GAUGE_BACKEND_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Gauge implementation. */
+typedef struct
+{
+    const char * name;
+    int   (* init)(float v0, float i0, float t0);
+    float (* process)(float v, float i, float T, float t_delta);
+    float (* tte_get)(void);
+    float (* ttf_get)(float i_cc, float i_term);
+    void  (* idle_set)(float v, float T, float i_avg);
+} gauge_backend_t;
+
+/** @brief Reference coulomb-counter/OCV model, see gauge_ref.h. */
+extern const gauge_backend_t gauge_backend_ref;
+
+#if GAUGE_SIM_WITH_NRF_LIB
+/** @brief libnrf_fuel_gauge.a, only where a build for the host architecture exists. */
+extern const gauge_backend_t gauge_backend_nrf;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAUGE_BACKEND_H__
+
+/** @} */
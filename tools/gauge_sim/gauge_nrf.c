@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Backend calling libnrf_fuel_gauge.a. Only built with GAUGE_SIM_WITH_NRF_LIB, as the
+ * archive in npm1300_lib/lib holds Cortex-M builds only.
+ */
+
+#if GAUGE_SIM_WITH_NRF_LIB
+
+#include <stddef.h>
+#include "nrf_fuel_gauge.h"
+#include "gauge_backend.h"
+
+static const struct battery_model battery_model = {
+#include "battery_model.inc"
+};
+
+static int nrf_init(float v0, float i0, float t0)
+{
+    struct nrf_fuel_gauge_init_parameters parameters = {
+        .v0 = v0,
+        .i0 = i0,
+        .t0 = t0,
+        .model = &battery_model,
+    };
+
+    return nrf_fuel_gauge_init(&parameters, NULL);
+}
+
+static float nrf_process(float v, float i, float T, float t_delta)
+{
+    return nrf_fuel_gauge_process(v, i, T, t_delta, NULL);
+}
+
+const gauge_backend_t gauge_backend_nrf = {
+    .name     = "nrf",
+    .init     = nrf_init,
+    .process  = nrf_process,
+    .tte_get  = nrf_fuel_gauge_tte_get,
+    .ttf_get  = nrf_fuel_gauge_ttf_get,
+    .idle_set = nrf_fuel_gauge_idle_set,
+};
+
+#endif // GAUGE_SIM_WITH_NRF_LIB
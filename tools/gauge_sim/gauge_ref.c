@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include "gauge_ref.h"
+#include "gauge_backend.h"
+#include "li_ion_ocv.h"
+
+/* Share of the capacity charged at constant current, the rest tapers off at constant voltage */
+#define CC_SHARE 0.8f
+
+static gauge_ref_config_t config = GAUGE_REF_CONFIG_DEFAULT;
+
+static struct {
+    float soc;
+    float i_avg;
+    bool  idle;
+    float idle_current;
+} state;
+
+void gauge_ref_configure(gauge_ref_config_t const *p_config)
+{
+    config = *p_config;
+}
+
+int gauge_ref_init(float v0, float i0, float t0)
+{
+    (void)t0;
+
+    if (config.capacity_ah <= 0.f) {
+        return -22;
+    }
+
+    state.soc = li_ion_soc_get(v0 + (i0 * config.r0));
+    state.i_avg = i0;
+    state.idle = false;
+
+    return 0;
+}
+
+float gauge_ref_process(float v, float i, float T, float t_delta)
+{
+    float i_int = i;
+
+    (void)T;
+
+    /* Charge drawn over an idle gap is the declared idle current, not the new sample */
+    if (state.idle) {
+        i_int = state.idle_current;
+        state.idle = false;
+    }
+
+    state.soc -= (i_int * t_delta / 3600.f) / config.capacity_ah;
+
+    if (fabsf(i) <= config.i_rest) {
+        float soc_ocv = li_ion_soc_get(v + (i * config.r0));
+        float gain = 1.f - expf(-t_delta / config.tau_rest);
+
+        state.soc += gain * (soc_ocv - state.soc);
+    }
+
+    state.soc = fminf(fmaxf(state.soc, 0.f), 1.f);
+
+    /* Smoothed current for the time predictions */
+    state.i_avg += (i - state.i_avg) * (1.f - expf(-t_delta / 60.f));
+
+    return state.soc * 100.f;
+}
+
+float gauge_ref_tte_get(void)
+{
+    if (state.i_avg <= 0.f) {
+        return NAN;
+    }
+
+    return (state.soc * config.capacity_ah * 3600.f) / state.i_avg;
+}
+
+float gauge_ref_ttf_get(float i_cc, float i_term)
+{
+    float t_cc;
+    float t_cv;
+    float tau;
+
+    if ((state.i_avg >= 0.f) || (i_cc >= 0.f) || (i_term >= 0.f) || (i_term <= i_cc)) {
+        return NAN;
+    }
+
+    /* Constant current up to CC_SHARE, then an exponential current decay down to i_term
+     * that delivers the remaining charge.
+     */
+    tau = ((1.f - CC_SHARE) * config.capacity_ah * 3600.f) / -i_cc;
+    t_cc = (state.soc < CC_SHARE) ?
+           ((CC_SHARE - state.soc) * config.capacity_ah * 3600.f) / -i_cc : 0.f;
+    t_cv = tau * logf(((state.soc < CC_SHARE) ? i_cc : fmaxf(i_cc, state.i_avg)) / i_term);
+
+    return t_cc + fmaxf(t_cv, 0.f);
+}
+
+void gauge_ref_idle_set(float v, float T, float i_avg)
+{
+    (void)v;
+    (void)T;
+
+    state.idle = true;
+    state.idle_current = i_avg;
+}
+
+const gauge_backend_t gauge_backend_ref = {
+    .name     = "ref",
+    .init     = gauge_ref_init,
+    .process  = gauge_ref_process,
+    .tte_get  = gauge_ref_tte_get,
+    .ttf_get  = gauge_ref_ttf_get,
+    .idle_set = gauge_ref_idle_set,
+};
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup gauge_ref Reference fuel gauge
+ * @{
+ * @brief Coulomb counter corrected towards the open-circuit voltage while the battery rests.
+ *
+ * @details The state of charge is integrated from the measured current. When the current
+ *          stays below the rest threshold, the voltage is close to the open-circuit voltage
+ *          and the estimate is pulled towards the state of charge read from the OCV curve,
+ *          with the time constant @ref gauge_ref_config_t::tau_rest. This gives a portable
+ *          baseline to compare sampling strategies with, it does not model the nRF Fuel
+ *          Gauge algorithm.
+ */
+
+#ifndef GAUGE_REF_H__
+#define GAUGE_REF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Model parameters. */
+typedef struct
+{
+    float capacity_ah;  /**< Nominal capacity [Ah]. */
+    float r0;           /**< Series resistance used to correct the voltage [ohm]. */
+    float i_rest;       /**< Largest current considered as rest [A]. */
+    float tau_rest;     /**< Time constant of the OCV correction at rest [s]. */
+} gauge_ref_config_t;
+
+/** @brief Default parameters, for a 100 mAh cell. */
+#define GAUGE_REF_CONFIG_DEFAULT                                               \
+    {                                                                          \
+        .capacity_ah = 0.1f,                                                   \
+        .r0          = 0.15f,                                                  \
+        .i_rest      = 0.005f,                                                 \
+        .tau_rest    = 1800.f,                                                 \
+    }
+
+/**
+ * @brief Function for setting the model parameters, before @ref gauge_ref_init.
+ */
+void gauge_ref_configure(gauge_ref_config_t const * p_config);
+
+int   gauge_ref_init(float v0, float i0, float t0);
+float gauge_ref_process(float v, float i, float T, float t_delta);
+float gauge_ref_tte_get(void);
+float gauge_ref_ttf_get(float i_cc, float i_term);
+void  gauge_ref_idle_set(float v, float T, float i_avg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAUGE_REF_H__
+
+/** @} */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* nRF Fuel Gauge API implemented with the reference gauge, for host builds of code that
+ * calls the library directly, like fuel_gauge.c in the nPM1300 emulator.
+ */
+
+#include <stddef.h>
+#include "nrf_fuel_gauge.h"
+#include "gauge_ref.h"
+
+const char *nrf_fuel_gauge_version = "ref";
+const char *nrf_fuel_gauge_build_date = __DATE__;
+
+int nrf_fuel_gauge_init(const struct nrf_fuel_gauge_init_parameters *parameters, float *v0)
+{
+    if ((parameters == NULL) || (parameters->model == NULL)) {
+        return -22;
+    }
+
+    if (v0 != NULL) {
+        *v0 = parameters->v0;
+    }
+
+    return gauge_ref_init(parameters->v0, parameters->i0, parameters->t0);
+}
+
+float nrf_fuel_gauge_process(float v, float i, float T, float t_delta,
+                             struct nrf_fuel_gauge_state_info *state)
+{
+    if (state != NULL) {
+        state->yhat = v;
+        state->r0 = 0.f;
+        state->T_truncated = T;
+    }
+
+    return gauge_ref_process(v, i, T, t_delta);
+}
+
+float nrf_fuel_gauge_tte_get(void)
+{
+    return gauge_ref_tte_get();
+}
+
+float nrf_fuel_gauge_ttf_get(float i_cc, float i_term)
+{
+    return gauge_ref_ttf_get(i_cc, i_term);
+}
+
+void nrf_fuel_gauge_idle_set(float v, float T, float i_avg)
+{
+    gauge_ref_idle_set(v, T, i_avg);
+}
+
+void nrf_fuel_gauge_param_adjust(float a, float b, float c, float d)
+{
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)d;
+}
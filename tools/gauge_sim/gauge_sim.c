@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Drives a fuel gauge backend from a simulated battery at accelerated time and reports the
+ * state of charge error against the ground truth and the CPU time of each process call,
+ * for one or more sampling periods.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gauge_backend.h"
+#include "gauge_ref.h"
+#include "li_ion_ocv.h"
+#include "sim_battery.h"
+
+#define PERIODS_MAX 16
+
+/* Charger of the nPM1300 sample configuration */
+#define CHARGE_I_CC   0.150f
+#define CHARGE_V_TERM 4.15f
+#define CHARGE_I_TERM (CHARGE_I_CC / 10.f)
+
+/* ADC full scale of the nPM1300 sample configuration, for the quantization of the samples */
+#define ADC_VBAT_FS    5.f
+#define ADC_IBAT_FS    1.f
+#define ADC_STEPS      1024.f
+
+/* Load profile: returns the discharge current at time t [s], or sets *p_charge when the
+ * charger is connected.
+ */
+typedef float (*profile_fn_t)(double t, float base, bool *p_charge);
+
+typedef struct {
+    const char *name;
+    profile_fn_t fn;
+    const char *help;
+} profile_t;
+
+typedef struct {
+    const gauge_backend_t *backend;
+    const profile_t *profile;
+    float capacity_ah;
+    float soc0;
+    float temp;
+    float base_load;
+    float idle_current;
+    double duration;
+} sim_config_t;
+
+typedef struct {
+    unsigned calls;
+    double max_err;
+    double sq_err;
+    double final_err;
+    double cpu_ns;
+    float tte_err_h;
+} sim_result_t;
+
+static float profile_constant(double t, float base, bool *p_charge)
+{
+    (void)t;
+    *p_charge = false;
+
+    return base;
+}
+
+static float profile_pulse(double t, float base, bool *p_charge)
+{
+    *p_charge = false;
+
+    /* Radio burst of 2 s every minute */
+    return (fmod(t, 60.0) < 2.0) ? base + 0.080f : base;
+}
+
+static float profile_daily(double t, float base, bool *p_charge)
+{
+    double hour = fmod(t / 3600.0, 24.0);
+    double sec = fmod(t, 30.0);
+
+    /* Charging in the evening, sleeping at night, active with short bursts during the day */
+    *p_charge = (hour >= 21.0) && (hour < 22.5);
+
+    if ((hour >= 23.0) || (hour < 7.0)) {
+        return 0.00005f;
+    }
+
+    return (sec < 1.0) ? base + 0.050f : base;
+}
+
+static const profile_t profiles[] = {
+    { "constant", profile_constant, "constant load" },
+    { "pulse", profile_pulse, "load + 80 mA for 2 s every 60 s" },
+    { "daily", profile_daily, "day: load + 50 mA 1 s bursts, night: 50 uA, charge 21:00-22:30" },
+};
+
+static float quantize(float value, float full_scale)
+{
+    float lsb = full_scale / ADC_STEPS;
+
+    return floorf(value / lsb) * lsb;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+/* Current into the battery while the charger is connected: constant current, then constant
+ * voltage, and nothing once the current falls below termination. The load runs from VBUS.
+ */
+static float charge_current_get(sim_battery_t const *p_bat)
+{
+    float r0 = sim_battery_r0_get(p_bat);
+    float i = -fminf(CHARGE_I_CC, fmaxf((CHARGE_V_TERM - li_ion_ocv_get(p_bat->soc) - p_bat->v_rc) / r0, 0.f));
+
+    return (-i < CHARGE_I_TERM) ? 0.f : i;
+}
+
+static void run(sim_config_t const *p_cfg, double period, sim_result_t *p_res)
+{
+    gauge_ref_config_t ref_config = GAUGE_REF_CONFIG_DEFAULT;
+    sim_battery_t bat;
+    double t = 0.0;
+    double next_sample = period;
+    double dt = fmin(1.0, period);
+    bool charge;
+    float i;
+
+    memset(p_res, 0, sizeof(*p_res));
+    sim_battery_init(&bat, p_cfg->capacity_ah, p_cfg->soc0, p_cfg->temp);
+
+    ref_config.capacity_ah = p_cfg->capacity_ah;
+    gauge_ref_configure(&ref_config);
+
+    i = p_cfg->profile->fn(0.0, p_cfg->base_load, &charge);
+    sim_battery_step(&bat, i, 0.f);
+    p_cfg->backend->init(sim_battery_voltage_get(&bat), i, p_cfg->temp);
+
+    while (t < p_cfg->duration) {
+        i = p_cfg->profile->fn(t, p_cfg->base_load, &charge);
+        if (charge) {
+            i = charge_current_get(&bat);
+        }
+
+        sim_battery_step(&bat, i, (float)dt);
+        t += dt;
+
+        if (t + 1e-9 < next_sample) {
+            continue;
+        }
+        next_sample += period;
+
+        /* Sample as the nPM1300 ADC would */
+        float v = quantize(sim_battery_voltage_get(&bat), ADC_VBAT_FS);
+        float i_meas = copysignf(quantize(fabsf(i), (i < 0.f) ? CHARGE_I_CC : ADC_IBAT_FS), i);
+        float temp = roundf(p_cfg->temp * 10.f) / 10.f;
+
+        double start = now_ns();
+        float soc = p_cfg->backend->process(v, i_meas, temp, (float)period);
+        p_res->cpu_ns += now_ns() - start;
+        p_res->calls++;
+
+        if ((p_cfg->idle_current > 0.f) && (fabsf(i_meas) <= (ADC_IBAT_FS / ADC_STEPS))) {
+            p_cfg->backend->idle_set(v, temp, p_cfg->idle_current);
+        }
+
+        double err = soc - (bat.soc * 100.0);
+        p_res->max_err = fmax(p_res->max_err, fabs(err));
+        p_res->sq_err += err * err;
+        p_res->final_err = err;
+    }
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-b backend] [-p profile] [-s periods] [-d hours] [-c mAh]\n"
+            "          [-i mA] [-T celsius] [-S soc%%] [-I uA]\n"
+            "  -b  gauge backend: ref"
+#if GAUGE_SIM_WITH_NRF_LIB
+            ", nrf"
+#endif
+            " (default ref)\n"
+            "  -p  load profile (default pulse)\n"
+            "  -s  comma separated sampling periods in seconds (default 1,10,60)\n"
+            "  -d  simulated time (default 72)\n"
+            "  -c  battery capacity (default 100)\n"
+            "  -i  base load (default 2)\n"
+            "  -T  battery temperature (default 25)\n"
+            "  -S  initial state of charge (default 90)\n"
+            "  -I  idle current reported for samples below one ADC step, 0 = off (default 0)\n"
+            "profiles:\n",
+            name);
+
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        fprintf(stderr, "  %-10s %s\n", profiles[i].name, profiles[i].help);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    sim_config_t cfg = {
+        .backend = &gauge_backend_ref,
+        .profile = &profiles[1],
+        .capacity_ah = 0.1f,
+        .soc0 = 0.9f,
+        .temp = 25.f,
+        .base_load = 0.002f,
+        .idle_current = 0.f,
+        .duration = 72.0 * 3600.0,
+    };
+    double periods[PERIODS_MAX] = { 1.0, 10.0, 60.0 };
+    unsigned period_count = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:p:s:d:c:i:T:S:I:h")) != -1) {
+        switch (opt) {
+        case 'b':
+            if (strcmp(optarg, "ref") == 0) {
+                cfg.backend = &gauge_backend_ref;
+#if GAUGE_SIM_WITH_NRF_LIB
+            } else if (strcmp(optarg, "nrf") == 0) {
+                cfg.backend = &gauge_backend_nrf;
+#endif
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'p':
+            cfg.profile = NULL;
+            for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+                if (strcmp(optarg, profiles[i].name) == 0) {
+                    cfg.profile = &profiles[i];
+                }
+            }
+            if (cfg.profile == NULL) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 's':
+            period_count = 0;
+            for (char *tok = strtok(optarg, ","); (tok != NULL) && (period_count < PERIODS_MAX);
+                 tok = strtok(NULL, ",")) {
+                periods[period_count++] = atof(tok);
+            }
+            break;
+        case 'd':
+            cfg.duration = atof(optarg) * 3600.0;
+            break;
+        case 'c':
+            cfg.capacity_ah = (float)atof(optarg) / 1000.f;
+            break;
+        case 'i':
+            cfg.base_load = (float)atof(optarg) / 1000.f;
+            break;
+        case 'T':
+            cfg.temp = (float)atof(optarg);
+            break;
+        case 'S':
+            cfg.soc0 = (float)atof(optarg) / 100.f;
+            break;
+        case 'I':
+            cfg.idle_current = (float)atof(optarg) / 1000000.f;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    printf("backend %s, profile %s, %.0f mAh, %.1f C, %.1f h\n", cfg.backend->name,
+           cfg.profile->name, cfg.capacity_ah * 1000.f, cfg.temp, cfg.duration / 3600.0);
+    printf("%10s %10s %12s %12s %12s %10s\n", "period_s", "calls", "max_err_%", "rms_err_%",
+           "final_err_%", "ns/call");
+
+    for (unsigned p = 0; p < period_count; p++) {
+        sim_result_t res;
+
+        if (periods[p] <= 0.0) {
+            continue;
+        }
+
+        run(&cfg, periods[p], &res);
+
+        printf("%10.1f %10u %12.3f %12.3f %12.3f %10.1f\n", periods[p], res.calls, res.max_err,
+               res.calls ? sqrt(res.sq_err / res.calls) : 0.0, res.final_err,
+               res.calls ? res.cpu_ns / res.calls : 0.0);
+    }
+
+    return 0;
+}
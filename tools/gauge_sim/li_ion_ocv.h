@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Open-circuit voltage of a generic LiCoO2 cell at 25 C, shared by the simulated battery and
+ * the reference gauge. Points every 5 % state of charge.
+ */
+
+#ifndef LI_ION_OCV_H__
+#define LI_ION_OCV_H__
+
+static const float li_ion_ocv[] = {
+    3.000f, 3.300f, 3.450f, 3.530f, 3.580f, 3.610f, 3.640f, 3.660f, 3.680f, 3.700f, 3.720f,
+    3.740f, 3.770f, 3.800f, 3.840f, 3.880f, 3.920f, 3.970f, 4.020f, 4.080f, 4.180f,
+};
+
+#define LI_ION_OCV_STEP  (1.f / ((sizeof(li_ion_ocv) / sizeof(li_ion_ocv[0])) - 1U))
+
+/* State of charge [0..1] to open-circuit voltage [V]. */
+static inline float li_ion_ocv_get(float soc)
+{
+    const unsigned last = (sizeof(li_ion_ocv) / sizeof(li_ion_ocv[0])) - 1U;
+    float    pos;
+    unsigned idx;
+
+    if (soc <= 0.f) {
+        return li_ion_ocv[0];
+    }
+    if (soc >= 1.f) {
+        return li_ion_ocv[last];
+    }
+
+    pos = soc / LI_ION_OCV_STEP;
+    idx = (unsigned)pos;
+
+    return li_ion_ocv[idx] + ((pos - idx) * (li_ion_ocv[idx + 1U] - li_ion_ocv[idx]));
+}
+
+/* Open-circuit voltage [V] to state of charge [0..1]. */
+static inline float li_ion_soc_get(float ocv)
+{
+    const unsigned last = (sizeof(li_ion_ocv) / sizeof(li_ion_ocv[0])) - 1U;
+
+    if (ocv <= li_ion_ocv[0]) {
+        return 0.f;
+    }
+
+    for (unsigned idx = 0U; idx < last; idx++) {
+        if (ocv < li_ion_ocv[idx + 1U]) {
+            return (idx + ((ocv - li_ion_ocv[idx]) / (li_ion_ocv[idx + 1U] - li_ion_ocv[idx]))) *
+                   LI_ION_OCV_STEP;
+        }
+    }
+
+    return 1.f;
+}
+
+#endif // LI_ION_OCV_H__
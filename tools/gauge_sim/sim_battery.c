@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include "sim_battery.h"
+#include "li_ion_ocv.h"
+
+/* Activation temperature of the series resistance [K] */
+#define R0_ACTIVATION_K 2500.f
+
+void sim_battery_init(sim_battery_t *p_bat, float capacity_ah, float soc, float temp)
+{
+    p_bat->capacity_ah = capacity_ah;
+    p_bat->r0 = 0.15f;
+    p_bat->r1 = 0.08f;
+    p_bat->tau1 = 40.f;
+    p_bat->temp = temp;
+    p_bat->soc = soc;
+    p_bat->v_rc = 0.f;
+    p_bat->i = 0.f;
+}
+
+float sim_battery_r0_get(sim_battery_t const *p_bat)
+{
+    float t_kelvin = p_bat->temp + 273.15f;
+
+    return p_bat->r0 * expf(R0_ACTIVATION_K * ((1.f / t_kelvin) - (1.f / 298.15f)));
+}
+
+void sim_battery_step(sim_battery_t *p_bat, float i, float dt)
+{
+    float decay = expf(-dt / p_bat->tau1);
+
+    p_bat->i = i;
+    p_bat->soc -= (i * dt / 3600.f) / p_bat->capacity_ah;
+    p_bat->soc = fminf(fmaxf(p_bat->soc, 0.f), 1.f);
+
+    /* Exact solution of the RC pair for a constant current over the step */
+    p_bat->v_rc = (p_bat->v_rc * decay) + (i * p_bat->r1 * (1.f - decay));
+}
+
+float sim_battery_voltage_get(sim_battery_t const *p_bat)
+{
+    return li_ion_ocv_get(p_bat->soc) - (p_bat->i * sim_battery_r0_get(p_bat)) - p_bat->v_rc;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup sim_battery Simulated battery
+ * @{
+ * @brief Ground truth for the gauge simulator: a Thevenin cell with one RC pair.
+ *
+ * @details Terminal voltage is OCV(SoC) - i * R0(T) - v_rc, with the series resistance
+ *          rising at low temperature. The state of charge is integrated exactly from the
+ *          applied current.
+ */
+
+#ifndef SIM_BATTERY_H__
+#define SIM_BATTERY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Battery state and parameters. */
+typedef struct
+{
+    float capacity_ah; /**< Capacity [Ah]. */
+    float r0;          /**< Series resistance at 25 C [ohm]. */
+    float r1;          /**< Resistance of the RC pair [ohm]. */
+    float tau1;        /**< Time constant of the RC pair [s]. */
+    float temp;        /**< Cell temperature [C]. */
+    float soc;         /**< State of charge [0..1]. */
+    float v_rc;        /**< Voltage over the RC pair [V]. */
+    float i;           /**< Current of the last step [A], positive when discharging. */
+} sim_battery_t;
+
+/**
+ * @brief Function for setting up a battery at rest.
+ */
+void sim_battery_init(sim_battery_t * p_bat, float capacity_ah, float soc, float temp);
+
+/**
+ * @brief Function for getting the series resistance at the battery temperature.
+ */
+float sim_battery_r0_get(sim_battery_t const * p_bat);
+
+/**
+ * @brief Function for applying a current for some time.
+ *
+ * @param[in] i  Current [A], positive when discharging.
+ * @param[in] dt Duration [s].
+ */
+void sim_battery_step(sim_battery_t * p_bat, float i, float dt);
+
+/**
+ * @brief Function for getting the terminal voltage for the current of the last step.
+ */
+float sim_battery_voltage_get(sim_battery_t const * p_bat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_BATTERY_H__
+
+/** @} */
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Runs hw_sampler.c on the emulated RTC, TIMER, PPI and TWIM of the nPM1300 host emulator.
+ * The battery voltage ramps up by one step per sampling period, so every list entry tells
+ * which period it was taken in: entries must come in order, one period apart, in batches
+ * that wake the CPU once each. The ramp runs on across the tests, the first entry after a
+ * start holds the conversion triggered before the last stop.
+ */
+
+#include <stdio.h>
+#include "sdk_common.h"
+#include "twi_queue.h"
+#include "npm1300_charger.h"
+#include "hw_sampler.h"
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+#include "emu_twi.h"
+
+#define NS_PER_MS    1000000ULL
+#define PERIOD_MS    100U
+#define RAMP_START   3.0f
+#define RAMP_STEP    0.01f  /* Battery voltage step per period [V] */
+
+/* VBAT LSB is 5 V / 1023, an entry is a step away from the previous one */
+#define STEP_MIN     (RAMP_STEP * 0.5f)
+#define STEP_MAX     (RAMP_STEP * 1.5f)
+
+TWI_QUEUE_DEF(m_queue, 0);
+NPM1300_CHARGER_DEF(m_charger);
+
+static uint32_t m_failures;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(expr))                                                       \
+        {                                                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #expr);   \
+            m_failures++;                                                  \
+        }                                                                  \
+    } while (0)
+
+static struct
+{
+    float    vbat;
+    uint64_t period_ns;
+} m_ramp;
+
+/* Half a period away from the ticks, so the order of events at the same time does not matter */
+static void ramp_step(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    m_ramp.vbat += RAMP_STEP;
+    npm1300_emu_battery_set(m_ramp.vbat, 0.01f, 25.f);
+    emu_hw_event_post(m_ramp.period_ns, ramp_step, NULL);
+}
+
+/* Continue the ramp with another period. About 200 steps fit below the 5 V full scale. */
+static void ramp_start(uint32_t period_ms)
+{
+    emu_event_cancel(ramp_step, NULL);
+    m_ramp.period_ns = period_ms * NS_PER_MS;
+    emu_hw_event_post(m_ramp.period_ns / 2U, ramp_step, NULL);
+}
+
+/* Decode a batch and check it continues the ramp from last, with at most max_gap steps
+ * between entries. Returns the last voltage.
+ */
+static float batch_check(hw_sampler_batch_t const * p_batch, float last, float max_gap)
+{
+    npm1300_charger_snapshot_t snapshot;
+
+    CHECK(p_batch->count == HW_SAMPLER_BATCH);
+
+    for (uint32_t i = 0; i < p_batch->count; i++)
+    {
+        npm1300_charger_list_entry_load(&m_charger,
+                                        &p_batch->p_entries[i * NPM1300_CHARGER_LIST_ENTRY_LEN],
+                                        (int64_t)(emu_time_ns_get() / NS_PER_MS));
+        npm1300_charger_snapshot_get(&m_charger, &snapshot);
+
+        if (last > 0.f)
+        {
+            CHECK(snapshot.voltage - last > STEP_MIN);
+            CHECK(snapshot.voltage - last < max_gap);
+        }
+        last = snapshot.voltage;
+    }
+
+    return last;
+}
+
+/* Sleep until the given number of batches has been taken, checking each. */
+static float batches_run(uint32_t count, float last, float max_gap)
+{
+    hw_sampler_batch_t batch;
+
+    while (count > 0U)
+    {
+        __WFE();
+
+        if (hw_sampler_batch_take(&batch))
+        {
+            last = batch_check(&batch, last, max_gap);
+            count--;
+        }
+    }
+
+    return last;
+}
+
+/* Entries in order, one period apart, the CPU wakes up once per batch. */
+static void test_order(void)
+{
+    emu_platform_stats_t before;
+    emu_platform_stats_t after;
+    hw_sampler_stats_t   stats;
+    emu_twi_stats_t      bus;
+
+    ramp_start(PERIOD_MS);
+    CHECK(hw_sampler_start(PERIOD_MS) == NRF_SUCCESS);
+
+    emu_platform_stats_get(&before);
+    (void)batches_run(4U, 0.f, STEP_MAX);
+    emu_platform_stats_get(&after);
+
+    hw_sampler_stats_get(&stats);
+    emu_twi_stats_get(&bus);
+    CHECK(after.wakeups - before.wakeups == 4U);
+    CHECK(stats.batches == 4U);
+    CHECK(stats.overruns == 0U);
+    CHECK(bus.ppi_xfers >= 4U * HW_SAMPLER_BATCH);
+    CHECK(bus.collisions == 0U);
+
+    hw_sampler_stop();
+}
+
+/* Queue transactions in between: ticks on a busy bus are skipped, no entry is lost or split. */
+static void test_sharing(void)
+{
+    uint8_t const      reg[2] = { 0x00U, 0x00U };
+    uint8_t            value;
+    twi_queue_xfer_t   xfer   = TWI_QUEUE_READ(NPM1300_CHARGER_ADDR, reg, sizeof(reg),
+                                               &value, sizeof(value));
+    hw_sampler_batch_t batch;
+    hw_sampler_stats_t stats;
+    emu_twi_stats_t    bus;
+    uint32_t           taken  = 0U;
+    uint32_t           reads  = 0U;
+    float              last   = 0.f;
+
+    emu_twi_stats_reset();
+    ramp_start(PERIOD_MS);
+    CHECK(hw_sampler_start(PERIOD_MS) == NRF_SUCCESS);
+
+    /* A register read every 7 ms, a tick now and then finds the bus busy */
+    while (taken < 4U)
+    {
+        CHECK(twi_queue_perform(&m_queue, &xfer, 1U) == NRF_SUCCESS);
+        reads++;
+        emu_busy_wait(7U * NS_PER_MS);
+
+        if (hw_sampler_batch_take(&batch))
+        {
+            last = batch_check(&batch, last, 2.5f * RAMP_STEP);
+            taken++;
+        }
+    }
+
+    hw_sampler_stats_get(&stats);
+    emu_twi_stats_get(&bus);
+    CHECK(stats.handovers >= reads);
+    CHECK(bus.collisions == 0U);
+    CHECK(bus.transactions == bus.ppi_xfers + reads);
+
+    hw_sampler_stop();
+}
+
+/* A shorter period takes effect on the next tick, stop leaves the bus to the queue. */
+static void test_period(void)
+{
+    emu_twi_stats_t bus;
+    uint64_t        start;
+    uint64_t        elapsed;
+
+    CHECK(hw_sampler_start(5U) == NRF_ERROR_INVALID_PARAM);
+    CHECK(hw_sampler_start(600000U) == NRF_ERROR_INVALID_PARAM);
+
+    ramp_start(PERIOD_MS);
+    CHECK(hw_sampler_start(PERIOD_MS) == NRF_SUCCESS);
+    CHECK(hw_sampler_period_set(5U) == NRF_ERROR_INVALID_PARAM);
+    CHECK(hw_sampler_period_set(PERIOD_MS / 4U) == NRF_SUCCESS);
+
+    /* The first batch spans the change */
+    ramp_start(PERIOD_MS / 4U);
+    (void)batches_run(1U, 0.f, STEP_MAX);
+    start = emu_time_ns_get();
+    (void)batches_run(2U, 0.f, STEP_MAX);
+    elapsed = emu_time_ns_get() - start;
+    CHECK(elapsed > ((2U * HW_SAMPLER_BATCH) - 1U) * (PERIOD_MS / 4U) * NS_PER_MS);
+    CHECK(elapsed < ((2U * HW_SAMPLER_BATCH) + 1U) * (PERIOD_MS / 4U) * NS_PER_MS);
+
+    hw_sampler_stop();
+    emu_twi_stats_reset();
+    emu_busy_wait(1000ULL * NS_PER_MS);
+    emu_twi_stats_get(&bus);
+    CHECK(bus.ppi_xfers == 0U);
+}
+
+int main(void)
+{
+    twi_queue_config_t const       queue_config   =
+    {
+        .scl                = 27U,
+        .sda                = 26U,
+        .frequency          = TWI_QUEUE_FREQ_400K,
+        .interrupt_priority = 6U,
+    };
+    npm1300_charger_config_t const charger_config = NPM1300_CHARGER_DEFAULT_CONFIG(&m_queue);
+
+    npm1300_emu_reset();
+    m_ramp.vbat = RAMP_START;
+    npm1300_emu_battery_set(m_ramp.vbat, 0.01f, 25.f);
+
+    CHECK(twi_queue_init(&m_queue, &queue_config) == NRF_SUCCESS);
+    npm1300_charger_init(&m_charger, &charger_config);
+    CHECK(hw_sampler_init(&m_queue, &m_charger) == NRF_SUCCESS);
+
+    test_order();
+    test_sharing();
+    test_period();
+
+    if (m_failures != 0U)
+    {
+        fprintf(stderr, "%u checks failed\n", (unsigned)m_failures);
+        return 1;
+    }
+
+    printf("hw_sampler_test: all checks passed\n");
+
+    return 0;
+}
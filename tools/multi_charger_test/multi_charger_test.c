@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Runs two chargers on two TWI queues, each on a bus of its own with an emulated nPM1300.
+ * The PMICs see different batteries, so every value tells which one it was read from:
+ * snapshots, charger settings, conversion waits and PMIC events must stay with their
+ * instance while both fetch at the same time.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "sdk_common.h"
+#include "app_timer.h"
+#include "twi_queue.h"
+#include "npm1300_charger.h"
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+
+#define CHARGERS     2U
+#define FETCHES      5U
+#define VBAT_STEP    0.05f /* Battery voltage step between fetches [V] */
+#define PERIOD_NS    10000000ULL /* Between fetches, the conversions they trigger complete */
+
+TWI_QUEUE_DEF(m_queue0, 0);
+TWI_QUEUE_DEF(m_queue1, 1);
+NPM1300_CHARGER_DEF(m_charger0);
+NPM1300_CHARGER_DEF(m_charger1);
+
+static twi_queue_t       * const mp_queues[CHARGERS]   = { &m_queue0, &m_queue1 };
+static npm1300_charger_t * const mp_chargers[CHARGERS] = { &m_charger0, &m_charger1 };
+
+/* Battery and settings of each PMIC. Without NPM1300_CHARGER_FETCH_FRESH a fetch reads the
+ * conversions triggered by the previous one, vbat_read is the voltage they converted.
+ */
+static struct
+{
+    float    vbat;
+    float    ibat;
+    float    tbat;
+    int32_t  current_microamp;
+    uint32_t int_pin;
+    float    vbat_read;
+    float    vbat_triggered;
+} m_pack[CHARGERS] =
+{
+    { .vbat = 3.60f, .ibat = 0.05f,  .tbat = 20.f, .current_microamp = 150000, .int_pin = 30U },
+    { .vbat = 3.90f, .ibat = 0.20f,  .tbat = 35.f, .current_microamp = 300000, .int_pin = 31U },
+};
+
+static struct
+{
+    uint32_t   calls;
+    ret_code_t result;
+    uint64_t   time_ns;
+} m_fetched[CHARGERS];
+
+#if NPM1300_EVENTS_ENABLED
+static uint32_t m_vbus_events[CHARGERS];
+#endif
+
+static uint32_t m_failures;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(expr))                                                       \
+        {                                                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #expr);   \
+            m_failures++;                                                  \
+        }                                                                  \
+    } while (0)
+
+static uint32_t charger_index(npm1300_charger_t const * p_charger)
+{
+    for (uint32_t i = 0; i < CHARGERS; i++)
+    {
+        if (mp_chargers[i] == p_charger)
+        {
+            return i;
+        }
+    }
+
+    return CHARGERS;
+}
+
+static void fetch_handler(npm1300_charger_t * p_charger, ret_code_t result)
+{
+    uint32_t i = charger_index(p_charger);
+
+    CHECK(i < CHARGERS);
+    if (i < CHARGERS)
+    {
+        m_fetched[i].calls++;
+        m_fetched[i].result  = result;
+        m_fetched[i].time_ns = emu_time_ns_get();
+    }
+}
+
+#if NPM1300_EVENTS_ENABLED
+static void vbus_handler(uint32_t events, void * p_context)
+{
+    UNUSED_PARAMETER(events);
+
+    m_vbus_events[(uint32_t *)p_context - m_vbus_events]++;
+}
+
+static void vbus_apply(uint32_t i, float vbus)
+{
+    npm1300_emu_select((uint8_t)i);
+    npm1300_emu_vbus_set(vbus);
+}
+#endif
+
+static void pack_apply(uint32_t i)
+{
+    npm1300_emu_select((uint8_t)i);
+    npm1300_emu_battery_set(m_pack[i].vbat, m_pack[i].ibat, m_pack[i].tbat);
+}
+
+static bool queues_idle(void)
+{
+    return twi_queue_is_idle(&m_queue0) && twi_queue_is_idle(&m_queue1);
+}
+
+/* Start the fetch of the chargers in mask back to back and sleep until all are done,
+ * then wait for the rest of the sampling period. Returns the time the fetches took.
+ */
+static uint64_t fetch_run(uint32_t mask)
+{
+    uint64_t start = emu_time_ns_get();
+    uint64_t time;
+    bool     done  = false;
+
+    for (uint32_t i = 0; i < CHARGERS; i++)
+    {
+        m_fetched[i].calls = 0U;
+        if ((mask & (1UL << i)) != 0U)
+        {
+#if NPM1300_CHARGER_FETCH_FRESH
+            m_pack[i].vbat_read = m_pack[i].vbat;
+#else
+            m_pack[i].vbat_read      = m_pack[i].vbat_triggered;
+            m_pack[i].vbat_triggered = m_pack[i].vbat;
+#endif
+            CHECK(npm1300_charger_sample_fetch_async(mp_chargers[i], fetch_handler) == NRF_SUCCESS);
+        }
+    }
+
+    while (!done)
+    {
+        emu_wfe();
+
+        done = true;
+        for (uint32_t i = 0; i < CHARGERS; i++)
+        {
+            done &= ((mask & (1UL << i)) == 0U) || (m_fetched[i].calls != 0U);
+        }
+    }
+
+    while (!queues_idle())
+    {
+        emu_wfe();
+    }
+
+    time = emu_time_ns_get() - start;
+    emu_busy_wait(PERIOD_NS);
+
+    return time;
+}
+
+/* The snapshot of a charger holds the battery of its own PMIC */
+static void snapshot_check(uint32_t i)
+{
+    npm1300_charger_snapshot_t snapshot;
+
+    npm1300_charger_snapshot_get(mp_chargers[i], &snapshot);
+
+    CHECK(fabsf(snapshot.voltage - m_pack[i].vbat_read) < 0.01f);
+    CHECK(fabsf(snapshot.temp - m_pack[i].tbat) < 1.f);
+    CHECK(snapshot.current > 0.f);
+}
+
+/* Each charger programs its own PMIC */
+static void test_config(void)
+{
+    npm1300_emu_charger_t charger;
+
+    for (uint32_t i = 0; i < CHARGERS; i++)
+    {
+        npm1300_emu_select((uint8_t)i);
+        npm1300_emu_charger_get(&charger);
+
+        CHECK(charger.enabled);
+        CHECK(fabsf(charger.iset - (m_pack[i].current_microamp / 1e6f)) < 0.0005f);
+    }
+}
+
+/* Currents on a step are programmed as they are, others round down to the step below,
+ * the ends of the ranges are accepted and values beyond them rejected
+ */
+static void test_current_steps(void)
+{
+    static const struct
+    {
+        int32_t microamp;
+        float   iset;
+    } charge[] =
+    {
+        { 32000,  0.032f }, { 33000,  0.032f }, { 150000, 0.150f },
+        { 151999, 0.150f }, { 799999, 0.798f }, { 800000, 0.800f },
+    };
+    static const struct
+    {
+        int32_t microamp;
+        float   idischg;
+    } dischg[] =
+    {
+        { 268090,  0.26809f }, { 271319,  0.26809f }, { 271320,  0.27132f },
+        { 1340450, 1.34045f },
+    };
+    npm1300_charger_t   * p_charger = mp_chargers[0];
+    npm1300_emu_charger_t charger;
+
+    npm1300_emu_select(0U);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(charge); i++)
+    {
+        CHECK(npm1300_charger_current_set(p_charger, charge[i].microamp) == NRF_SUCCESS);
+        npm1300_emu_charger_get(&charger);
+        CHECK(fabsf(charger.iset - charge[i].iset) < 0.0005f);
+    }
+
+    CHECK(npm1300_charger_current_set(p_charger, 31999) == NRF_ERROR_INVALID_PARAM);
+    CHECK(npm1300_charger_current_set(p_charger, 800001) == NRF_ERROR_INVALID_PARAM);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(dischg); i++)
+    {
+        CHECK(npm1300_charger_dischg_limit_set(p_charger, dischg[i].microamp) == NRF_SUCCESS);
+        npm1300_emu_charger_get(&charger);
+        CHECK(fabsf(charger.idischg - dischg[i].idischg) < 0.0005f);
+    }
+
+    CHECK(npm1300_charger_dischg_limit_set(p_charger, 268089) == NRF_ERROR_INVALID_PARAM);
+    CHECK(npm1300_charger_dischg_limit_set(p_charger, 1340451) == NRF_ERROR_INVALID_PARAM);
+
+    /* Back to the configuration the other tests expect */
+    CHECK(npm1300_charger_current_set(p_charger, m_pack[0].current_microamp) == NRF_SUCCESS);
+    CHECK(npm1300_charger_dischg_limit_set(p_charger, 1000000) == NRF_SUCCESS);
+}
+
+/* Fetches of both chargers overlap, every one reads the battery of its own PMIC right
+ * after its own conversion wait
+ */
+static void test_concurrent(void)
+{
+    npm1300_charger_stats_t stats[CHARGERS];
+    npm1300_emu_stats_t     emu[CHARGERS];
+    uint64_t                single;
+    uint64_t                both;
+
+    single = fetch_run(1UL << 0);
+    CHECK((m_fetched[0].calls == 1U) && (m_fetched[0].result == NRF_SUCCESS));
+    CHECK(m_fetched[1].calls == 0U);
+    snapshot_check(0);
+
+    for (uint32_t fetch = 0; fetch < FETCHES; fetch++)
+    {
+        /* The batteries move apart, a snapshot of the other PMIC or of the previous
+         * conversion is off by a step at least
+         */
+        m_pack[0].vbat -= VBAT_STEP;
+        m_pack[1].vbat += VBAT_STEP;
+        pack_apply(0);
+        pack_apply(1);
+
+        both = fetch_run((1UL << 0) | (1UL << 1));
+
+        for (uint32_t i = 0; i < CHARGERS; i++)
+        {
+            CHECK((m_fetched[i].calls == 1U) && (m_fetched[i].result == NRF_SUCCESS));
+            snapshot_check(i);
+        }
+
+        /* Two buses and two conversion timers: together about as long as one alone */
+        CHECK(both < ((single * 3U) / 2U));
+    }
+
+    for (uint32_t i = 0; i < CHARGERS; i++)
+    {
+        npm1300_charger_stats_get(mp_chargers[i], &stats[i]);
+        npm1300_emu_select((uint8_t)i);
+        npm1300_emu_stats_get(&emu[i]);
+    }
+
+    CHECK(stats[0].samples == FETCHES + 1U);
+    CHECK(stats[1].samples == FETCHES);
+    /* Conversions went to the PMIC of the fetch */
+    CHECK(emu[0].adc_tasks > emu[1].adc_tasks);
+}
+
+#if NPM1300_EVENTS_ENABLED
+/* A VBUS change of one PMIC updates the status of its charger only */
+static void test_events(void)
+{
+    npm1300_charger_stats_t    before[CHARGERS];
+    npm1300_charger_stats_t    after[CHARGERS];
+    npm1300_charger_snapshot_t snapshot[CHARGERS];
+
+    for (uint32_t vbus = 0; vbus < CHARGERS; vbus++)
+    {
+        uint32_t other = (vbus + 1U) % CHARGERS;
+        uint32_t events_other = m_vbus_events[other];
+        uint32_t events       = m_vbus_events[vbus];
+
+        for (uint32_t i = 0; i < CHARGERS; i++)
+        {
+            npm1300_charger_stats_get(mp_chargers[i], &before[i]);
+        }
+
+        vbus_apply(vbus, 5.f);
+
+        while (m_vbus_events[vbus] == events)
+        {
+            emu_wfe();
+        }
+        while (!queues_idle())
+        {
+            emu_wfe();
+        }
+
+        for (uint32_t i = 0; i < CHARGERS; i++)
+        {
+            npm1300_charger_stats_get(mp_chargers[i], &after[i]);
+            npm1300_charger_snapshot_get(mp_chargers[i], &snapshot[i]);
+        }
+
+        CHECK(m_vbus_events[vbus] == events + 1U);
+        CHECK(m_vbus_events[other] == events_other);
+        CHECK(after[vbus].status_updates > before[vbus].status_updates);
+        CHECK(after[other].status_updates == before[other].status_updates);
+        CHECK((snapshot[vbus].vbus_stat & 0x01U) != 0U);
+        CHECK((snapshot[other].vbus_stat & 0x01U) == (vbus == 1U));
+
+        /* Fetches go on with both */
+        (void)fetch_run((1UL << 0) | (1UL << 1));
+        CHECK((m_fetched[0].calls == 1U) && (m_fetched[1].calls == 1U));
+    }
+}
+#endif // NPM1300_EVENTS_ENABLED
+
+int main(void)
+{
+    twi_queue_config_t const queue_config =
+    {
+        .scl                = 27U,
+        .sda                = 26U,
+        .frequency          = TWI_QUEUE_FREQ_400K,
+        .interrupt_priority = 6U,
+    };
+
+    npm1300_emu_reset();
+    CHECK(app_timer_init() == NRF_SUCCESS);
+
+    for (uint32_t i = 0; i < CHARGERS; i++)
+    {
+        npm1300_charger_config_t config = NPM1300_CHARGER_DEFAULT_CONFIG(mp_queues[i]);
+
+        config.current_microamp = m_pack[i].current_microamp;
+        config.int_pin          = m_pack[i].int_pin;
+
+        /* Init triggers the first conversions */
+        pack_apply(i);
+        m_pack[i].vbat_triggered = m_pack[i].vbat;
+        CHECK(twi_queue_init(mp_queues[i], &queue_config) == NRF_SUCCESS);
+        npm1300_charger_init(mp_chargers[i], &config);
+
+#if NPM1300_EVENTS_ENABLED
+        CHECK(npm1300_events_subscribe(npm1300_charger_events_get(mp_chargers[i]),
+                                       NPM1300_EVENT_MASK_VBUS, vbus_handler,
+                                       &m_vbus_events[i]) == NRF_SUCCESS);
+#endif
+    }
+
+    test_config();
+    test_current_steps();
+    test_concurrent();
+#if NPM1300_EVENTS_ENABLED
+    test_events();
+#endif
+
+    if (m_failures != 0U)
+    {
+        fprintf(stderr, "%u checks failed\n", (unsigned)m_failures);
+        return 1;
+    }
+
+    printf("multi_charger_test: all checks passed\n");
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host nrf_fstorage with the NVMC backend, and the crc32 library. */
+
+#include <stdio.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_fstorage.h"
+#include "nrf_fstorage_nvmc.h"
+#include "crc32.h"
+#include "emu_flash.h"
+
+struct nrf_fstorage_api_s
+{
+    char const * p_name;
+};
+
+nrf_fstorage_api_t nrf_fstorage_nvmc = { .p_name = "nvmc" };
+
+static nrf_fstorage_info_t const m_flash_info =
+{
+    .erase_unit   = EMU_FLASH_PAGE_SIZE,
+    .program_unit = sizeof(uint32_t),
+    .rmap         = true,
+    .wmap         = false,
+};
+
+static uint8_t           m_flash[EMU_FLASH_SIZE];
+static bool              m_erased;
+static uint32_t          m_cut_words = UINT32_MAX;
+static emu_flash_stats_t m_stats;
+
+static void flash_erased_check(void)
+{
+    if (!m_erased)
+    {
+        emu_flash_reset();
+    }
+}
+
+static bool range_valid(nrf_fstorage_t const * p_fs, uint32_t addr, uint32_t len)
+{
+    return (addr >= p_fs->start_addr) && (len <= p_fs->end_addr) &&
+           (addr <= (p_fs->end_addr - len));
+}
+
+static void evt_send(nrf_fstorage_t const * p_fs, nrf_fstorage_evt_id_t id, uint32_t addr,
+                     void const * p_src, uint32_t len, void * p_param)
+{
+    nrf_fstorage_evt_t evt =
+    {
+        .id      = id,
+        .result  = NRF_SUCCESS,
+        .addr    = addr,
+        .p_src   = p_src,
+        .len     = len,
+        .p_param = p_param,
+    };
+
+    if (p_fs->evt_handler != NULL)
+    {
+        p_fs->evt_handler(&evt);
+    }
+}
+
+void emu_flash_reset(void)
+{
+    memset(m_flash, 0xFF, sizeof(m_flash));
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_cut_words = UINT32_MAX;
+    m_erased    = true;
+}
+
+bool emu_flash_load(char const * p_path)
+{
+    FILE * p_file = fopen(p_path, "rb");
+    bool   ok;
+
+    emu_flash_reset();
+    if (p_file == NULL)
+    {
+        return false;
+    }
+
+    ok = (fread(m_flash, 1, sizeof(m_flash), p_file) == sizeof(m_flash));
+    fclose(p_file);
+    if (!ok)
+    {
+        emu_flash_reset();
+    }
+
+    return ok;
+}
+
+bool emu_flash_save(char const * p_path)
+{
+    FILE * p_file = fopen(p_path, "wb");
+    bool   ok;
+
+    flash_erased_check();
+    if (p_file == NULL)
+    {
+        return false;
+    }
+
+    ok = (fwrite(m_flash, 1, sizeof(m_flash), p_file) == sizeof(m_flash));
+
+    return (fclose(p_file) == 0) && ok;
+}
+
+void emu_flash_cut_set(uint32_t words)
+{
+    m_cut_words = words;
+}
+
+void emu_flash_stats_get(emu_flash_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+ret_code_t nrf_fstorage_init(nrf_fstorage_t * p_fs, nrf_fstorage_api_t * p_api, void * p_param)
+{
+    UNUSED_PARAMETER(p_param);
+
+    if ((p_fs->start_addr >= p_fs->end_addr) || (p_fs->end_addr > EMU_FLASH_SIZE))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    flash_erased_check();
+    p_fs->p_api        = p_api;
+    p_fs->p_flash_info = &m_flash_info;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_fstorage_read(nrf_fstorage_t const * p_fs, uint32_t addr, void * p_dest,
+                             uint32_t len)
+{
+    if (!range_valid(p_fs, addr, len))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    memcpy(p_dest, &m_flash[addr], len);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_fstorage_write(nrf_fstorage_t const * p_fs, uint32_t dest, void const * p_src,
+                              uint32_t len, void * p_param)
+{
+    uint8_t const * p_data = (uint8_t const *)p_src;
+
+    if (((dest % sizeof(uint32_t)) != 0U) || (((uintptr_t)p_src % sizeof(uint32_t)) != 0U))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if ((len == 0U) || ((len % sizeof(uint32_t)) != 0U))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    if (!range_valid(p_fs, dest, len))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    for (uint32_t i = 0U; i < len; i += sizeof(uint32_t))
+    {
+        uint32_t word;
+        uint32_t data;
+
+        if (m_cut_words == 0U)
+        {
+            /* Reset during the write: nothing more is programmed or reported. */
+            m_cut_words = UINT32_MAX;
+            return NRF_SUCCESS;
+        }
+        if (m_cut_words != UINT32_MAX)
+        {
+            m_cut_words--;
+        }
+
+        memcpy(&word, &m_flash[dest + i], sizeof(word));
+        memcpy(&data, &p_data[i], sizeof(data));
+        if (word != UINT32_MAX)
+        {
+            m_stats.overwrites++;
+        }
+
+        /* Programming only clears bits. */
+        word &= data;
+        memcpy(&m_flash[dest + i], &word, sizeof(word));
+        m_stats.words++;
+    }
+
+    evt_send(p_fs, NRF_FSTORAGE_EVT_WRITE_RESULT, dest, p_src, len, p_param);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_fstorage_erase(nrf_fstorage_t const * p_fs, uint32_t page_addr, uint32_t len,
+                              void * p_param)
+{
+    if (((page_addr % EMU_FLASH_PAGE_SIZE) != 0U) ||
+        (len == 0U) || (len > (EMU_FLASH_SIZE / EMU_FLASH_PAGE_SIZE)) ||
+        !range_valid(p_fs, page_addr, len * EMU_FLASH_PAGE_SIZE))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    for (uint32_t i = 0U; i < len; i++)
+    {
+        uint32_t page = (page_addr / EMU_FLASH_PAGE_SIZE) + i;
+
+        memset(&m_flash[page * EMU_FLASH_PAGE_SIZE], 0xFF, EMU_FLASH_PAGE_SIZE);
+        m_stats.page_erases[page]++;
+        m_stats.erases++;
+    }
+
+    evt_send(p_fs, NRF_FSTORAGE_EVT_ERASE_RESULT, page_addr, NULL, len, p_param);
+
+    return NRF_SUCCESS;
+}
+
+bool nrf_fstorage_is_busy(nrf_fstorage_t const * p_fs)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    return false;
+}
+
+uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc)
+{
+    uint32_t crc = (p_crc == NULL) ? 0xFFFFFFFFUL : ~(*p_crc);
+
+    for (uint32_t i = 0U; i < size; i++)
+    {
+        crc ^= p_data[i];
+        for (uint32_t j = 0U; j < 8U; j++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
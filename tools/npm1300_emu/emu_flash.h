@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup emu_flash Emulated flash
+ * @{
+ * @brief nrf_fstorage with the NVMC backend, on a RAM copy of the nRF52 flash.
+ *
+ * @details Erased flash reads 0xFF and programming can only clear bits, like the NVMC.
+ *          Operations complete and report their event before returning. A write can be cut
+ *          after a number of words to emulate a reset in the middle of it, and the flash
+ *          image can be kept in a file across runs.
+ */
+
+#ifndef EMU_FLASH_H__
+#define EMU_FLASH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Emulated flash, from address 0. */
+#define EMU_FLASH_SIZE      0x100000UL
+#define EMU_FLASH_PAGE_SIZE 4096UL
+
+/** @brief Flash counters. */
+typedef struct
+{
+    uint32_t erases;                                     /**< Pages erased. */
+    uint32_t words;                                      /**< Words programmed. */
+    uint32_t overwrites;                                 /**< Words programmed without an erase before. */
+    uint16_t page_erases[EMU_FLASH_SIZE / EMU_FLASH_PAGE_SIZE]; /**< Erase cycles of every page. */
+} emu_flash_stats_t;
+
+/**
+ * @brief Function for erasing the whole flash and clearing the counters.
+ */
+void emu_flash_reset(void);
+
+/**
+ * @brief Function for reading the flash image from a file.
+ *
+ * @return False if the file cannot be read, the flash is left erased then.
+ */
+bool emu_flash_load(char const * p_path);
+
+/**
+ * @brief Function for writing the flash image to a file.
+ */
+bool emu_flash_save(char const * p_path);
+
+/**
+ * @brief Function for cutting the next write.
+ *
+ * @details Only the first @p words words of the next write reach the flash, the operation
+ *          is not reported. Emulates a reset in the middle of the write.
+ */
+void emu_flash_cut_set(uint32_t words);
+
+/**
+ * @brief Function for getting the flash counters.
+ */
+void emu_flash_stats_get(emu_flash_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_FLASH_H__
+
+/** @} */
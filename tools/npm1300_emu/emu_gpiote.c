@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sdk_common.h"
+#include "nrfx_gpiote.h"
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+
+/* PORT event latency from the pin edge to the interrupt handler. */
+#define PORT_EVENT_LATENCY_NS 2000U
+
+/* Input pins are wired to the interrupt outputs of the emulated PMICs in the order they
+ * are set up, the first one to device 0.
+ */
+typedef struct
+{
+    bool                      enabled;
+    nrfx_gpiote_pin_t         pin;
+    nrfx_gpiote_evt_handler_t handler;
+} input_t;
+
+static struct
+{
+    bool    init;
+    input_t inputs[NPM1300_EMU_DEVICES];
+    uint8_t input_count;
+} m_gpiote;
+
+static input_t * input_get(nrfx_gpiote_pin_t pin)
+{
+    for (uint8_t i = 0; i < m_gpiote.input_count; i++)
+    {
+        if (m_gpiote.inputs[i].pin == pin)
+        {
+            return &m_gpiote.inputs[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void port_irq(void * p_context)
+{
+    input_t * p_input = (input_t *)p_context;
+
+    if (p_input->enabled && (p_input->handler != NULL))
+    {
+        p_input->handler(p_input->pin, NRF_GPIOTE_POLARITY_LOTOHI);
+    }
+}
+
+static void int_line_handler(uint8_t device, bool level)
+{
+    input_t * p_input = &m_gpiote.inputs[device];
+
+    if (level && (device < m_gpiote.input_count) && p_input->enabled)
+    {
+        emu_irq_post(PORT_EVENT_LATENCY_NS, port_irq, p_input);
+    }
+}
+
+ret_code_t nrfx_gpiote_init(void)
+{
+    if (m_gpiote.init)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_gpiote.init = true;
+    npm1300_emu_int_handler_set(int_line_handler);
+
+    return NRF_SUCCESS;
+}
+
+bool nrfx_gpiote_is_init(void)
+{
+    return m_gpiote.init;
+}
+
+ret_code_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t               pin,
+                               nrfx_gpiote_in_config_t const * p_config,
+                               nrfx_gpiote_evt_handler_t       evt_handler)
+{
+    input_t * p_input = input_get(pin);
+
+    if (!m_gpiote.init || (p_config->sense != NRF_GPIOTE_POLARITY_LOTOHI))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_input == NULL)
+    {
+        if (m_gpiote.input_count == NPM1300_EMU_DEVICES)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_input = &m_gpiote.inputs[m_gpiote.input_count++];
+    }
+
+    p_input->pin     = pin;
+    p_input->handler = evt_handler;
+
+    return NRF_SUCCESS;
+}
+
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable)
+{
+    input_t * p_input = input_get(pin);
+
+    if (p_input != NULL)
+    {
+        p_input->enabled = int_enable;
+    }
+}
+
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin)
+{
+    input_t * p_input = input_get(pin);
+
+    return (p_input != NULL) && npm1300_emu_int_get((uint8_t)(p_input - m_gpiote.inputs));
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host nrf_ringbuf and SEGGER RTT. The RTT host side is taken to read every channel as
+ * fast as it is written, so writes never trim.
+ */
+
+#include <stdio.h>
+#include "sdk_common.h"
+#include "nrf_ringbuf.h"
+#include "SEGGER_RTT.h"
+
+#define RTT_UP_CHANNELS 3U
+
+void nrf_ringbuf_init(nrf_ringbuf_t const * p_ringbuf)
+{
+    memset(p_ringbuf->p_cb, 0, sizeof(*p_ringbuf->p_cb));
+}
+
+ret_code_t nrf_ringbuf_alloc(nrf_ringbuf_t const * p_ringbuf, uint8_t ** pp_data,
+                             size_t * p_length, bool start)
+{
+    nrf_ringbuf_cb_t * p_cb = p_ringbuf->p_cb;
+    size_t             size = p_ringbuf->bufsize_mask + 1;
+    size_t             wr_pos;
+    size_t             length;
+
+    if (start)
+    {
+        if (p_cb->wr_busy)
+        {
+            return NRF_ERROR_BUSY;
+        }
+        p_cb->wr_busy = true;
+    }
+
+    /* Contiguous free space, up to the read position or the end of the buffer */
+    wr_pos = p_cb->tmp_wr_idx & p_ringbuf->bufsize_mask;
+    length = MIN(size - (p_cb->tmp_wr_idx - p_cb->rd_idx), size - wr_pos);
+    length = MIN(length, *p_length);
+
+    *pp_data         = &p_ringbuf->p_buffer[wr_pos];
+    *p_length        = length;
+    p_cb->tmp_wr_idx += length;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ringbuf_put(nrf_ringbuf_t const * p_ringbuf, size_t length)
+{
+    nrf_ringbuf_cb_t * p_cb = p_ringbuf->p_cb;
+
+    if (length > (p_cb->tmp_wr_idx - p_cb->wr_idx))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_cb->wr_idx     += length;
+    p_cb->tmp_wr_idx  = p_cb->wr_idx;
+    p_cb->wr_busy     = false;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ringbuf_get(nrf_ringbuf_t const * p_ringbuf, uint8_t ** pp_data,
+                           size_t * p_length, bool start)
+{
+    nrf_ringbuf_cb_t * p_cb = p_ringbuf->p_cb;
+    size_t             rd_pos;
+    size_t             length;
+
+    if (start)
+    {
+        if (p_cb->rd_busy)
+        {
+            return NRF_ERROR_BUSY;
+        }
+        p_cb->rd_busy = true;
+    }
+
+    /* Contiguous data, up to the write position or the end of the buffer */
+    rd_pos = p_cb->tmp_rd_idx & p_ringbuf->bufsize_mask;
+    length = MIN(p_cb->wr_idx - p_cb->tmp_rd_idx, p_ringbuf->bufsize_mask + 1 - rd_pos);
+    length = MIN(length, *p_length);
+
+    *pp_data         = &p_ringbuf->p_buffer[rd_pos];
+    *p_length        = length;
+    p_cb->tmp_rd_idx += length;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ringbuf_free(nrf_ringbuf_t const * p_ringbuf, size_t length)
+{
+    nrf_ringbuf_cb_t * p_cb = p_ringbuf->p_cb;
+
+    if (length > (p_cb->tmp_rd_idx - p_cb->rd_idx))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_cb->rd_idx     += length;
+    p_cb->tmp_rd_idx  = p_cb->rd_idx;
+    p_cb->rd_busy     = false;
+
+    return NRF_SUCCESS;
+}
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char * sName, void * pBuffer,
+                              unsigned BufferSize, unsigned Flags)
+{
+    UNUSED_PARAMETER(sName);
+    UNUSED_PARAMETER(pBuffer);
+    UNUSED_PARAMETER(BufferSize);
+    UNUSED_PARAMETER(Flags);
+
+    return (BufferIndex < RTT_UP_CHANNELS) ? 0 : -1;
+}
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void * pBuffer, unsigned NumBytes)
+{
+    if ((BufferIndex == 0U) || (BufferIndex >= RTT_UP_CHANNELS))
+    {
+        return NumBytes;
+    }
+
+    return (unsigned)fwrite(pBuffer, 1, NumBytes, stdout);
+}
+
+int SEGGER_RTT_HasKey(void)
+{
+    return 0;
+}
+
+int SEGGER_RTT_GetKey(void)
+{
+    return -1;
+}
@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Runs the fuel gauge application loop of main.c against the nPM1300 emulator, with a
+ * scripted battery load, and reports the bus and CPU cost of the driver.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sdk_common.h"
+#include "app_timer.h"
+#include "npm1300_charger.h"
+#if NPM1300_EVENTS_ENABLED
+#include "npm1300_events.h"
+#endif
+#include "fuel_gauge.h"
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+#include "telemetry.h"
+#endif
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+#include "checkpoint.h"
+#endif
+#include "sampler.h"
+#if HW_SAMPLER_ENABLED
+#include "hw_sampler.h"
+#endif
+#include "uptime.h"
+#if PROFILE_ENABLED
+#include "profile.h"
+#endif
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+#include "emu_twi.h"
+#include "emu_sensor.h"
+#include "emu_flash.h"
+
+#define NS_PER_S 1000000000ULL
+
+/* Step of the load and VBUS script */
+typedef struct
+{
+    float time_s;  /* Start of the step [s] */
+    float load;    /* System load on the battery [A] */
+    float vbus;    /* VBUS voltage [V], 0 when detached */
+} profile_step_t;
+
+static const profile_step_t m_profile[] = {
+    {   0.f, 0.005f,   0.f },
+    { 120.f, 0.080f,   0.f },  /* Load step */
+    { 180.f, 0.00005f, 0.f },  /* Idle */
+    { 420.f, 0.005f,   5.f },  /* VBUS attach, charging */
+    { 540.f, 0.005f,   0.f },  /* VBUS removed */
+};
+
+/* Battery: linear open-circuit voltage over state of charge, series resistance */
+#define BAT_OCV_EMPTY  3.3f
+#define BAT_OCV_SPAN   0.9f
+#define BAT_R0         0.15f
+#define BAT_TEMP       25.f
+
+static struct
+{
+    float    capacity_ah;
+    float    soc;
+    uint64_t last_ns;
+} m_bat = { .capacity_ah = 0.1f, .soc = 0.6f };
+
+/* Time from a VBUS change to the PMIC event reaching the application */
+static struct
+{
+    uint64_t vbus_change_ns;
+    uint64_t max_ns;
+    uint64_t sum_ns;
+    uint32_t count;
+} m_latency;
+
+static profile_step_t const * profile_step_get(float t)
+{
+    size_t i = 0U;
+
+    while (((i + 1U) < ARRAY_SIZE(m_profile)) && (m_profile[i + 1U].time_s <= t))
+    {
+        i++;
+    }
+
+    return &m_profile[i];
+}
+
+/* Advance the battery to the current simulated time and update the ADC inputs. */
+static void battery_update(void)
+{
+    uint64_t               now  = emu_time_ns_get();
+    float                  dt   = (float)(now - m_bat.last_ns) / NS_PER_S;
+    profile_step_t const * step = profile_step_get((float)now / NS_PER_S);
+    npm1300_emu_inputs_t * p_in = npm1300_emu_inputs_get();
+    npm1300_emu_charger_t  charger;
+    float                  ocv;
+    float                  ibat;
+
+    /* Charge flowing over the elapsed interval, at the current of the previous update */
+    m_bat.soc -= (p_in->ibat * dt / 3600.f) / m_bat.capacity_ah;
+    m_bat.soc  = fminf(fmaxf(m_bat.soc, 0.f), 1.f);
+    m_bat.last_ns = now;
+
+    if (p_in->vbus != step->vbus)
+    {
+        npm1300_emu_vbus_set(step->vbus);
+        m_latency.vbus_change_ns = now;
+    }
+
+    ocv = BAT_OCV_EMPTY + (BAT_OCV_SPAN * m_bat.soc);
+    npm1300_emu_charger_get(&charger);
+
+    if (charger.enabled && (step->vbus > 4.f))
+    {
+        /* Constant current, then constant voltage at the termination voltage. The system
+         * load is supplied from VBUS.
+         */
+        ibat = -fminf(charger.iset, fmaxf((charger.vterm - ocv) / BAT_R0, 0.f));
+        if (-ibat < (charger.iset / 10.f))
+        {
+            ibat = 0.f;
+        }
+    }
+    else
+    {
+        ibat = step->load;
+    }
+
+    npm1300_emu_battery_set(ocv - (ibat * BAT_R0), ibat, BAT_TEMP);
+}
+
+/* Raise the charge current and VBUS limit while VBUS is present. Called for every sample,
+ * repeated calls with unchanged values must not reach the bus.
+ */
+static struct
+{
+    int32_t  current_ua;
+    int32_t  default_ua;
+    uint32_t calls;
+    uint32_t transactions;
+} m_fast_charge;
+
+static void fast_charge_update(void)
+{
+    npm1300_charger_snapshot_t snapshot;
+    emu_twi_stats_t            before;
+    emu_twi_stats_t            after;
+    bool                       vbus;
+
+    npm1300_charger_snapshot_get(fuel_gauge_charger_get(), &snapshot);
+    vbus = (snapshot.vbus_stat & 1U) != 0U;
+
+    emu_twi_stats_get(&before);
+    APP_ERROR_CHECK(npm1300_charger_vbus_limit_set(fuel_gauge_charger_get(), vbus ? 1000000 : 500000));
+    APP_ERROR_CHECK(npm1300_charger_current_set(fuel_gauge_charger_get(),
+                                                vbus ? m_fast_charge.current_ua :
+                                                m_fast_charge.default_ua));
+    emu_twi_stats_get(&after);
+
+    m_fast_charge.calls += 2U;
+    m_fast_charge.transactions += after.transactions - before.transactions;
+}
+
+/* Bulk sensors sharing the bus: every sensor has its FIFO read in BULK_XFERS chunks with one
+ * transaction every BULK_PERIOD_MS, all sensors at the same time.
+ */
+#define BULK_SENSOR_ADDR 0x18U
+#define BULK_PERIOD_MS   20U
+#define BULK_XFERS       4U
+#define BULK_CHUNK       32U
+
+typedef struct
+{
+    uint8_t                 fifo_reg[1];
+    uint8_t                 data[BULK_XFERS * BULK_CHUNK];
+    uint8_t                 next;
+    bool                    busy;
+    twi_queue_xfer_t        xfers[BULK_XFERS];
+    twi_queue_transaction_t transaction;
+} bulk_sensor_t;
+
+static struct
+{
+    bulk_sensor_t sensors[EMU_SENSOR_MAX];
+    uint8_t       count;
+    uint32_t      reads;
+    uint32_t      skipped;
+    uint32_t      sequence_errors;
+} m_bulk;
+
+APP_TIMER_DEF(m_bulk_timer);
+
+/* The chunks of one transaction must continue each other, a transaction of another device
+ * in between would not break the FIFO counter but one split or repeated would.
+ */
+static void bulk_done(ret_code_t result, void * p_context)
+{
+    bulk_sensor_t * p_sensor = (bulk_sensor_t *)p_context;
+
+    APP_ERROR_CHECK(result);
+
+    for (size_t i = 0U; i < sizeof(p_sensor->data); i++)
+    {
+        if (p_sensor->data[i] != p_sensor->next++)
+        {
+            m_bulk.sequence_errors++;
+            p_sensor->next = p_sensor->data[i] + 1U;
+        }
+    }
+
+    m_bulk.reads++;
+    p_sensor->busy = false;
+}
+
+static void bulk_timer_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    for (uint8_t i = 0U; i < m_bulk.count; i++)
+    {
+        bulk_sensor_t * p_sensor = &m_bulk.sensors[i];
+
+        if (p_sensor->busy)
+        {
+            m_bulk.skipped++;
+            continue;
+        }
+
+        p_sensor->busy = true;
+        APP_ERROR_CHECK(twi_queue_schedule(fuel_gauge_twi_queue_get(), &p_sensor->transaction));
+    }
+}
+
+static void bulk_start(uint8_t count, twi_queue_priority_t priority)
+{
+    m_bulk.count = count;
+
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        bulk_sensor_t * p_sensor = &m_bulk.sensors[i];
+        uint8_t         address  = BULK_SENSOR_ADDR + i;
+
+        if (!emu_sensor_add(address))
+        {
+            APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
+        }
+
+        p_sensor->fifo_reg[0] = EMU_SENSOR_REG_FIFO;
+        for (uint8_t j = 0U; j < BULK_XFERS; j++)
+        {
+            p_sensor->xfers[j] = (twi_queue_xfer_t)TWI_QUEUE_READ(address, p_sensor->fifo_reg,
+                                                                  sizeof(p_sensor->fifo_reg),
+                                                                  &p_sensor->data[j * BULK_CHUNK],
+                                                                  BULK_CHUNK);
+        }
+
+        p_sensor->transaction = (twi_queue_transaction_t) {
+            .callback  = bulk_done,
+            .p_context = p_sensor,
+            .p_xfers   = p_sensor->xfers,
+            .count     = BULK_XFERS,
+            .priority  = priority,
+        };
+    }
+
+    APP_ERROR_CHECK(app_timer_create(&m_bulk_timer, APP_TIMER_MODE_REPEATED, bulk_timer_handler));
+    APP_ERROR_CHECK(app_timer_start(m_bulk_timer, APP_TIMER_TICKS(BULK_PERIOD_MS), NULL));
+}
+
+static void usage(const char * p_name)
+{
+    fprintf(stderr,
+            "usage: %s [-d seconds] [-c capacity_mAh] [-s soc_percent] [-f mA] [-b|-B sensors]\n"
+            "          [-F flash_image] [-q]\n"
+            "  -d  simulated duration (default 600)\n"
+            "  -c  battery capacity (default 100)\n"
+            "  -s  initial state of charge (default 60)\n"
+            "  -f  charge current while VBUS is present, with a 1 A VBUS limit\n"
+            "  -b  bulk sensors reading their FIFO on the PMIC bus at low priority\n"
+            "  -B  same at high priority, queued in order with the PMIC event reads\n"
+            "  -F  flash image, read at start and written at the end, so a run continues\n"
+            "      from the fuel gauge checkpoint of the previous one\n"
+            "  -q  do not print the fuel gauge output (binary telemetry records by default)\n",
+            p_name);
+}
+
+#if NPM1300_EVENTS_ENABLED
+/* Same as main.c: sample right away on VBUS and charger changes. */
+static void pmic_event_handler(uint32_t events, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if ((events & NPM1300_EVENT_MASK_VBUS) != 0)
+    {
+        uint64_t latency = emu_time_ns_get() - m_latency.vbus_change_ns;
+
+        m_latency.max_ns  = MAX(m_latency.max_ns, latency);
+        m_latency.sum_ns += latency;
+        m_latency.count++;
+    }
+
+    sampler_sample_request();
+}
+#endif
+
+int main(int argc, char * argv[])
+{
+    uint64_t                duration_ns = 600ULL * NS_PER_S;
+    uint32_t                period_ms   = FUEL_GAUGE_SAMPLE_PERIOD_MS;
+    npm1300_charger_stats_t chg_stats;
+    npm1300_emu_stats_t     reg_stats;
+    twi_queue_priority_t    bulk_priority = TWI_QUEUE_PRIORITY_LOW;
+    uint8_t                 bulk_count    = 0U;
+    emu_twi_stats_t         init_stats;
+    emu_twi_stats_t         bus_stats;
+    emu_platform_stats_t    cpu_stats;
+    char const *            p_flash_path  = NULL;
+    float                   start_soc;
+    int                     opt;
+
+    while ((opt = getopt(argc, argv, "d:c:s:f:b:B:F:qh")) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                duration_ns = (uint64_t)(atof(optarg) * NS_PER_S);
+                break;
+            case 'c':
+                m_bat.capacity_ah = (float)atof(optarg) / 1000.f;
+                break;
+            case 's':
+                m_bat.soc = (float)atof(optarg) / 100.f;
+                break;
+            case 'f':
+                m_fast_charge.current_ua = (int32_t)(atof(optarg) * 1000.0);
+                break;
+            case 'B':
+                bulk_priority = TWI_QUEUE_PRIORITY_HIGH;
+                /* fall through */
+            case 'b':
+                bulk_count = (uint8_t)MIN((unsigned)atoi(optarg), EMU_SENSOR_MAX);
+                break;
+            case 'F':
+                p_flash_path = optarg;
+                break;
+            case 'q':
+                if (freopen("/dev/null", "w", stdout) == NULL)
+                {
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    npm1300_emu_reset();
+    battery_update();
+
+    /* A missing image is a new device with erased flash. */
+    if (p_flash_path != NULL)
+    {
+        (void)emu_flash_load(p_flash_path);
+    }
+
+    /* Same start-up sequence as main.c */
+    APP_ERROR_CHECK(app_timer_init());
+#if PROFILE_ENABLED
+    profile_init();
+#endif
+    APP_ERROR_CHECK(uptime_init());
+    APP_ERROR_CHECK(sampler_init());
+
+    if (fuel_gauge_init() != 0)
+    {
+        fprintf(stderr, "Could not initialise fuel gauge.\n");
+        return 1;
+    }
+    start_soc = fuel_gauge_soc_get();
+
+#if NPM1300_EVENTS_ENABLED
+    APP_ERROR_CHECK(npm1300_events_subscribe(npm1300_charger_events_get(fuel_gauge_charger_get()),
+                                             NPM1300_EVENT_MASK_VBUS |
+                                             NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_COMPLETED) |
+                                             NPM1300_EVENT_MASK(NPM1300_EVENT_CHG_ERROR),
+                                             pmic_event_handler, NULL));
+#endif
+
+    emu_twi_stats_get(&init_stats);
+
+    struct sensor_value value;
+    npm1300_charger_channel_get(fuel_gauge_charger_get(), SENSOR_CHAN_GAUGE_DESIRED_CHARGING_CURRENT, &value);
+    m_fast_charge.default_ua = (value.val1 * 1000000) + value.val2;
+
+#if HW_SAMPLER_ENABLED
+    /* Samples are taken without the CPU, the sampler only serves PMIC events. */
+    APP_ERROR_CHECK(hw_sampler_init(fuel_gauge_twi_queue_get(), fuel_gauge_charger_get()));
+    APP_ERROR_CHECK(hw_sampler_start(period_ms));
+#else
+    sampler_config_t const sampler_config =
+    {
+        .period_ms   = period_ms,
+        .phase_align = FUEL_GAUGE_SAMPLE_PHASE_ALIGN,
+    };
+    APP_ERROR_CHECK(sampler_start(&sampler_config));
+#endif
+
+    if (bulk_count != 0U)
+    {
+        bulk_start(bulk_count, bulk_priority);
+    }
+
+    while (emu_time_ns_get() < duration_ns)
+    {
+        battery_update();
+
+#if HW_SAMPLER_ENABLED
+        hw_sampler_batch_t batch;
+
+        if (hw_sampler_batch_take(&batch))
+        {
+            fuel_gauge_batch_update(&batch);
+
+            if (m_fast_charge.current_ua != 0)
+            {
+                fast_charge_update();
+            }
+
+            if (fuel_gauge_period_get() != period_ms)
+            {
+                period_ms = fuel_gauge_period_get();
+                APP_ERROR_CHECK(hw_sampler_period_set(period_ms));
+            }
+        }
+#endif
+
+        if (sampler_sample_pending_take())
+        {
+            fuel_gauge_update();
+
+            if (m_fast_charge.current_ua != 0)
+            {
+                fast_charge_update();
+            }
+
+            if (fuel_gauge_period_get() != period_ms)
+            {
+                period_ms = fuel_gauge_period_get();
+#if HW_SAMPLER_ENABLED
+                APP_ERROR_CHECK(hw_sampler_period_set(period_ms));
+#else
+                APP_ERROR_CHECK(sampler_period_set(period_ms));
+#endif
+            }
+        }
+
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+        telemetry_flush();
+#endif
+
+        __WFE();
+    }
+
+    npm1300_charger_stats_get(fuel_gauge_charger_get(), &chg_stats);
+    npm1300_emu_stats_get(&reg_stats);
+    emu_twi_stats_get(&bus_stats);
+    emu_platform_stats_get(&cpu_stats);
+
+    double sim_s = (double)emu_time_ns_get() / NS_PER_S;
+
+    fprintf(stderr, "simulated time      %.3f s\n", sim_s);
+    fprintf(stderr, "bus clock           %u Hz (%s)\n", (unsigned)emu_twi_frequency_get(),
+            TWI_QUEUE_USE_TWIM ? "TWIM" : "TWI");
+    fprintf(stderr, "init                %u transactions, %u bytes, %.1f us\n",
+            (unsigned)init_stats.transactions, (unsigned)init_stats.bytes,
+            init_stats.bus_time_ns / 1000.0);
+    fprintf(stderr, "samples             %u\n", (unsigned)chg_stats.samples);
+    fprintf(stderr, "transactions        %u (%.2f per sample)\n", (unsigned)bus_stats.transactions,
+            chg_stats.samples ? (double)(bus_stats.transactions - init_stats.transactions) / chg_stats.samples : 0.0);
+    fprintf(stderr, "driver calls        %u\n", (unsigned)bus_stats.driver_calls);
+    fprintf(stderr, "bus bytes           %u\n", (unsigned)bus_stats.bytes);
+    fprintf(stderr, "bus time            %.1f us (%.4f %% utilization)\n",
+            bus_stats.bus_time_ns / 1000.0, 100.0 * bus_stats.bus_time_ns / emu_time_ns_get());
+    fprintf(stderr, "TWI interrupts      %u\n", (unsigned)bus_stats.interrupts);
+    fprintf(stderr, "CPU wakeups         %u (%u peripheral, %u timer)\n", (unsigned)cpu_stats.wakeups,
+            (unsigned)cpu_stats.irqs, (unsigned)cpu_stats.timer_irqs);
+#if HW_SAMPLER_ENABLED
+    hw_sampler_stats_t hw_stats;
+
+    hw_sampler_stats_get(&hw_stats);
+    fprintf(stderr, "hardware sampling   %u batches, %u overruns, %u handovers, %u PPI transfers, "
+            "%u collisions, %u events without wakeup\n", (unsigned)hw_stats.batches,
+            (unsigned)hw_stats.overruns, (unsigned)hw_stats.handovers,
+            (unsigned)bus_stats.ppi_xfers, (unsigned)bus_stats.collisions,
+            (unsigned)cpu_stats.hw_events);
+#endif
+    fprintf(stderr, "register accesses   %u written, %u read, %u ADC tasks\n",
+            (unsigned)reg_stats.reg_writes, (unsigned)reg_stats.reg_reads,
+            (unsigned)reg_stats.adc_tasks);
+#if NPM1300_EVENTS_ENABLED
+    npm1300_events_stats_t ev_stats;
+
+    npm1300_events_stats_get(npm1300_charger_events_get(fuel_gauge_charger_get()), &ev_stats);
+    fprintf(stderr, "PMIC events         %u interrupts, %u read cycles, %u events, %u status reads\n",
+            (unsigned)ev_stats.interrupts, (unsigned)ev_stats.reads, (unsigned)ev_stats.events,
+            (unsigned)chg_stats.status_updates);
+#endif
+    if (bulk_count != 0U)
+    {
+        fprintf(stderr, "bulk sensors        %u at %s priority, %u reads, %u skipped, %u FIFO bytes, "
+                "%u sequence errors\n", (unsigned)bulk_count,
+                (bulk_priority == TWI_QUEUE_PRIORITY_LOW) ? "low" : "high",
+                (unsigned)m_bulk.reads, (unsigned)m_bulk.skipped,
+                (unsigned)emu_sensor_fifo_bytes_get(), (unsigned)m_bulk.sequence_errors);
+    }
+#if NPM1300_EVENTS_ENABLED
+    if (m_latency.count != 0U)
+    {
+        fprintf(stderr, "VBUS event latency  %.1f us max, %.1f us mean\n",
+                m_latency.max_ns / 1000.0, m_latency.sum_ns / 1000.0 / m_latency.count);
+    }
+#endif
+    if (m_fast_charge.current_ua != 0)
+    {
+        fprintf(stderr, "charger setters     %u calls, %u transactions\n",
+                (unsigned)m_fast_charge.calls, (unsigned)m_fast_charge.transactions);
+    }
+#if FUEL_GAUGE_TELEMETRY_ENABLED
+    telemetry_stats_t tm_stats;
+
+    telemetry_stats_get(&tm_stats);
+    fprintf(stderr, "telemetry           %u records, %u dropped, %u bytes\n",
+            (unsigned)tm_stats.records, (unsigned)tm_stats.dropped, (unsigned)tm_stats.bytes);
+#endif
+    npm1300_charger_snapshot_t snapshot;
+
+    npm1300_charger_snapshot_get(fuel_gauge_charger_get(), &snapshot);
+    fprintf(stderr, "last sample         VBAT %.3f V, VSYS %.3f V, VBUS %.3f V, die %.1f C\n",
+            snapshot.voltage, snapshot.vsys, snapshot.vbus, snapshot.die_temp);
+    fprintf(stderr, "battery SoC         %.1f %%\n", m_bat.soc * 100.f);
+    /* A cold start without a checkpoint has no state of charge before the first update */
+    if (isnan(start_soc))
+    {
+        fprintf(stderr, "gauge SoC           %.1f %% (n/a at start)\n", fuel_gauge_soc_get());
+    }
+    else
+    {
+        fprintf(stderr, "gauge SoC           %.1f %% (%.1f %% at start)\n", fuel_gauge_soc_get(),
+                start_soc);
+    }
+#if FUEL_GAUGE_CHECKPOINT_ENABLED
+    checkpoint_stats_t ckpt_stats;
+    emu_flash_stats_t  flash_stats;
+
+    checkpoint_stats_get(&ckpt_stats);
+    emu_flash_stats_get(&flash_stats);
+    fprintf(stderr, "checkpoint          %u records, %u page erases, %u busy, %u words overwritten\n",
+            (unsigned)ckpt_stats.writes, (unsigned)ckpt_stats.erases, (unsigned)ckpt_stats.busy,
+            (unsigned)flash_stats.overwrites);
+#endif
+#if PROFILE_ENABLED
+    /* Host CPU time at 64 MHz, to compare builds on the same machine */
+    for (uint32_t scope = 0U; scope < PROFILE_SCOPE_COUNT; scope++)
+    {
+        profile_stats_t prof_stats;
+
+        profile_get((profile_scope_t)scope, &prof_stats);
+        fprintf(stderr, "profile %-11s %u passes, %u min, %u mean, %u max cycles\n",
+                profile_scope_name_get((profile_scope_t)scope), (unsigned)prof_stats.count,
+                (unsigned)prof_stats.min, (unsigned)profile_mean_get(&prof_stats),
+                (unsigned)prof_stats.max);
+    }
+#endif
+
+    if ((p_flash_path != NULL) && !emu_flash_save(p_flash_path))
+    {
+        fprintf(stderr, "Could not write %s\n", p_flash_path);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "nrf.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "emu_platform.h"
+
+#define NS_PER_S 1000000000ULL
+
+/* RTC ticks per second seen by app_timer */
+#define TICK_FREQ (APP_TIMER_CLOCK_FREQ / (APP_TIMER_CONFIG_RTC_FREQUENCY + 1))
+
+typedef struct
+{
+    uint64_t          time_ns;
+    emu_irq_handler_t handler;
+    void *            p_context;
+    bool              wake;
+} pending_irq_t;
+
+static uint64_t             m_time_ns;
+static pending_irq_t        m_irqs[EMU_IRQ_PENDING_MAX];
+static uint8_t              m_irq_count;
+static app_timer_t *        mp_timers;
+static emu_platform_stats_t m_stats;
+
+/* GPREGRET of nrf_power.h */
+uint8_t emu_gpregret;
+
+/* Debug unit of nrf.h. The host CPU time of peripheral events is not CPU time of the target. */
+CoreDebug_Type  emu_core_debug;
+static DWT_Type m_dwt;
+static uint64_t m_dwt_start_ns;
+static uint64_t m_sleep_ns;
+
+static uint64_t cpu_time_ns_get(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return ((uint64_t)ts.tv_sec * NS_PER_S) + (uint64_t)ts.tv_nsec;
+}
+
+DWT_Type * emu_dwt_get(void)
+{
+    bool running = ((emu_core_debug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0U) &&
+                   ((m_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U);
+
+    if (!running)
+    {
+        m_dwt_start_ns = 0U;
+    }
+    else if (m_dwt_start_ns == 0U)
+    {
+        /* Counting starts from the value written before enabling */
+        m_dwt_start_ns = cpu_time_ns_get() - m_sleep_ns - ((uint64_t)m_dwt.CYCCNT * 1000U / 64U);
+    }
+    else
+    {
+        m_dwt.CYCCNT = (uint32_t)(((cpu_time_ns_get() - m_sleep_ns - m_dwt_start_ns) * 64U) / 1000U);
+    }
+
+    return &m_dwt;
+}
+
+static uint64_t ticks_now(void)
+{
+    return (m_time_ns * TICK_FREQ) / NS_PER_S;
+}
+
+/* First nanosecond at which the RTC shows the given tick. */
+static uint64_t tick_to_ns(uint64_t tick)
+{
+    return ((tick * NS_PER_S) + TICK_FREQ - 1U) / TICK_FREQ;
+}
+
+uint64_t emu_time_ns_get(void)
+{
+    return m_time_ns;
+}
+
+static void event_post(uint64_t delay_ns, emu_irq_handler_t handler, void * p_context, bool wake)
+{
+    if (m_irq_count == EMU_IRQ_PENDING_MAX)
+    {
+        fprintf(stderr, "emu: too many pending interrupts\n");
+        abort();
+    }
+
+    m_irqs[m_irq_count++] = (pending_irq_t){ m_time_ns + delay_ns, handler, p_context, wake };
+}
+
+void emu_irq_post(uint64_t delay_ns, emu_irq_handler_t handler, void * p_context)
+{
+    event_post(delay_ns, handler, p_context, true);
+}
+
+void emu_hw_event_post(uint64_t delay_ns, emu_irq_handler_t handler, void * p_context)
+{
+    event_post(delay_ns, handler, p_context, false);
+}
+
+void emu_event_cancel(emu_irq_handler_t handler, void * p_context)
+{
+    for (int i = 0; i < m_irq_count; )
+    {
+        if ((m_irqs[i].handler == handler) && (m_irqs[i].p_context == p_context))
+        {
+            m_irqs[i] = m_irqs[--m_irq_count];
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+static app_timer_t * timer_next_get(void)
+{
+    app_timer_t * p_next = NULL;
+
+    for (app_timer_t * p_timer = mp_timers; p_timer != NULL; p_timer = p_timer->p_next)
+    {
+        if (p_timer->active && ((p_next == NULL) || (p_timer->expiry < p_next->expiry)))
+        {
+            p_next = p_timer;
+        }
+    }
+
+    return p_next;
+}
+
+static int irq_next_get(bool hw_only)
+{
+    int next = -1;
+
+    for (int i = 0; i < m_irq_count; i++)
+    {
+        if (hw_only && m_irqs[i].wake)
+        {
+            continue;
+        }
+
+        if ((next < 0) || (m_irqs[i].time_ns < m_irqs[next].time_ns))
+        {
+            next = i;
+        }
+    }
+
+    return next;
+}
+
+/* Remove the pending entry and advance the clock to it. */
+static pending_irq_t irq_take(int irq)
+{
+    pending_irq_t pending = m_irqs[irq];
+
+    m_irqs[irq] = m_irqs[--m_irq_count];
+    if (pending.time_ns > m_time_ns)
+    {
+        m_time_ns = pending.time_ns;
+    }
+
+    return pending;
+}
+
+void emu_busy_wait(uint64_t delay_ns)
+{
+    uint64_t end = m_time_ns + delay_ns;
+    int      irq;
+
+    while (((irq = irq_next_get(true)) >= 0) && (m_irqs[irq].time_ns <= end))
+    {
+        pending_irq_t pending = irq_take(irq);
+
+        m_stats.hw_events++;
+        pending.handler(pending.p_context);
+    }
+
+    m_time_ns = end;
+}
+
+bool emu_next_event_get(uint64_t * p_time_ns)
+{
+    app_timer_t * p_timer = timer_next_get();
+    int           irq     = irq_next_get(false);
+
+    if ((p_timer == NULL) && (irq < 0))
+    {
+        return false;
+    }
+
+    if ((irq >= 0) && ((p_timer == NULL) || (m_irqs[irq].time_ns <= tick_to_ns(p_timer->expiry))))
+    {
+        *p_time_ns = m_irqs[irq].time_ns;
+    }
+    else
+    {
+        *p_time_ns = tick_to_ns(p_timer->expiry);
+    }
+
+    return true;
+}
+
+void emu_wfe(void)
+{
+    app_timer_t * p_timer;
+    int           irq;
+
+    /* Peripheral events run while the CPU sleeps on */
+    for (;;)
+    {
+        p_timer = timer_next_get();
+        irq     = irq_next_get(false);
+
+        if ((p_timer == NULL) && (irq < 0))
+        {
+            fprintf(stderr, "emu: WFE with no pending event, the CPU would sleep forever\n");
+            abort();
+        }
+
+        if ((irq < 0) || ((p_timer != NULL) && (m_irqs[irq].time_ns > tick_to_ns(p_timer->expiry))))
+        {
+            break;
+        }
+
+        pending_irq_t pending = irq_take(irq);
+
+        if (!pending.wake)
+        {
+            uint64_t start_ns = cpu_time_ns_get();
+
+            m_stats.hw_events++;
+            pending.handler(pending.p_context);
+            m_sleep_ns += cpu_time_ns_get() - start_ns;
+            continue;
+        }
+
+        m_stats.wakeups++;
+        m_stats.irqs++;
+        pending.handler(pending.p_context);
+        return;
+    }
+
+    m_stats.wakeups++;
+
+    if (tick_to_ns(p_timer->expiry) > m_time_ns)
+    {
+        m_time_ns = tick_to_ns(p_timer->expiry);
+    }
+
+    if (p_timer->mode == APP_TIMER_MODE_REPEATED)
+    {
+        p_timer->expiry += p_timer->period;
+    }
+    else
+    {
+        p_timer->active = false;
+    }
+
+    m_stats.timer_irqs++;
+    p_timer->handler(p_timer->p_context);
+}
+
+void emu_platform_stats_get(emu_platform_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+void emu_error_handler(ret_code_t error_code, const char * p_file, uint32_t line)
+{
+    fprintf(stderr, "emu: error 0x%08x at %s:%u\n", (unsigned)error_code, p_file, (unsigned)line);
+    abort();
+}
+
+ret_code_t app_timer_init(void)
+{
+    mp_timers = NULL;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    app_timer_t * p_timer = *p_timer_id;
+
+    if (timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_timer->handler = timeout_handler;
+    p_timer->mode    = mode;
+    p_timer->active  = false;
+
+    /* Created again by a second init of its owner, it is already in the list */
+    for (app_timer_t * p_listed = mp_timers; p_listed != NULL; p_listed = p_listed->p_next)
+    {
+        if (p_listed == p_timer)
+        {
+            return NRF_SUCCESS;
+        }
+    }
+
+    p_timer->p_next  = mp_timers;
+    mp_timers        = p_timer;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    if (timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    /* Like app_timer2, starting an active timer does nothing. */
+    if (timer_id->active)
+    {
+        return NRF_SUCCESS;
+    }
+
+    timer_id->expiry    = ticks_now() + timeout_ticks;
+    timer_id->period    = timeout_ticks;
+    timer_id->p_context = p_context;
+    timer_id->active    = true;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(ticks_now() & APP_TIMER_MAX_CNT_VAL);
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & APP_TIMER_MAX_CNT_VAL;
+}
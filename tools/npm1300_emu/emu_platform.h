@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup emu_platform Emulated MCU platform
+ * @{
+ * @brief Simulated time, interrupts and sleep for running the firmware modules on a host.
+ *
+ * @details Nothing runs concurrently: peripherals post their interrupts with a due time,
+ *          and @ref emu_wfe, which replaces __WFE(), advances the simulated clock to the
+ *          earliest pending interrupt or app_timer expiry and runs its handler. Thread code
+ *          between two WFE calls takes no simulated time.
+ *
+ *          Events between peripherals, such as the ones routed through PPI, are posted the
+ *          same way but do not wake the CPU: WFE runs them and sleeps on.
+ */
+
+#ifndef EMU_PLATFORM_H__
+#define EMU_PLATFORM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of interrupts pending at the same time. */
+#define EMU_IRQ_PENDING_MAX 16
+
+typedef void (* emu_irq_handler_t)(void * p_context);
+
+/** @brief Counters of the emulated CPU. */
+typedef struct
+{
+    uint32_t wakeups;     /**< WFE calls that ended with an interrupt. */
+    uint32_t irqs;        /**< Peripheral interrupts handled. */
+    uint32_t timer_irqs;  /**< app_timer expiries handled. */
+    uint32_t hw_events;   /**< Peripheral events handled without waking the CPU. */
+} emu_platform_stats_t;
+
+/**
+ * @brief Function for getting the simulated time in nanoseconds.
+ */
+uint64_t emu_time_ns_get(void);
+
+/**
+ * @brief Function for posting an interrupt.
+ *
+ * @param[in] delay_ns  Time from now until the interrupt fires.
+ * @param[in] handler   Interrupt handler.
+ * @param[in] p_context Passed to the handler.
+ */
+void emu_irq_post(uint64_t delay_ns, emu_irq_handler_t handler, void * p_context);
+
+/**
+ * @brief Function for posting a peripheral event that does not wake the CPU.
+ *
+ * @param[in] delay_ns  Time from now until the event.
+ * @param[in] handler   Event handler, run by the emulator.
+ * @param[in] p_context Passed to the handler.
+ */
+void emu_hw_event_post(uint64_t delay_ns, emu_irq_handler_t handler, void * p_context);
+
+/**
+ * @brief Function for removing pending interrupts and events with the given handler and context.
+ */
+void emu_event_cancel(emu_irq_handler_t handler, void * p_context);
+
+/**
+ * @brief Function for letting time pass in a busy-wait, e.g. on a peripheral register.
+ *
+ * @details Peripheral events due meanwhile are run, interrupts stay pending.
+ *
+ * @param[in] delay_ns Time spent by the CPU.
+ */
+void emu_busy_wait(uint64_t delay_ns);
+
+/**
+ * @brief Function for sleeping until the next event and handling it.
+ *
+ * @details Aborts the emulation if there is nothing left that could wake the CPU up.
+ */
+void emu_wfe(void);
+
+/**
+ * @brief Function for getting the time of the next event.
+ *
+ * @return False if nothing is pending.
+ */
+bool emu_next_event_get(uint64_t * p_time_ns);
+
+/**
+ * @brief Function for getting the CPU counters.
+ */
+void emu_platform_stats_get(emu_platform_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_PLATFORM_H__
+
+/** @} */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sdk_common.h"
+#include "nrfx_ppi.h"
+#include "emu_ppi.h"
+
+#define PPI_CHANNELS (NRF_PPI_CHANNEL19 + 1)
+
+typedef struct
+{
+    bool     allocated;
+    bool     enabled;
+    uint32_t eep;
+    uint32_t tep;
+    uint32_t fork_tep;
+} ppi_channel_t;
+
+typedef struct
+{
+    uint32_t       address;
+    emu_ppi_task_t task;
+    void *         p_context;
+} ppi_task_t;
+
+static ppi_channel_t m_channels[PPI_CHANNELS];
+static ppi_task_t    m_tasks[EMU_PPI_TASKS_MAX];
+static uint8_t       m_task_count;
+
+void emu_ppi_task_register(uint32_t address, emu_ppi_task_t task, void * p_context)
+{
+    for (uint8_t i = 0; i < m_task_count; i++)
+    {
+        if (m_tasks[i].address == address)
+        {
+            m_tasks[i].task      = task;
+            m_tasks[i].p_context = p_context;
+            return;
+        }
+    }
+
+    if (m_task_count == EMU_PPI_TASKS_MAX)
+    {
+        fprintf(stderr, "emu: too many PPI tasks\n");
+        abort();
+    }
+
+    m_tasks[m_task_count++] = (ppi_task_t){ address, task, p_context };
+}
+
+static void task_trigger(uint32_t address)
+{
+    if (address == 0U)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < m_task_count; i++)
+    {
+        if (m_tasks[i].address == address)
+        {
+            m_tasks[i].task(m_tasks[i].p_context);
+            return;
+        }
+    }
+
+    fprintf(stderr, "emu: PPI task 0x%08x is not emulated\n", (unsigned)address);
+    abort();
+}
+
+void emu_ppi_event(uint32_t address)
+{
+    for (uint8_t i = 0; i < PPI_CHANNELS; i++)
+    {
+        ppi_channel_t const * p_channel = &m_channels[i];
+
+        if (p_channel->enabled && (p_channel->eep == address))
+        {
+            task_trigger(p_channel->tep);
+            task_trigger(p_channel->fork_tep);
+        }
+    }
+}
+
+nrfx_err_t nrfx_ppi_channel_alloc(nrf_ppi_channel_t * p_channel)
+{
+    for (uint8_t i = 0; i < PPI_CHANNELS; i++)
+    {
+        if (!m_channels[i].allocated)
+        {
+            m_channels[i] = (ppi_channel_t){ .allocated = true };
+            *p_channel = (nrf_ppi_channel_t)i;
+            return NRFX_SUCCESS;
+        }
+    }
+
+    return NRFX_ERROR_NO_MEM;
+}
+
+nrfx_err_t nrfx_ppi_channel_free(nrf_ppi_channel_t channel)
+{
+    if (!m_channels[channel].allocated)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    m_channels[channel].allocated = false;
+    m_channels[channel].enabled   = false;
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep)
+{
+    if (!m_channels[channel].allocated)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    m_channels[channel].eep = eep;
+    m_channels[channel].tep = tep;
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_fork_assign(nrf_ppi_channel_t channel, uint32_t fork_tep)
+{
+    if (!m_channels[channel].allocated)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    m_channels[channel].fork_tep = fork_tep;
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_enable(nrf_ppi_channel_t channel)
+{
+    if (!m_channels[channel].allocated)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    m_channels[channel].enabled = true;
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_disable(nrf_ppi_channel_t channel)
+{
+    if (!m_channels[channel].allocated)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    m_channels[channel].enabled = false;
+
+    return NRFX_SUCCESS;
+}
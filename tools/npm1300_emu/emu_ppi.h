@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup emu_ppi Emulated PPI
+ * @{
+ * @brief nrfx_ppi API connecting the events and tasks of the emulated peripherals.
+ *
+ * @details Peripherals register their tasks by register address and signal their events
+ *          with @ref emu_ppi_event. The tasks of all enabled channels on the event run
+ *          immediately, in channel order, the fork task after the main task.
+ */
+
+#ifndef EMU_PPI_H__
+#define EMU_PPI_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of tasks reachable through PPI. */
+#define EMU_PPI_TASKS_MAX 16
+
+typedef void (* emu_ppi_task_t)(void * p_context);
+
+/**
+ * @brief Function for making a peripheral task reachable through PPI.
+ *
+ * @param[in] address   Task register address, as returned by the driver.
+ * @param[in] task      Task handler.
+ * @param[in] p_context Passed to the handler.
+ */
+void emu_ppi_task_register(uint32_t address, emu_ppi_task_t task, void * p_context);
+
+/**
+ * @brief Function for signalling a peripheral event.
+ *
+ * @param[in] address Event register address, as returned by the driver.
+ */
+void emu_ppi_event(uint32_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_PPI_H__
+
+/** @} */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sdk_common.h"
+#include "emu_twi.h"
+#include "emu_sensor.h"
+
+#define SENSOR_REG_COUNT 0x40U
+
+typedef struct
+{
+    emu_twi_slave_t slave;
+    uint8_t         regs[SENSOR_REG_COUNT];
+    uint8_t         reg;
+    uint8_t         fifo;
+} sensor_t;
+
+static sensor_t m_sensors[EMU_SENSOR_MAX];
+static uint8_t  m_sensor_count;
+static uint32_t m_fifo_bytes;
+
+/* First byte is the register pointer, the rest are written from there on. */
+static bool sensor_write(void * p_context, uint8_t const * p_data, size_t len)
+{
+    sensor_t * p_sensor = (sensor_t *)p_context;
+
+    if (len == 0U)
+    {
+        return true;
+    }
+
+    p_sensor->reg = p_data[0] % SENSOR_REG_COUNT;
+
+    for (size_t i = 1U; i < len; i++)
+    {
+        p_sensor->regs[p_sensor->reg] = p_data[i];
+        p_sensor->reg = (p_sensor->reg + 1U) % SENSOR_REG_COUNT;
+    }
+
+    return true;
+}
+
+static void sensor_read(void * p_context, uint8_t * p_data, size_t len)
+{
+    sensor_t * p_sensor = (sensor_t *)p_context;
+
+    for (size_t i = 0U; i < len; i++)
+    {
+        if (p_sensor->reg == EMU_SENSOR_REG_FIFO)
+        {
+            p_data[i] = p_sensor->fifo++;
+            m_fifo_bytes++;
+        }
+        else
+        {
+            p_data[i] = p_sensor->regs[p_sensor->reg];
+            p_sensor->reg = (p_sensor->reg + 1U) % SENSOR_REG_COUNT;
+        }
+    }
+}
+
+bool emu_sensor_add(uint8_t address)
+{
+    sensor_t * p_sensor;
+
+    if (m_sensor_count == EMU_SENSOR_MAX)
+    {
+        return false;
+    }
+
+    p_sensor = &m_sensors[m_sensor_count];
+    p_sensor->slave.address   = address;
+    p_sensor->slave.write     = sensor_write;
+    p_sensor->slave.read      = sensor_read;
+    p_sensor->slave.p_context = p_sensor;
+
+    if (!emu_twi_slave_add(&p_sensor->slave))
+    {
+        return false;
+    }
+
+    m_sensor_count++;
+
+    return true;
+}
+
+uint32_t emu_sensor_fifo_bytes_get(void)
+{
+    return m_fifo_bytes;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup emu_sensor Emulated bulk sensors
+ * @{
+ * @brief Sensors with a FIFO that share the emulated bus with the nPM1300.
+ *
+ * @details A write sets the register pointer, reads auto-increment it. Reading
+ *          @ref EMU_SENSOR_REG_FIFO does not advance the pointer and returns the next FIFO
+ *          byte, like the FIFO data register of an accelerometer. FIFO bytes are a running
+ *          counter per sensor, so a reader can check that no byte was lost or duplicated.
+ */
+
+#ifndef EMU_SENSOR_H__
+#define EMU_SENSOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of sensors. */
+#define EMU_SENSOR_MAX 4
+
+/** @brief FIFO data register. */
+#define EMU_SENSOR_REG_FIFO 0x00U
+
+/**
+ * @brief Function for adding a sensor to the bus.
+ *
+ * @return False if there is no room or the address is taken.
+ */
+bool emu_sensor_add(uint8_t address);
+
+/**
+ * @brief Function for getting the number of FIFO bytes read from all sensors.
+ */
+uint32_t emu_sensor_fifo_bytes_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_SENSOR_H__
+
+/** @} */
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* nrfx_rtc and nrfx_timer on simulated time. The RTC counts LFCLK ticks and generates the
+ * compare event of channel 0, a clear takes effect on the next tick like on the hardware.
+ * The TIMER runs in counter mode only, with compare, capture and shortcuts. Tasks are
+ * reachable through emu_ppi.c, events go there as well.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sdk_common.h"
+#include "nrfx_rtc.h"
+#include "nrfx_timer.h"
+#include "emu_platform.h"
+#include "emu_ppi.h"
+
+#define NS_PER_S          1000000000ULL
+#define LFCLK_FREQ        32768ULL
+#define RTC_COUNTER_MASK  0xFFFFFFUL
+#define RTC_INSTANCES     3
+#define TIMER_INSTANCES   3
+#define TIMER_CC_COUNT    4
+
+/* CPU time of a peripheral register read, so that polling loops let time pass */
+#define REG_ACCESS_NS     250U
+
+typedef struct
+{
+    bool               initialized;
+    bool               enabled;
+    uint32_t           base;
+    uint32_t           prescaler;
+    uint32_t           cc[4];
+    uint64_t           zero_tick;  /* Absolute prescaled tick at which the counter is 0 */
+    uint32_t           held;       /* Counter until a pending clear takes effect */
+    nrfx_rtc_handler_t handler;
+} emu_rtc_t;
+
+typedef struct
+{
+    bool                       initialized;
+    bool                       running;
+    uint32_t                   base;
+    uint32_t                   mask;
+    uint32_t                   count;
+    uint32_t                   cc[TIMER_CC_COUNT];
+    uint32_t                   shorts;
+    uint32_t                   int_mask;
+    nrfx_timer_event_handler_t handler;
+    void *                     p_context;
+} emu_timer_t;
+
+/* Task of a TIMER instance, as PPI task context */
+typedef struct
+{
+    emu_timer_t * p_timer;
+    uint32_t      task;
+} timer_task_t;
+
+/* Compare interrupt of a TIMER channel */
+typedef struct
+{
+    emu_timer_t * p_timer;
+    uint8_t       channel;
+} timer_irq_t;
+
+static emu_rtc_t    m_rtc[RTC_INSTANCES];
+static emu_timer_t  m_timer[TIMER_INSTANCES];
+static timer_task_t m_timer_tasks[TIMER_INSTANCES][3 + TIMER_CC_COUNT];
+static timer_irq_t  m_timer_irqs[TIMER_INSTANCES][TIMER_CC_COUNT];
+
+static uint64_t rtc_tick_now(emu_rtc_t const * p_rtc)
+{
+    return (emu_time_ns_get() * LFCLK_FREQ) / ((p_rtc->prescaler + 1U) * NS_PER_S);
+}
+
+/* First nanosecond of the given prescaled tick */
+static uint64_t rtc_tick_to_ns(emu_rtc_t const * p_rtc, uint64_t tick)
+{
+    uint64_t lfclk = tick * (p_rtc->prescaler + 1U);
+
+    return ((lfclk * NS_PER_S) + LFCLK_FREQ - 1U) / LFCLK_FREQ;
+}
+
+static void rtc_compare(void * p_context);
+
+static void rtc_schedule(emu_rtc_t * p_rtc)
+{
+    uint64_t now = rtc_tick_now(p_rtc);
+    uint64_t target;
+
+    emu_event_cancel(rtc_compare, p_rtc);
+
+    if (!p_rtc->enabled)
+    {
+        return;
+    }
+
+    /* A compare value equal to the counter matches on its next pass only */
+    target = p_rtc->zero_tick + p_rtc->cc[0];
+    while (target <= now)
+    {
+        target += RTC_COUNTER_MASK + 1U;
+    }
+
+    emu_hw_event_post(rtc_tick_to_ns(p_rtc, target) - emu_time_ns_get(), rtc_compare, p_rtc);
+}
+
+static void rtc_compare(void * p_context)
+{
+    emu_rtc_t * p_rtc = (emu_rtc_t *)p_context;
+
+    emu_ppi_event(p_rtc->base + NRF_RTC_EVENT_COMPARE_0);
+    rtc_schedule(p_rtc);
+}
+
+static uint32_t rtc_counter(emu_rtc_t const * p_rtc)
+{
+    uint64_t now = rtc_tick_now(p_rtc);
+
+    if (now < p_rtc->zero_tick)
+    {
+        return p_rtc->held;
+    }
+
+    return (uint32_t)((now - p_rtc->zero_tick) & RTC_COUNTER_MASK);
+}
+
+static void rtc_task_clear(void * p_context)
+{
+    emu_rtc_t * p_rtc = (emu_rtc_t *)p_context;
+
+    p_rtc->held      = rtc_counter(p_rtc);
+    p_rtc->zero_tick = rtc_tick_now(p_rtc) + 1U;
+    rtc_schedule(p_rtc);
+}
+
+nrfx_err_t nrfx_rtc_init(nrfx_rtc_t const *        p_instance,
+                         nrfx_rtc_config_t const * p_config,
+                         nrfx_rtc_handler_t        handler)
+{
+    emu_rtc_t * p_rtc = &m_rtc[p_instance->instance_id];
+
+    if (p_rtc->initialized)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    *p_rtc = (emu_rtc_t) {
+        .initialized = true,
+        .base        = p_instance->base,
+        .prescaler   = p_config->prescaler,
+        .handler     = handler,
+    };
+
+    emu_ppi_task_register(p_rtc->base + NRF_RTC_TASK_CLEAR, rtc_task_clear, p_rtc);
+
+    return NRFX_SUCCESS;
+}
+
+void nrfx_rtc_uninit(nrfx_rtc_t const * p_instance)
+{
+    nrfx_rtc_disable(p_instance);
+    m_rtc[p_instance->instance_id].initialized = false;
+}
+
+void nrfx_rtc_enable(nrfx_rtc_t const * p_instance)
+{
+    emu_rtc_t * p_rtc = &m_rtc[p_instance->instance_id];
+
+    if (!p_rtc->enabled)
+    {
+        p_rtc->enabled   = true;
+        p_rtc->zero_tick = rtc_tick_now(p_rtc) - p_rtc->held;
+    }
+    rtc_schedule(p_rtc);
+}
+
+void nrfx_rtc_disable(nrfx_rtc_t const * p_instance)
+{
+    emu_rtc_t * p_rtc = &m_rtc[p_instance->instance_id];
+
+    if (p_rtc->enabled)
+    {
+        p_rtc->held    = rtc_counter(p_rtc);
+        p_rtc->enabled = false;
+    }
+    rtc_schedule(p_rtc);
+}
+
+nrfx_err_t nrfx_rtc_cc_set(nrfx_rtc_t const * p_instance,
+                           uint32_t           channel,
+                           uint32_t           val,
+                           bool               enable_irq)
+{
+    emu_rtc_t * p_rtc = &m_rtc[p_instance->instance_id];
+
+    if ((channel != 0U) || enable_irq)
+    {
+        fprintf(stderr, "emu: only RTC compare channel 0 without interrupt is emulated\n");
+        abort();
+    }
+
+    p_rtc->cc[channel] = val & RTC_COUNTER_MASK;
+    rtc_schedule(p_rtc);
+
+    return NRFX_SUCCESS;
+}
+
+void nrfx_rtc_counter_clear(nrfx_rtc_t const * p_instance)
+{
+    emu_rtc_t * p_rtc = &m_rtc[p_instance->instance_id];
+
+    if (p_rtc->enabled)
+    {
+        rtc_task_clear(p_rtc);
+    }
+    else
+    {
+        p_rtc->held = 0U;
+    }
+}
+
+uint32_t nrfx_rtc_counter_get(nrfx_rtc_t const * p_instance)
+{
+    emu_rtc_t const * p_rtc = &m_rtc[p_instance->instance_id];
+
+    emu_busy_wait(REG_ACCESS_NS);
+
+    return p_rtc->enabled ? rtc_counter(p_rtc) : p_rtc->held;
+}
+
+uint32_t nrfx_rtc_task_address_get(nrfx_rtc_t const * p_instance, nrf_rtc_task_t task)
+{
+    return p_instance->base + (uint32_t)task;
+}
+
+uint32_t nrfx_rtc_event_address_get(nrfx_rtc_t const * p_instance, nrf_rtc_event_t event)
+{
+    return p_instance->base + (uint32_t)event;
+}
+
+static void timer_irq(void * p_context)
+{
+    timer_irq_t const * p_irq = (timer_irq_t const *)p_context;
+
+    p_irq->p_timer->handler((nrf_timer_event_t)(NRF_TIMER_EVENT_COMPARE0 + (4U * p_irq->channel)),
+                            p_irq->p_timer->p_context);
+}
+
+static void timer_count(emu_timer_t * p_timer)
+{
+    uint8_t timer_id = (uint8_t)(p_timer - m_timer);
+    bool    clear    = false;
+
+    if (!p_timer->running)
+    {
+        return;
+    }
+
+    p_timer->count = (p_timer->count + 1U) & p_timer->mask;
+
+    for (uint8_t ch = 0; ch < TIMER_CC_COUNT; ch++)
+    {
+        if (p_timer->count != p_timer->cc[ch])
+        {
+            continue;
+        }
+
+        emu_ppi_event(p_timer->base + NRF_TIMER_EVENT_COMPARE0 + (4U * ch));
+
+        if ((p_timer->int_mask & (1UL << ch)) != 0U)
+        {
+            emu_irq_post(0, timer_irq, &m_timer_irqs[timer_id][ch]);
+        }
+        if ((p_timer->shorts & (NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK << ch)) != 0U)
+        {
+            clear = true;
+        }
+        if ((p_timer->shorts & (NRF_TIMER_SHORT_COMPARE0_STOP_MASK << ch)) != 0U)
+        {
+            p_timer->running = false;
+        }
+    }
+
+    if (clear)
+    {
+        p_timer->count = 0U;
+    }
+}
+
+static void timer_task(void * p_context)
+{
+    timer_task_t const * p_task  = (timer_task_t const *)p_context;
+    emu_timer_t        * p_timer = p_task->p_timer;
+
+    switch (p_task->task)
+    {
+        case NRF_TIMER_TASK_COUNT:
+            timer_count(p_timer);
+            break;
+
+        case NRF_TIMER_TASK_CLEAR:
+            p_timer->count = 0U;
+            break;
+
+        case NRF_TIMER_TASK_START:
+            p_timer->running = true;
+            break;
+
+        default:
+            p_timer->cc[(p_task->task - NRF_TIMER_TASK_CAPTURE0) / 4U] = p_timer->count;
+            break;
+    }
+}
+
+nrfx_err_t nrfx_timer_init(nrfx_timer_t const *        p_instance,
+                           nrfx_timer_config_t const * p_config,
+                           nrfx_timer_event_handler_t  timer_event_handler)
+{
+    uint8_t       id      = p_instance->instance_id;
+    emu_timer_t * p_timer = &m_timer[id];
+    static const uint32_t tasks[] =
+    {
+        NRF_TIMER_TASK_COUNT, NRF_TIMER_TASK_CLEAR, NRF_TIMER_TASK_START,
+        NRF_TIMER_TASK_CAPTURE0, NRF_TIMER_TASK_CAPTURE1,
+        NRF_TIMER_TASK_CAPTURE2, NRF_TIMER_TASK_CAPTURE3,
+    };
+
+    if (p_timer->initialized)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+
+    if (p_config->mode == NRF_TIMER_MODE_TIMER)
+    {
+        fprintf(stderr, "emu: only the TIMER counter mode is emulated\n");
+        abort();
+    }
+
+    *p_timer = (emu_timer_t) {
+        .initialized = true,
+        .base        = p_instance->base,
+        .handler     = timer_event_handler,
+        .p_context   = p_config->p_context,
+    };
+
+    switch (p_config->bit_width)
+    {
+        case NRF_TIMER_BIT_WIDTH_8:
+            p_timer->mask = 0xFFUL;
+            break;
+        case NRF_TIMER_BIT_WIDTH_24:
+            p_timer->mask = 0xFFFFFFUL;
+            break;
+        case NRF_TIMER_BIT_WIDTH_32:
+            p_timer->mask = 0xFFFFFFFFUL;
+            break;
+        default:
+            p_timer->mask = 0xFFFFUL;
+            break;
+    }
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(tasks); i++)
+    {
+        m_timer_tasks[id][i] = (timer_task_t){ p_timer, tasks[i] };
+        emu_ppi_task_register(p_timer->base + tasks[i], timer_task, &m_timer_tasks[id][i]);
+    }
+
+    for (uint8_t ch = 0; ch < TIMER_CC_COUNT; ch++)
+    {
+        m_timer_irqs[id][ch] = (timer_irq_t){ p_timer, ch };
+    }
+
+    return NRFX_SUCCESS;
+}
+
+void nrfx_timer_uninit(nrfx_timer_t const * p_instance)
+{
+    m_timer[p_instance->instance_id].initialized = false;
+    m_timer[p_instance->instance_id].running     = false;
+}
+
+void nrfx_timer_enable(nrfx_timer_t const * p_instance)
+{
+    m_timer[p_instance->instance_id].running = true;
+}
+
+void nrfx_timer_disable(nrfx_timer_t const * p_instance)
+{
+    m_timer[p_instance->instance_id].running = false;
+}
+
+void nrfx_timer_clear(nrfx_timer_t const * p_instance)
+{
+    m_timer[p_instance->instance_id].count = 0U;
+}
+
+void nrfx_timer_increment(nrfx_timer_t const * p_instance)
+{
+    timer_count(&m_timer[p_instance->instance_id]);
+}
+
+uint32_t nrfx_timer_capture(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel)
+{
+    emu_timer_t * p_timer = &m_timer[p_instance->instance_id];
+
+    emu_busy_wait(REG_ACCESS_NS);
+    p_timer->cc[cc_channel] = p_timer->count;
+
+    return p_timer->cc[cc_channel];
+}
+
+uint32_t nrfx_timer_capture_get(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel)
+{
+    return m_timer[p_instance->instance_id].cc[cc_channel];
+}
+
+void nrfx_timer_compare(nrfx_timer_t const *   p_instance,
+                        nrf_timer_cc_channel_t cc_channel,
+                        uint32_t               cc_value,
+                        bool                   enable_int)
+{
+    emu_timer_t * p_timer = &m_timer[p_instance->instance_id];
+
+    p_timer->cc[cc_channel] = cc_value;
+    if (enable_int)
+    {
+        p_timer->int_mask |= (1UL << cc_channel);
+    }
+    else
+    {
+        p_timer->int_mask &= ~(1UL << cc_channel);
+    }
+}
+
+void nrfx_timer_extended_compare(nrfx_timer_t const *   p_instance,
+                                 nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t               cc_value,
+                                 nrf_timer_short_mask_t timer_short_mask,
+                                 bool                   enable_int)
+{
+    emu_timer_t * p_timer = &m_timer[p_instance->instance_id];
+
+    p_timer->shorts &= ~((NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK | NRF_TIMER_SHORT_COMPARE0_STOP_MASK)
+                         << cc_channel);
+    p_timer->shorts |= (uint32_t)timer_short_mask;
+    nrfx_timer_compare(p_instance, cc_channel, cc_value, enable_int);
+}
+
+uint32_t nrfx_timer_task_address_get(nrfx_timer_t const * p_instance, nrf_timer_task_t timer_task)
+{
+    return p_instance->base + (uint32_t)timer_task;
+}
+
+uint32_t nrfx_timer_capture_task_address_get(nrfx_timer_t const * p_instance, uint32_t channel)
+{
+    return p_instance->base + NRF_TIMER_TASK_CAPTURE0 + (4U * channel);
+}
+
+uint32_t nrfx_timer_event_address_get(nrfx_timer_t const * p_instance, nrf_timer_event_t timer_event)
+{
+    return p_instance->base + (uint32_t)timer_event;
+}
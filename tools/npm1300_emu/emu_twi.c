@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include "sdk_common.h"
+#include "nrfx_twim.h"
+#include "nrfx_twi.h"
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+#include "emu_ppi.h"
+#include "emu_twi.h"
+
+#define NS_PER_S        1000000000ULL
+#define CLOCKS_PER_BYTE 9U
+
+/* TWIM registers reachable through PPI */
+#define TWIM_BASE(_idx)     (0x40003000UL + ((uint32_t)(_idx) * 0x1000UL))
+#define TWIM_TASK_STARTRX   0x000UL
+#define TWIM_TASK_STARTTX   0x008UL
+#define TWIM_EVENT_STOPPED  0x104UL
+
+typedef enum
+{
+    BUS_TWIM,
+    BUS_TWI,
+} bus_driver_t;
+
+typedef struct
+{
+    bus_driver_t             driver;
+    uint32_t                 frequency;
+    bool                     busy;
+    bool                     ppi_busy;
+    uint32_t                 base;
+    nrfx_twim_xfer_desc_t    held;
+    uint32_t                 held_flags;
+    bool                     held_valid;
+    nrfx_twim_evt_handler_t  twim_handler;
+    nrfx_twi_evt_handler_t   twi_handler;
+    void *                   p_context;
+    nrfx_twim_evt_t          twim_evt;
+    nrfx_twi_evt_t           twi_evt;
+    emu_twi_slave_t const *  p_slaves[EMU_TWI_SLAVES_MAX];
+    uint8_t                  slave_count;
+} bus_t;
+
+static emu_twi_stats_t m_stats;
+
+/* The context of the nPM1300 on a bus is its device index */
+static bool npm1300_write(void * p_context, uint8_t const * p_data, size_t len)
+{
+    return npm1300_emu_write((uint8_t)(uintptr_t)p_context, p_data, len);
+}
+
+static void npm1300_read(void * p_context, uint8_t * p_data, size_t len)
+{
+    npm1300_emu_read((uint8_t)(uintptr_t)p_context, p_data, len);
+}
+
+#define NPM1300_SLAVE(_device)                                                     {                                                                                  .address   = NPM1300_EMU_ADDR,                                                 .write     = npm1300_write,                                                    .read      = npm1300_read,                                                     .p_context = (void *)(uintptr_t)(_device),                                 }
+
+static emu_twi_slave_t const m_npm1300_slaves[EMU_TWI_BUSES] =
+{
+    NPM1300_SLAVE(0),
+    NPM1300_SLAVE(1),
+};
+
+static bus_t m_buses[EMU_TWI_BUSES] =
+{
+    { .p_slaves = { &m_npm1300_slaves[0] }, .slave_count = 1U },
+    { .p_slaves = { &m_npm1300_slaves[1] }, .slave_count = 1U },
+};
+
+STATIC_ASSERT(EMU_TWI_BUSES == NPM1300_EMU_DEVICES);
+
+static emu_twi_slave_t const * slave_get(bus_t const * p_bus, uint8_t address)
+{
+    for (uint8_t i = 0; i < p_bus->slave_count; i++)
+    {
+        if (p_bus->p_slaves[i]->address == address)
+        {
+            return p_bus->p_slaves[i];
+        }
+    }
+
+    return NULL;
+}
+
+bool emu_twi_bus_slave_add(uint8_t bus, emu_twi_slave_t const * p_slave)
+{
+    bus_t * p_bus;
+
+    if (bus >= EMU_TWI_BUSES)
+    {
+        return false;
+    }
+
+    p_bus = &m_buses[bus];
+
+    if ((p_bus->slave_count == EMU_TWI_SLAVES_MAX) || (slave_get(p_bus, p_slave->address) != NULL))
+    {
+        return false;
+    }
+
+    p_bus->p_slaves[p_bus->slave_count++] = p_slave;
+
+    return true;
+}
+
+bool emu_twi_slave_add(emu_twi_slave_t const * p_slave)
+{
+    return emu_twi_bus_slave_add(0U, p_slave);
+}
+
+static uint32_t frequency_hz(uint32_t reg_value)
+{
+    switch (reg_value)
+    {
+        case 0x01980000UL:
+            return 100000UL;
+        case 0x04000000UL:
+            return 250000UL;
+        case 0x06400000UL:
+        case 0x06680000UL:
+            return 400000UL;
+        default:
+            return 100000UL;
+    }
+}
+
+/* Account for one segment of a transaction and return its duration. */
+static uint64_t segment_run(bus_t const * p_bus, size_t len, bool stop)
+{
+    uint32_t clocks = 1U + ((uint32_t)(1U + len) * CLOCKS_PER_BYTE) + (stop ? 1U : 0U);
+    uint64_t time   = ((uint64_t)clocks * NS_PER_S) / p_bus->frequency;
+
+    m_stats.bytes       += (uint32_t)(1U + len);
+    m_stats.bus_time_ns += time;
+
+    if (stop)
+    {
+        m_stats.transactions++;
+    }
+
+    return time;
+}
+
+static void twim_irq(void * p_context)
+{
+    bus_t * p_bus = (bus_t *)p_context;
+
+    p_bus->busy = false;
+    emu_ppi_event(p_bus->base + TWIM_EVENT_STOPPED);
+    m_stats.interrupts++;
+    p_bus->twim_handler(&p_bus->twim_evt, p_bus->p_context);
+}
+
+static void twi_irq(void * p_context)
+{
+    bus_t * p_bus = (bus_t *)p_context;
+
+    p_bus->busy = false;
+    p_bus->twi_handler(&p_bus->twi_evt, p_bus->p_context);
+}
+
+void emu_twi_stats_get(emu_twi_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+void emu_twi_stats_reset(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+uint32_t emu_twi_frequency_get(void)
+{
+    return m_buses[0].frequency;
+}
+
+/* Run a TWIM transfer on the bus and return its duration. */
+static nrfx_err_t twim_run(bus_t const *                 p_bus,
+                           nrfx_twim_xfer_desc_t const * p_xfer_desc,
+                           nrfx_twim_evt_type_t *        p_type,
+                           uint64_t *                    p_time)
+{
+    emu_twi_slave_t const * p_slave = slave_get(p_bus, p_xfer_desc->address);
+
+    if (p_slave == NULL)
+    {
+        *p_type = NRFX_TWIM_EVT_ADDRESS_NACK;
+        *p_time = segment_run(p_bus, 0U, true);
+
+        return NRFX_SUCCESS;
+    }
+
+    *p_type = NRFX_TWIM_EVT_DONE;
+
+    switch (p_xfer_desc->type)
+    {
+        case NRFX_TWIM_XFER_TX:
+            (void)p_slave->write(p_slave->p_context, p_xfer_desc->p_primary_buf,
+                                 p_xfer_desc->primary_length);
+            *p_time = segment_run(p_bus, p_xfer_desc->primary_length, true);
+            break;
+
+        case NRFX_TWIM_XFER_RX:
+            p_slave->read(p_slave->p_context, p_xfer_desc->p_primary_buf,
+                          p_xfer_desc->primary_length);
+            *p_time = segment_run(p_bus, p_xfer_desc->primary_length, true);
+            break;
+
+        case NRFX_TWIM_XFER_TXRX:
+            (void)p_slave->write(p_slave->p_context, p_xfer_desc->p_primary_buf,
+                                 p_xfer_desc->primary_length);
+            *p_time  = segment_run(p_bus, p_xfer_desc->primary_length, false);
+            p_slave->read(p_slave->p_context, p_xfer_desc->p_secondary_buf,
+                          p_xfer_desc->secondary_length);
+            *p_time += segment_run(p_bus, p_xfer_desc->secondary_length, true);
+            break;
+
+        case NRFX_TWIM_XFER_TXTX:
+            (void)p_slave->write(p_slave->p_context, p_xfer_desc->p_primary_buf,
+                                 p_xfer_desc->primary_length);
+            *p_time  = segment_run(p_bus, p_xfer_desc->primary_length, false);
+            (void)p_slave->write(p_slave->p_context, p_xfer_desc->p_secondary_buf,
+                                 p_xfer_desc->secondary_length);
+            *p_time += segment_run(p_bus, p_xfer_desc->secondary_length, true);
+            break;
+
+        default:
+            return NRFX_ERROR_INVALID_PARAM;
+    }
+
+    return NRFX_SUCCESS;
+}
+
+/* End of a transfer started by PPI: the buffer pointers move on and STOPPED is signalled. */
+static void twim_ppi_stopped(void * p_context)
+{
+    bus_t                 * p_bus  = (bus_t *)p_context;
+    nrfx_twim_xfer_desc_t * p_desc = &p_bus->held;
+
+    p_bus->ppi_busy = false;
+
+    if ((p_bus->held_flags & NRFX_TWIM_FLAG_TX_POSTINC) != 0U)
+    {
+        p_desc->p_primary_buf += p_desc->primary_length;
+    }
+    if ((p_bus->held_flags & NRFX_TWIM_FLAG_RX_POSTINC) != 0U)
+    {
+        if (p_desc->type == NRFX_TWIM_XFER_RX)
+        {
+            p_desc->p_primary_buf += p_desc->primary_length;
+        }
+        else
+        {
+            p_desc->p_secondary_buf += p_desc->secondary_length;
+        }
+    }
+
+    emu_ppi_event(p_bus->base + TWIM_EVENT_STOPPED);
+}
+
+/* START task triggered through PPI, runs the transfer last set up with the hold flag. */
+static void twim_task_start(void * p_context)
+{
+    bus_t *              p_bus = (bus_t *)p_context;
+    nrfx_twim_evt_type_t type;
+    uint64_t             time;
+
+    if (!p_bus->held_valid)
+    {
+        return;
+    }
+    if (p_bus->busy || p_bus->ppi_busy)
+    {
+        m_stats.collisions++;
+        return;
+    }
+
+    if (twim_run(p_bus, &p_bus->held, &type, &time) != NRFX_SUCCESS)
+    {
+        return;
+    }
+
+    m_stats.ppi_xfers++;
+    p_bus->ppi_busy = true;
+    emu_hw_event_post(time, twim_ppi_stopped, p_bus);
+}
+
+uint32_t nrfx_twim_start_task_get(nrfx_twim_t const * p_instance, nrfx_twim_xfer_type_t xfer_type)
+{
+    return TWIM_BASE(p_instance->drv_inst_idx) +
+           ((xfer_type == NRFX_TWIM_XFER_RX) ? TWIM_TASK_STARTRX : TWIM_TASK_STARTTX);
+}
+
+uint32_t nrfx_twim_stopped_event_get(nrfx_twim_t const * p_instance)
+{
+    return TWIM_BASE(p_instance->drv_inst_idx) + TWIM_EVENT_STOPPED;
+}
+
+nrfx_err_t nrfx_twim_init(nrfx_twim_t const *        p_instance,
+                          nrfx_twim_config_t const * p_config,
+                          nrfx_twim_evt_handler_t    event_handler,
+                          void *                     p_context)
+{
+    bus_t * p_bus;
+
+    if (p_instance->drv_inst_idx >= EMU_TWI_BUSES)
+    {
+        return NRFX_ERROR_INVALID_PARAM;
+    }
+
+    p_bus               = &m_buses[p_instance->drv_inst_idx];
+    p_bus->driver       = BUS_TWIM;
+    p_bus->frequency    = frequency_hz(p_config->frequency);
+    p_bus->twim_handler = event_handler;
+    p_bus->p_context    = p_context;
+    p_bus->busy         = false;
+    p_bus->base         = TWIM_BASE(p_instance->drv_inst_idx);
+
+    emu_ppi_task_register(p_bus->base + TWIM_TASK_STARTRX, twim_task_start, p_bus);
+    emu_ppi_task_register(p_bus->base + TWIM_TASK_STARTTX, twim_task_start, p_bus);
+
+    return NRFX_SUCCESS;
+}
+
+void nrfx_twim_uninit(nrfx_twim_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+void nrfx_twim_enable(nrfx_twim_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+void nrfx_twim_disable(nrfx_twim_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+bool nrfx_twim_is_busy(nrfx_twim_t const * p_instance)
+{
+    return m_buses[p_instance->drv_inst_idx].busy;
+}
+
+nrfx_err_t nrfx_twim_xfer(nrfx_twim_t const *           p_instance,
+                          nrfx_twim_xfer_desc_t const * p_xfer_desc,
+                          uint32_t                      flags)
+{
+    bus_t *    p_bus = &m_buses[p_instance->drv_inst_idx];
+    nrfx_err_t err_code;
+    uint64_t   time;
+
+    if (p_bus->busy)
+    {
+        return NRFX_ERROR_BUSY;
+    }
+
+    /* The driver does not know about transfers started through PPI */
+    if (p_bus->ppi_busy)
+    {
+        m_stats.collisions++;
+    }
+
+    m_stats.driver_calls++;
+
+    if ((flags & NRFX_TWIM_FLAG_HOLD_XFER) != 0U)
+    {
+        p_bus->held       = *p_xfer_desc;
+        p_bus->held_flags = flags;
+        p_bus->held_valid = true;
+
+        return NRFX_SUCCESS;
+    }
+
+    p_bus->held_valid         = false;
+    p_bus->twim_evt.xfer_desc = *p_xfer_desc;
+
+    err_code = twim_run(p_bus, p_xfer_desc, &p_bus->twim_evt.type, &time);
+    if (err_code != NRFX_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_bus->busy = true;
+    emu_irq_post(time, twim_irq, p_bus);
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_twi_init(nrfx_twi_t const *        p_instance,
+                         nrfx_twi_config_t const * p_config,
+                         nrfx_twi_evt_handler_t    event_handler,
+                         void *                    p_context)
+{
+    bus_t * p_bus;
+
+    if (p_instance->drv_inst_idx >= EMU_TWI_BUSES)
+    {
+        return NRFX_ERROR_INVALID_PARAM;
+    }
+
+    p_bus              = &m_buses[p_instance->drv_inst_idx];
+    p_bus->driver      = BUS_TWI;
+    p_bus->frequency   = frequency_hz(p_config->frequency);
+    p_bus->twi_handler = event_handler;
+    p_bus->p_context   = p_context;
+    p_bus->busy        = false;
+
+    return NRFX_SUCCESS;
+}
+
+void nrfx_twi_uninit(nrfx_twi_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+void nrfx_twi_enable(nrfx_twi_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+void nrfx_twi_disable(nrfx_twi_t const * p_instance)
+{
+    UNUSED_PARAMETER(p_instance);
+}
+
+bool nrfx_twi_is_busy(nrfx_twi_t const * p_instance)
+{
+    return m_buses[p_instance->drv_inst_idx].busy;
+}
+
+/* The legacy TWI peripheral moves one byte per interrupt, plus the final STOPPED or
+ * SUSPENDED event.
+ */
+static nrfx_err_t twi_segment(bus_t * p_bus, nrfx_twi_xfer_type_t type, uint8_t address,
+                              uint8_t * p_data, size_t length, bool stop)
+{
+    emu_twi_slave_t const * p_slave = slave_get(p_bus, address);
+    uint64_t                time;
+
+    if (p_bus->busy)
+    {
+        return NRFX_ERROR_BUSY;
+    }
+
+    m_stats.driver_calls++;
+    p_bus->twi_evt.xfer_desc.type           = type;
+    p_bus->twi_evt.xfer_desc.address        = address;
+    p_bus->twi_evt.xfer_desc.primary_length = length;
+    p_bus->twi_evt.xfer_desc.p_primary_buf  = p_data;
+
+    if (p_slave == NULL)
+    {
+        p_bus->twi_evt.type = NRFX_TWI_EVT_ADDRESS_NACK;
+        time = segment_run(p_bus, 0U, true);
+        m_stats.interrupts++;
+    }
+    else
+    {
+        p_bus->twi_evt.type = NRFX_TWI_EVT_DONE;
+
+        if (type == NRFX_TWI_XFER_TX)
+        {
+            (void)p_slave->write(p_slave->p_context, p_data, length);
+        }
+        else
+        {
+            p_slave->read(p_slave->p_context, p_data, length);
+        }
+
+        time = segment_run(p_bus, length, stop);
+        m_stats.interrupts += (uint32_t)length + 1U;
+    }
+
+    p_bus->busy = true;
+    emu_irq_post(time, twi_irq, p_bus);
+
+    return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_twi_tx(nrfx_twi_t const * p_instance,
+                       uint8_t            address,
+                       uint8_t const *    p_data,
+                       size_t             length,
+                       bool               no_stop)
+{
+    return twi_segment(&m_buses[p_instance->drv_inst_idx], NRFX_TWI_XFER_TX, address, (uint8_t *)p_data, length, !no_stop);
+}
+
+nrfx_err_t nrfx_twi_rx(nrfx_twi_t const * p_instance,
+                       uint8_t            address,
+                       uint8_t *          p_data,
+                       size_t             length)
+{
+    return twi_segment(&m_buses[p_instance->drv_inst_idx], NRFX_TWI_XFER_RX, address, p_data, length, true);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup emu_twi Emulated TWI and TWIM drivers
+ * @{
+ * @brief nrfx_twi and nrfx_twim API implemented on top of the nPM1300 emulator.
+ *
+ * @details Each driver call runs against the register model immediately, and the
+ *          completion interrupt is posted after the time the transfer would take on the
+ *          bus: 9 clocks per byte including the address byte, plus one clock for each
+ *          start, repeated start and stop condition.
+ *
+ *          Each driver instance index is a bus of its own, with nPM1300 emulator device n
+ *          always on bus n. Other devices can be added with @ref emu_twi_bus_slave_add.
+ *          Transfers to an address without a device end with an address NACK.
+ *
+ *          A TWIM transfer set up with NRFX_TWIM_FLAG_HOLD_XFER runs each time its start
+ *          task is triggered through PPI (see emu_ppi.h), and its end signals the STOPPED
+ *          event there. Starting a transfer while another is on the bus is counted as a
+ *          collision.
+ */
+
+#ifndef EMU_TWI_H__
+#define EMU_TWI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of buses, TWI and TWIM instances 0 and 1. */
+#define EMU_TWI_BUSES 2U
+
+/** @brief Maximum number of devices on a bus, the nPM1300 included. */
+#define EMU_TWI_SLAVES_MAX 8
+
+/** @brief Device on the emulated bus. */
+typedef struct
+{
+    uint8_t address;                                                   /**< 7-bit address. */
+    bool (* write)(void * p_context, uint8_t const * p_data, size_t len); /**< Returns false on a NACK. */
+    void (* read)(void * p_context, uint8_t * p_data, size_t len);     /**< Read after a (repeated) start. */
+    void *  p_context;                                                 /**< Passed to the callbacks. */
+} emu_twi_slave_t;
+
+/** @brief Bus counters, summed over all buses. */
+typedef struct
+{
+    uint32_t transactions; /**< Bus transactions, from start to stop condition. */
+    uint32_t driver_calls; /**< Transfers started through the driver API. */
+    uint32_t bytes;        /**< Bytes on the bus, address bytes included. */
+    uint32_t interrupts;   /**< TWI interrupts taken by the CPU. */
+    uint64_t bus_time_ns;  /**< Time the bus was busy. */
+    uint32_t ppi_xfers;    /**< TWIM transfers started through PPI. */
+    uint32_t collisions;   /**< Transfers started while another one was on the bus. */
+} emu_twi_stats_t;
+
+/**
+ * @brief Function for adding a device to a bus.
+ *
+ * @param[in] bus     Bus, the index of the driver instance.
+ * @param[in] p_slave Device, must stay valid.
+ *
+ * @return False if the bus does not exist, the address is taken or the bus is full.
+ */
+bool emu_twi_bus_slave_add(uint8_t bus, emu_twi_slave_t const * p_slave);
+
+/**
+ * @brief Function for adding a device to bus 0.
+ */
+bool emu_twi_slave_add(emu_twi_slave_t const * p_slave);
+
+/**
+ * @brief Function for getting the bus counters.
+ */
+void emu_twi_stats_get(emu_twi_stats_t * p_stats);
+
+/**
+ * @brief Function for clearing the bus counters.
+ */
+void emu_twi_stats_reset(void);
+
+/**
+ * @brief Function for getting the clock of bus 0 set by the driver configuration, in Hz.
+ */
+uint32_t emu_twi_frequency_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_TWI_H__
+
+/** @} */
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+
+/* nPM1300 base addresses */
+#define MAIN_BASE 0x00U
+#define VBUS_BASE 0x02U
+#define CHGR_BASE 0x03U
+#define BUCK_BASE 0x04U
+#define ADC_BASE  0x05U
+#define GPIO_BASE 0x06U
+#define LDSW_BASE 0x08U
+
+/* Charger registers */
+#define CHGR_OFFSET_EN_SET     0x04U
+#define CHGR_OFFSET_EN_CLR     0x05U
+#define CHGR_OFFSET_ISET       0x08U
+#define CHGR_OFFSET_ISET_DISCHG 0x0AU
+#define CHGR_OFFSET_VTERM      0x0CU
+#define CHGR_OFFSET_CHG_STAT   0x34U
+#define CHGR_OFFSET_ERR_REASON 0x36U
+
+/* CHG_STAT bits */
+#define CHG_STAT_BAT_DETECTED  0x01U
+#define CHG_STAT_COMPLETED     0x02U
+#define CHG_STAT_TRICKLE       0x04U
+#define CHG_STAT_CC            0x08U
+#define CHG_STAT_CV            0x10U
+
+/* ADC tasks and configuration */
+#define ADC_OFFSET_TASK_VBAT   0x00U
+#define ADC_OFFSET_TASK_TEMP   0x01U
+#define ADC_OFFSET_TASK_DIE    0x02U
+#define ADC_OFFSET_TASK_VSYS   0x03U
+#define ADC_OFFSET_TASK_IBAT   0x06U
+#define ADC_OFFSET_TASK_VBUS   0x07U
+#define ADC_OFFSET_IBAT_EN     0x24U
+
+/* ADC results, MSBs hold the upper 8 bits of the 10-bit codes */
+#define ADC_OFFSET_IBAT_STAT   0x10U
+#define ADC_OFFSET_MSB_VBAT    0x11U
+#define ADC_OFFSET_MSB_NTC     0x12U
+#define ADC_OFFSET_MSB_DIE     0x13U
+#define ADC_OFFSET_MSB_VSYS    0x14U
+#define ADC_OFFSET_LSB_A       0x15U
+#define ADC_OFFSET_MSB_IBAT    0x18U
+#define ADC_OFFSET_MSB_VBUS    0x19U
+#define ADC_OFFSET_LSB_B       0x1AU
+
+#define ADC_LSB_VBAT_SHIFT 0U
+#define ADC_LSB_NTC_SHIFT  2U
+#define ADC_LSB_DIE_SHIFT  4U
+#define ADC_LSB_VSYS_SHIFT 6U
+#define ADC_LSB_IBAT_SHIFT 4U
+#define ADC_LSB_VBUS_SHIFT 6U
+
+/* Ibat status */
+#define IBAT_STAT_DISCHARGE      0x04U
+#define IBAT_STAT_CHARGE_TRICKLE 0x0CU
+#define IBAT_STAT_CHARGE_NORMAL  0x0FU
+
+/* Event groups in the MAIN block: SET, CLR, INTENSET, INTENCLR */
+#define EVENTS_GROUP_FIRST     0x02U
+#define EVENTS_GROUP_LAST      0x22U
+#define EVENTS_BCHARGER1       0x0AU
+#define EVENTS_BCHARGER2       0x0EU
+#define EVENTS_VBUSIN0         0x16U
+#define EVENTS_OFFSET_SET      0x00U
+#define EVENTS_OFFSET_CLR      0x01U
+#define EVENTS_OFFSET_INTENSET 0x02U
+#define EVENTS_OFFSET_INTENCLR 0x03U
+
+#define EVENT_CHG_TRICKLE      0x02U
+#define EVENT_CHG_CC           0x04U
+#define EVENT_CHG_CV           0x08U
+#define EVENT_CHG_COMPLETED    0x10U
+#define EVENT_BAT_DETECTED     0x01U
+#define EVENT_BAT_REMOVED      0x02U
+#define EVENT_VBUS_DETECTED    0x01U
+#define EVENT_VBUS_REMOVED     0x02U
+
+/* GPIO modes */
+#define GPIO_OFFSET_MODE       0x00U
+#define GPIO_COUNT             5U
+#define GPIO_MODE_GPOIRQ       0x05U
+
+/* VBUS status */
+#define VBUS_OFFSET_STATUS     0x07U
+#define VBUS_STATUS_PRESENT    0x01U
+
+/* Thresholds of the charger state machine */
+#define VBUS_DETECT_V     4.0f
+#define TRICKLE_V         2.9f
+#define CV_MARGIN_V       0.005f
+#define NTC_BETA          3380.0f
+
+/* ADC conversions run one after the other, the result registers change when one completes */
+#define ADC_CONVERSION_NS 200000ULL
+
+/* ADC conversions are posted with the device index above the task offset */
+#define ADC_CONTEXT(_device, _offset) ((void *)(uintptr_t)(((uint32_t)(_device) << 8) | (_offset)))
+
+typedef struct
+{
+    uint8_t              regs[256][256];
+    uint8_t              base;
+    uint8_t              offset;
+    bool                 charging_enabled;
+    npm1300_emu_inputs_t inputs;
+    npm1300_emu_stats_t  stats;
+    bool                 int_level;
+    uint64_t             adc_busy_ns;
+} device_t;
+
+static device_t                  m_devices[NPM1300_EMU_DEVICES];
+static device_t                * mp_selected = &m_devices[0];
+static npm1300_emu_int_handler_t m_int_handler;
+
+static uint16_t code_clamp(float code)
+{
+    if (code < 0.f)
+    {
+        return 0;
+    }
+    if (code > 1023.f)
+    {
+        return 1023;
+    }
+    return (uint16_t)lrintf(code);
+}
+
+/* Store a 10-bit ADC code: upper 8 bits in the MSB register, 2 bits in a shared LSB register. */
+static void adc_result_set(device_t * p_dev, uint8_t msb_offset, uint8_t lsb_offset,
+                           uint8_t lsb_shift, uint16_t code)
+{
+    uint8_t * p_lsb = &p_dev->regs[ADC_BASE][lsb_offset];
+
+    p_dev->regs[ADC_BASE][msb_offset] = (uint8_t)(code >> 2);
+    *p_lsb = (uint8_t)((*p_lsb & ~(0x03U << lsb_shift)) | ((code & 0x03U) << lsb_shift));
+}
+
+static void charger_get(device_t const * p_dev, npm1300_emu_charger_t * p_charger)
+{
+    uint16_t iset   = ((uint16_t)p_dev->regs[CHGR_BASE][CHGR_OFFSET_ISET] << 1) |
+                      (p_dev->regs[CHGR_BASE][CHGR_OFFSET_ISET + 1U] & 0x01U);
+    uint16_t idisch = ((uint16_t)p_dev->regs[CHGR_BASE][CHGR_OFFSET_ISET_DISCHG] << 1) |
+                      (p_dev->regs[CHGR_BASE][CHGR_OFFSET_ISET_DISCHG + 1U] & 0x01U);
+    uint8_t  vterm  = p_dev->regs[CHGR_BASE][CHGR_OFFSET_VTERM];
+
+    p_charger->enabled = p_dev->charging_enabled;
+    p_charger->iset    = iset * 0.002f;
+    p_charger->idischg = (idisch >= 83U) ? (0.26809f + (idisch - 83U) * 0.00323f) : 0.f;
+    p_charger->vterm   = (vterm < 4U) ? (3.5f + vterm * 0.05f) : (4.0f + (vterm - 4U) * 0.05f);
+}
+
+void npm1300_emu_charger_get(npm1300_emu_charger_t * p_charger)
+{
+    charger_get(mp_selected, p_charger);
+}
+
+static uint8_t charger_status_get(device_t const * p_dev, npm1300_emu_charger_t const * p_charger)
+{
+    uint8_t status = CHG_STAT_BAT_DETECTED;
+
+    if (!p_charger->enabled || (p_dev->inputs.vbus < VBUS_DETECT_V))
+    {
+        return status;
+    }
+
+    if (p_dev->inputs.vbat < TRICKLE_V)
+    {
+        status |= CHG_STAT_TRICKLE;
+    }
+    else if (p_dev->inputs.vbat < (p_charger->vterm - CV_MARGIN_V))
+    {
+        status |= CHG_STAT_CC;
+    }
+    else if (-p_dev->inputs.ibat > (p_charger->iset / 10.f))
+    {
+        status |= CHG_STAT_CV;
+    }
+    else
+    {
+        status |= CHG_STAT_COMPLETED;
+    }
+
+    return status;
+}
+
+/* Drive the interrupt output: high while an enabled event is pending on a GPIO in IRQ mode. */
+static void int_update(device_t * p_dev)
+{
+    bool level  = false;
+    bool output = false;
+
+    for (uint8_t i = 0; i < GPIO_COUNT; i++)
+    {
+        output |= (p_dev->regs[GPIO_BASE][GPIO_OFFSET_MODE + i] == GPIO_MODE_GPOIRQ);
+    }
+
+    for (uint8_t group = EVENTS_GROUP_FIRST; group <= EVENTS_GROUP_LAST; group += 4U)
+    {
+        level |= (p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_SET] &
+                  p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_INTENSET]) != 0U;
+    }
+
+    level = level && output;
+
+    if (level != p_dev->int_level)
+    {
+        p_dev->int_level = level;
+
+        if (m_int_handler != NULL)
+        {
+            m_int_handler((uint8_t)(p_dev - m_devices), level);
+        }
+    }
+}
+
+/* SET and CLR both read back the pending events, INTENSET and INTENCLR the enabled ones. */
+static void event_raise(device_t * p_dev, uint8_t group, uint8_t mask)
+{
+    if (mask == 0U)
+    {
+        return;
+    }
+
+    p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_SET] |= mask;
+    p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_CLR]  = p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_SET];
+    p_dev->stats.events++;
+}
+
+static void event_reg_write(device_t * p_dev, uint8_t offset, uint8_t value)
+{
+    uint8_t   group    = offset - ((offset - EVENTS_GROUP_FIRST) % 4U);
+    uint8_t * p_events = &p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_SET];
+    uint8_t * p_inten  = &p_dev->regs[MAIN_BASE][group + EVENTS_OFFSET_INTENSET];
+
+    switch (offset - group)
+    {
+        case EVENTS_OFFSET_SET:
+            *p_events |= value;
+            break;
+        case EVENTS_OFFSET_CLR:
+            *p_events &= (uint8_t)~value;
+            break;
+        case EVENTS_OFFSET_INTENSET:
+            *p_inten |= value;
+            break;
+        default:
+            *p_inten &= (uint8_t)~value;
+            break;
+    }
+
+    p_events[EVENTS_OFFSET_CLR - EVENTS_OFFSET_SET]          = *p_events;
+    p_inten[EVENTS_OFFSET_INTENCLR - EVENTS_OFFSET_INTENSET] = *p_inten;
+}
+
+/* Refresh the status registers that follow the inputs without a task, and raise the events
+ * of the changes.
+ */
+static void status_update(device_t * p_dev)
+{
+    npm1300_emu_charger_t charger;
+    uint8_t old_status = p_dev->regs[CHGR_BASE][CHGR_OFFSET_CHG_STAT];
+    uint8_t old_vbus   = p_dev->regs[VBUS_BASE][VBUS_OFFSET_STATUS];
+    uint8_t status;
+    uint8_t vbus;
+
+    charger_get(p_dev, &charger);
+
+    status = charger_status_get(p_dev, &charger);
+    vbus   = (p_dev->inputs.vbus >= VBUS_DETECT_V) ? VBUS_STATUS_PRESENT : 0U;
+
+    p_dev->regs[CHGR_BASE][CHGR_OFFSET_CHG_STAT] = status;
+    p_dev->regs[VBUS_BASE][VBUS_OFFSET_STATUS]   = vbus;
+
+    /* Charge phases entered */
+    event_raise(p_dev, EVENTS_BCHARGER1,
+                (((status & ~old_status & CHG_STAT_TRICKLE) != 0U)   ? EVENT_CHG_TRICKLE   : 0U) |
+                (((status & ~old_status & CHG_STAT_CC) != 0U)        ? EVENT_CHG_CC        : 0U) |
+                (((status & ~old_status & CHG_STAT_CV) != 0U)        ? EVENT_CHG_CV        : 0U) |
+                (((status & ~old_status & CHG_STAT_COMPLETED) != 0U) ? EVENT_CHG_COMPLETED : 0U));
+    event_raise(p_dev, EVENTS_BCHARGER2,
+                (((status & ~old_status & CHG_STAT_BAT_DETECTED) != 0U) ? EVENT_BAT_DETECTED : 0U) |
+                (((~status & old_status & CHG_STAT_BAT_DETECTED) != 0U) ? EVENT_BAT_REMOVED  : 0U));
+    event_raise(p_dev, EVENTS_VBUSIN0,
+                (((vbus & ~old_vbus & VBUS_STATUS_PRESENT) != 0U) ? EVENT_VBUS_DETECTED : 0U) |
+                (((~vbus & old_vbus & VBUS_STATUS_PRESENT) != 0U) ? EVENT_VBUS_REMOVED  : 0U));
+
+    int_update(p_dev);
+}
+
+static void adc_ibat_convert(device_t * p_dev)
+{
+    npm1300_emu_charger_t charger;
+    uint8_t status;
+    float   full_scale;
+
+    charger_get(p_dev, &charger);
+    status = charger_status_get(p_dev, &charger);
+
+    if ((status & CHG_STAT_TRICKLE) != 0U)
+    {
+        p_dev->regs[ADC_BASE][ADC_OFFSET_IBAT_STAT] = IBAT_STAT_CHARGE_TRICKLE;
+        full_scale = charger.iset / 10.f;
+    }
+    else if ((status & (CHG_STAT_CC | CHG_STAT_CV)) != 0U)
+    {
+        p_dev->regs[ADC_BASE][ADC_OFFSET_IBAT_STAT] = IBAT_STAT_CHARGE_NORMAL;
+        full_scale = charger.iset;
+    }
+    else
+    {
+        p_dev->regs[ADC_BASE][ADC_OFFSET_IBAT_STAT] = IBAT_STAT_DISCHARGE;
+        full_scale = charger.idischg;
+    }
+
+    adc_result_set(p_dev, ADC_OFFSET_MSB_IBAT, ADC_OFFSET_LSB_B, ADC_LSB_IBAT_SHIFT,
+                   (full_scale > 0.f) ? code_clamp(fabsf(p_dev->inputs.ibat) * 1024.f / full_scale) : 0U);
+}
+
+/* Conversion of a task, at the time it completes */
+static void adc_convert(void * p_context)
+{
+    device_t * p_dev  = &m_devices[(uintptr_t)p_context >> 8];
+    uint8_t    offset = (uint8_t)(uintptr_t)p_context;
+    float      t_kelvin;
+
+    switch (offset)
+    {
+        case ADC_OFFSET_TASK_VBAT:
+            adc_result_set(p_dev, ADC_OFFSET_MSB_VBAT, ADC_OFFSET_LSB_A, ADC_LSB_VBAT_SHIFT,
+                           code_clamp(p_dev->inputs.vbat * 1024.f / 5.f));
+            /* Automatic IBAT measurement follows every VBAT conversion */
+            if ((p_dev->regs[ADC_BASE][ADC_OFFSET_IBAT_EN] & 0x01U) != 0U)
+            {
+                adc_ibat_convert(p_dev);
+            }
+            break;
+
+        case ADC_OFFSET_TASK_TEMP:
+            /* Voltage divider of the NTC against a resistor of its nominal value */
+            t_kelvin = p_dev->inputs.tbat + 273.15f;
+            adc_result_set(p_dev, ADC_OFFSET_MSB_NTC, ADC_OFFSET_LSB_A, ADC_LSB_NTC_SHIFT,
+                           code_clamp(1024.f / (1.f + expf(NTC_BETA * ((1.f / 298.15f) - (1.f / t_kelvin))))));
+            break;
+
+        case ADC_OFFSET_TASK_DIE:
+            adc_result_set(p_dev, ADC_OFFSET_MSB_DIE, ADC_OFFSET_LSB_A, ADC_LSB_DIE_SHIFT,
+                           code_clamp((394.67f - p_dev->inputs.tdie) * 5000.f / 3963.f));
+            break;
+
+        case ADC_OFFSET_TASK_VSYS:
+            adc_result_set(p_dev, ADC_OFFSET_MSB_VSYS, ADC_OFFSET_LSB_A, ADC_LSB_VSYS_SHIFT,
+                           code_clamp(p_dev->inputs.vsys * 1024.f / 6.375f));
+            break;
+
+        case ADC_OFFSET_TASK_IBAT:
+            adc_ibat_convert(p_dev);
+            break;
+
+        case ADC_OFFSET_TASK_VBUS:
+            adc_result_set(p_dev, ADC_OFFSET_MSB_VBUS, ADC_OFFSET_LSB_B, ADC_LSB_VBUS_SHIFT,
+                           code_clamp(p_dev->inputs.vbus * 1024.f / 7.5f));
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void adc_task(device_t * p_dev, uint8_t offset)
+{
+    uint64_t now         = emu_time_ns_get();
+    uint32_t conversions = 1U;
+
+    p_dev->stats.adc_tasks++;
+
+    /* Automatic IBAT measurement is a conversion of its own */
+    if ((offset == ADC_OFFSET_TASK_VBAT) && ((p_dev->regs[ADC_BASE][ADC_OFFSET_IBAT_EN] & 0x01U) != 0U))
+    {
+        conversions++;
+    }
+
+    p_dev->adc_busy_ns = ((p_dev->adc_busy_ns > now) ? p_dev->adc_busy_ns : now) +
+                         (conversions * ADC_CONVERSION_NS);
+    emu_hw_event_post(p_dev->adc_busy_ns - now, adc_convert,
+                      ADC_CONTEXT(p_dev - m_devices, offset));
+}
+
+static void reg_write(device_t * p_dev, uint8_t base, uint8_t offset, uint8_t value)
+{
+    p_dev->stats.reg_writes++;
+
+    if ((base == ADC_BASE) && (offset <= ADC_OFFSET_TASK_VBUS))
+    {
+        if (value & 0x01U)
+        {
+            adc_task(p_dev, offset);
+        }
+        return;
+    }
+
+    if ((base == MAIN_BASE) && (offset >= EVENTS_GROUP_FIRST) &&
+        (offset <= (EVENTS_GROUP_LAST + EVENTS_OFFSET_INTENCLR)))
+    {
+        event_reg_write(p_dev, offset, value);
+    }
+    else if ((base == CHGR_BASE) && (offset == CHGR_OFFSET_EN_SET))
+    {
+        p_dev->charging_enabled |= (value & 0x01U) != 0U;
+    }
+    else if ((base == CHGR_BASE) && (offset == CHGR_OFFSET_EN_CLR))
+    {
+        p_dev->charging_enabled &= (value & 0x01U) == 0U;
+    }
+    else if ((base == CHGR_BASE) && (offset >= CHGR_OFFSET_CHG_STAT))
+    {
+        /* Read-only status */
+        return;
+    }
+    else
+    {
+        p_dev->regs[base][offset] = value;
+    }
+
+    status_update(p_dev);
+}
+
+void npm1300_emu_reset(void)
+{
+    for (uint32_t i = 0; i < NPM1300_EMU_DEVICES; i++)
+    {
+        device_t * p_dev = &m_devices[i];
+
+        for (uint32_t offset = ADC_OFFSET_TASK_VBAT; offset <= ADC_OFFSET_TASK_VBUS; offset++)
+        {
+            emu_event_cancel(adc_convert, ADC_CONTEXT(i, offset));
+        }
+
+        memset(p_dev, 0, sizeof(*p_dev));
+
+        p_dev->inputs.vbat = 3.8f;
+        p_dev->inputs.ibat = 0.f;
+        p_dev->inputs.tbat = 25.f;
+        p_dev->inputs.tdie = 25.f;
+        p_dev->inputs.vsys = 3.8f;
+        p_dev->inputs.vbus = 0.f;
+
+        status_update(p_dev);
+    }
+
+    mp_selected = &m_devices[0];
+}
+
+void npm1300_emu_select(uint8_t device)
+{
+    if (device < NPM1300_EMU_DEVICES)
+    {
+        mp_selected = &m_devices[device];
+    }
+}
+
+void npm1300_emu_battery_set(float vbat, float ibat, float tbat)
+{
+    device_t * p_dev = mp_selected;
+
+    p_dev->inputs.vbat = vbat;
+    p_dev->inputs.ibat = ibat;
+    p_dev->inputs.tbat = tbat;
+
+    if (p_dev->inputs.vbus < VBUS_DETECT_V)
+    {
+        p_dev->inputs.vsys = vbat;
+    }
+
+    status_update(p_dev);
+}
+
+void npm1300_emu_vbus_set(float vbus)
+{
+    device_t * p_dev = mp_selected;
+
+    p_dev->inputs.vbus = vbus;
+    p_dev->inputs.vsys = (vbus >= VBUS_DETECT_V) ? 4.5f : p_dev->inputs.vbat;
+
+    status_update(p_dev);
+}
+
+npm1300_emu_inputs_t * npm1300_emu_inputs_get(void)
+{
+    return &mp_selected->inputs;
+}
+
+bool npm1300_emu_write(uint8_t device, uint8_t const * p_data, size_t len)
+{
+    device_t * p_dev = &m_devices[device];
+
+    if (len >= 1U)
+    {
+        p_dev->base = p_data[0];
+    }
+    if (len >= 2U)
+    {
+        p_dev->offset = p_data[1];
+    }
+
+    for (size_t i = 2U; i < len; i++)
+    {
+        reg_write(p_dev, p_dev->base, p_dev->offset++, p_data[i]);
+    }
+
+    return true;
+}
+
+void npm1300_emu_read(uint8_t device, uint8_t * p_data, size_t len)
+{
+    device_t * p_dev = &m_devices[device];
+
+    for (size_t i = 0U; i < len; i++)
+    {
+        p_data[i] = p_dev->regs[p_dev->base][p_dev->offset++];
+        p_dev->stats.reg_reads++;
+    }
+}
+
+uint8_t npm1300_emu_reg_get(uint8_t base, uint8_t offset)
+{
+    return mp_selected->regs[base][offset];
+}
+
+void npm1300_emu_reg_set(uint8_t base, uint8_t offset, uint8_t value)
+{
+    mp_selected->regs[base][offset] = value;
+}
+
+void npm1300_emu_int_handler_set(npm1300_emu_int_handler_t handler)
+{
+    m_int_handler = handler;
+}
+
+bool npm1300_emu_int_get(uint8_t device)
+{
+    return m_devices[device].int_level;
+}
+
+void npm1300_emu_stats_get(npm1300_emu_stats_t * p_stats)
+{
+    *p_stats = mp_selected->stats;
+}
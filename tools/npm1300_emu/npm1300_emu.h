@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @defgroup npm1300_emu nPM1300 register emulator
+ * @{
+ * @brief Register-level model of the nPM1300 as seen on its TWI interface.
+ *
+ * @details The first two bytes written in a transfer select the register (base, offset),
+ *          further bytes are written with auto-increment and reads continue from the
+ *          selected register. Writes to task registers start the modelled action:
+ *          ADC conversions take the physical inputs set with @ref npm1300_emu_battery_set
+ *          and @ref npm1300_emu_vbus_set and store them with the MSB/LSB packing of the
+ *          ADC result registers. Conversions are queued and take 200 us each, the automatic
+ *          IBAT conversion after VBAT included, so results read too early are the old ones. Charger status follows VBUS, the charger enable tasks and
+ *          the termination voltage register.
+ *
+ *          Status changes raise the charger, battery and VBUS events in the MAIN block.
+ *          A GPIO in interrupt output mode drives the interrupt line, which is high while
+ *          an event with its interrupt enabled is pending.
+ *
+ *          @ref NPM1300_EMU_DEVICES devices are modelled, device n sits on TWI bus n. The
+ *          bus and interrupt line functions take the device, the others act on the one
+ *          chosen with @ref npm1300_emu_select.
+ */
+
+#ifndef NPM1300_EMU_H__
+#define NPM1300_EMU_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief 7-bit TWI address of the nPM1300. */
+#define NPM1300_EMU_ADDR 0x6BU
+
+/** @brief Number of emulated devices, one per TWI bus. */
+#define NPM1300_EMU_DEVICES 2U
+
+/** @brief Physical inputs sampled by the ADC. */
+typedef struct
+{
+    float vbat;   /**< Battery voltage [V]. */
+    float ibat;   /**< Battery current [A], positive when discharging. */
+    float tbat;   /**< Battery (NTC) temperature [C]. */
+    float tdie;   /**< Die temperature [C]. */
+    float vsys;   /**< VSYS voltage [V]. */
+    float vbus;   /**< VBUS voltage [V], 0 when not attached. */
+} npm1300_emu_inputs_t;
+
+/** @brief Charger settings decoded from the emulated registers. */
+typedef struct
+{
+    bool  enabled;     /**< Charging enabled with the EN_SET task. */
+    float vterm;       /**< Termination voltage [V]. */
+    float iset;        /**< Charge current [A]. */
+    float idischg;     /**< Discharge current limit [A]. */
+} npm1300_emu_charger_t;
+
+/** @brief Counters of register accesses. */
+typedef struct
+{
+    uint32_t reg_writes;  /**< Registers written, one per byte. */
+    uint32_t reg_reads;   /**< Registers read, one per byte. */
+    uint32_t adc_tasks;   /**< ADC conversions started. */
+    uint32_t events;      /**< Event register updates raised by status changes. */
+} npm1300_emu_stats_t;
+
+/**
+ * @brief Interrupt line change handler.
+ *
+ * @param[in] device Device whose interrupt output changed.
+ * @param[in] level  New level of the interrupt output.
+ */
+typedef void (*npm1300_emu_int_handler_t)(uint8_t device, bool level);
+
+/**
+ * @brief Function for resetting the register space of all devices to power-on defaults.
+ *
+ * @details Device 0 is selected afterwards.
+ */
+void npm1300_emu_reset(void);
+
+/**
+ * @brief Function for selecting the device the inputs, charger, register and counter
+ *        functions act on. Unknown devices are ignored.
+ */
+void npm1300_emu_select(uint8_t device);
+
+/**
+ * @brief Function for setting the battery values seen by the next ADC conversions.
+ */
+void npm1300_emu_battery_set(float vbat, float ibat, float tbat);
+
+/**
+ * @brief Function for attaching or removing VBUS.
+ *
+ * @param[in] vbus VBUS voltage [V], 0 to remove it.
+ */
+void npm1300_emu_vbus_set(float vbus);
+
+/**
+ * @brief Function for getting the current physical inputs.
+ */
+npm1300_emu_inputs_t * npm1300_emu_inputs_get(void);
+
+/**
+ * @brief Function for getting the charger settings programmed by the driver.
+ */
+void npm1300_emu_charger_get(npm1300_emu_charger_t * p_charger);
+
+/**
+ * @brief Function for writing a TWI transfer payload to a device.
+ *
+ * @param[in] device Device on the bus of the transfer.
+ * @param[in] p_data Bytes following the address byte.
+ * @param[in] len    Number of bytes.
+ *
+ * @return False if a byte was not acknowledged.
+ */
+bool npm1300_emu_write(uint8_t device, uint8_t const * p_data, size_t len);
+
+/**
+ * @brief Function for reading from the selected register of a device with auto-increment.
+ */
+void npm1300_emu_read(uint8_t device, uint8_t * p_data, size_t len);
+
+/**
+ * @brief Function for direct register access, bypassing the bus and the task logic.
+ */
+uint8_t npm1300_emu_reg_get(uint8_t base, uint8_t offset);
+
+/** @copydoc npm1300_emu_reg_get */
+void npm1300_emu_reg_set(uint8_t base, uint8_t offset, uint8_t value);
+
+/**
+ * @brief Function for setting the handler of interrupt line changes.
+ */
+void npm1300_emu_int_handler_set(npm1300_emu_int_handler_t handler);
+
+/**
+ * @brief Function for getting the level of the interrupt line of a device.
+ */
+bool npm1300_emu_int_get(uint8_t device);
+
+/**
+ * @brief Function for getting the register access counters.
+ */
+void npm1300_emu_stats_get(npm1300_emu_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NPM1300_EMU_H__
+
+/** @} */
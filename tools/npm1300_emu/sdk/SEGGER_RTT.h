@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the SEGGER RTT up channels, see emu_log.c. Channels other than 0
+ * are written to stdout as they are, channel 0 is dropped. Nothing is ever typed into the
+ * terminal.
+ */
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP         0
+#define SEGGER_RTT_MODE_NO_BLOCK_TRIM         1
+#define SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL    2
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char * sName, void * pBuffer,
+                              unsigned BufferSize, unsigned Flags);
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void * pBuffer, unsigned NumBytes);
+
+int SEGGER_RTT_HasKey(void);
+
+int SEGGER_RTT_GetKey(void);
+
+#endif // SEGGER_RTT_H
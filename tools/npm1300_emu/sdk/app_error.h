@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for app_error.h. Errors abort the emulation with the failing location. */
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+void emu_error_handler(ret_code_t error_code, const char * p_file, uint32_t line);
+
+#define APP_ERROR_CHECK(ERR_CODE)                                              \
+    do                                                                         \
+    {                                                                          \
+        const uint32_t LOCAL_ERR_CODE = (ERR_CODE);                            \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS)                                     \
+        {                                                                      \
+            emu_error_handler(LOCAL_ERR_CODE, __FILE__, __LINE__);             \
+        }                                                                      \
+    } while (0)
+
+#define APP_ERROR_CHECK_BOOL(BOOLEAN_VALUE)                                    \
+    do                                                                         \
+    {                                                                          \
+        if (!(BOOLEAN_VALUE))                                                  \
+        {                                                                      \
+            emu_error_handler(0, __FILE__, __LINE__);                          \
+        }                                                                      \
+    } while (0)
+
+#endif // APP_ERROR_H__
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for app_timer (app_timer2 flavour) running on simulated time,
+ * see emu_platform.c.
+ */
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_common.h"
+
+#define APP_TIMER_CLOCK_FREQ         32768
+#define APP_TIMER_MIN_TIMEOUT_TICKS  5
+#define APP_TIMER_MAX_CNT_VAL        0x00FFFFFFUL
+
+#define APP_TIMER_TICKS(MS)                                                    \
+    ((uint32_t)ROUNDED_DIV((MS) * (uint64_t)APP_TIMER_CLOCK_FREQ,              \
+                           1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)))
+
+typedef void (* app_timer_timeout_handler_t)(void * p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED,
+} app_timer_mode_t;
+
+typedef struct app_timer_s
+{
+    struct app_timer_s *        p_next;
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t            mode;
+    bool                        active;
+    uint64_t                    expiry;
+    uint32_t                    period;
+    void *                      p_context;
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+#define APP_TIMER_DEF(timer_id)                                                \
+    static app_timer_t CONCAT_2(timer_id, _data);                              \
+    static const app_timer_id_t timer_id = &CONCAT_2(timer_id, _data)
+
+ret_code_t app_timer_init(void);
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler);
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context);
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+uint32_t app_timer_cnt_get(void);
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+#endif // APP_TIMER_H__
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for app_util_platform.h. The emulator runs interrupt handlers from
+ * emu_wfe() only, so thread code is never preempted and critical regions are empty.
+ */
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include "sdk_common.h"
+
+#define APP_IRQ_PRIORITY_HIGHEST 0
+#define APP_IRQ_PRIORITY_HIGH    2
+#define APP_IRQ_PRIORITY_MID     4
+#define APP_IRQ_PRIORITY_LOW     6
+#define APP_IRQ_PRIORITY_LOWEST  7
+
+#define CRITICAL_REGION_ENTER()  {
+#define CRITICAL_REGION_EXIT()   }
+
+#endif // APP_UTIL_PLATFORM_H__
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the crc32 library, see emu_flash.c. */
+#ifndef CRC32_H__
+#define CRC32_H__
+
+#include <stdint.h>
+
+uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+#endif // CRC32_H__
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the CMSIS core intrinsics and debug registers used by the driver. */
+#ifndef NRF_H__
+#define NRF_H__
+
+#include <stdint.h>
+
+/* Sleeping hands control to the emulator, which runs the next pending interrupt. */
+void emu_wfe(void);
+
+#define __WFE() emu_wfe()
+#define __SEV() ((void)0)
+
+/* Cycle counter of the debug unit. Reading CYCCNT through DWT gives the CPU time of the host
+ * thread at 64 MHz, without the peripheral events run while the CPU sleeps, see emu_platform.c.
+ */
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+DWT_Type * emu_dwt_get(void);
+
+extern CoreDebug_Type emu_core_debug;
+
+#define DWT       (emu_dwt_get())
+#define CoreDebug (&emu_core_debug)
+
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+#endif // NRF_H__
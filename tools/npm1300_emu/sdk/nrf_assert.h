@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for nrf_assert.h. */
+#ifndef NRF_ASSERT_H_
+#define NRF_ASSERT_H_
+
+#include <assert.h>
+
+#define ASSERT(expr) assert(expr)
+
+#endif // NRF_ASSERT_H_
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrf_fstorage library, see emu_flash.c. Types and signatures
+ * follow nRF5 SDK 17.1, instances are plain variables instead of a linker section.
+ */
+#ifndef NRF_FSTORAGE_H__
+#define NRF_FSTORAGE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_FSTORAGE_EVT_READ_RESULT,
+    NRF_FSTORAGE_EVT_WRITE_RESULT,
+    NRF_FSTORAGE_EVT_ERASE_RESULT
+} nrf_fstorage_evt_id_t;
+
+typedef struct
+{
+    nrf_fstorage_evt_id_t id;
+    ret_code_t            result;
+    uint32_t              addr;
+    void const *          p_src;
+    uint32_t              len;
+    void *                p_param;
+} nrf_fstorage_evt_t;
+
+typedef void (* nrf_fstorage_evt_handler_t)(nrf_fstorage_evt_t * p_evt);
+
+typedef struct
+{
+    uint32_t erase_unit;
+    uint32_t program_unit;
+    bool     rmap;
+    bool     wmap;
+} nrf_fstorage_info_t;
+
+typedef struct nrf_fstorage_api_s nrf_fstorage_api_t;
+
+typedef struct
+{
+    nrf_fstorage_api_t const *  p_api;
+    nrf_fstorage_info_t const * p_flash_info;
+    nrf_fstorage_evt_handler_t  evt_handler;
+    uint32_t                    start_addr;
+    uint32_t                    end_addr;
+} nrf_fstorage_t;
+
+#define NRF_FSTORAGE_DEF(inst) inst
+
+ret_code_t nrf_fstorage_init(nrf_fstorage_t * p_fs, nrf_fstorage_api_t * p_api, void * p_param);
+
+ret_code_t nrf_fstorage_read(nrf_fstorage_t const * p_fs, uint32_t addr, void * p_dest,
+                             uint32_t len);
+
+ret_code_t nrf_fstorage_write(nrf_fstorage_t const * p_fs, uint32_t dest, void const * p_src,
+                              uint32_t len, void * p_param);
+
+ret_code_t nrf_fstorage_erase(nrf_fstorage_t const * p_fs, uint32_t page_addr, uint32_t len,
+                              void * p_param);
+
+bool nrf_fstorage_is_busy(nrf_fstorage_t const * p_fs);
+
+#endif // NRF_FSTORAGE_H__
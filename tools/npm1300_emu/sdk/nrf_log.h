@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for nrf_log.h. Only the float formatting helpers are provided. */
+#ifndef NRF_LOG_H_
+#define NRF_LOG_H_
+
+#include <stdint.h>
+
+#define NRF_LOG_FLOAT_MARKER "%s%d.%02d"
+
+#define NRF_LOG_FLOAT(val) (((val) < 0 && (val) > -1.0) ? "-" : ""),             \
+                           (int32_t)(val),                                      \
+                           (int32_t)((((val) > 0) ? (val) - (int32_t)(val)      \
+                                                  : (int32_t)(val) - (val)) * 100)
+
+#define NRF_LOG_INFO(...)    ((void)0)
+#define NRF_LOG_WARNING(...) ((void)0)
+#define NRF_LOG_ERROR(...)   ((void)0)
+#define NRF_LOG_DEBUG(...)   ((void)0)
+
+#endif // NRF_LOG_H_
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement, logging goes straight to stdout. */
+#ifndef NRF_LOG_CTRL_H
+#define NRF_LOG_CTRL_H
+
+#define NRF_LOG_INIT(...) NRF_SUCCESS
+#define NRF_LOG_PROCESS() false
+
+#endif // NRF_LOG_CTRL_H
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the POWER HAL, only the retained register. Zero at start, like
+ * after a power-on reset.
+ */
+#ifndef NRF_POWER_H__
+#define NRF_POWER_H__
+
+#include <stdint.h>
+
+extern uint8_t emu_gpregret;
+
+static inline void nrf_power_gpregret_set(uint8_t val)
+{
+    emu_gpregret = val;
+}
+
+static inline uint8_t nrf_power_gpregret_get(void)
+{
+    return emu_gpregret;
+}
+
+#endif // NRF_POWER_H__
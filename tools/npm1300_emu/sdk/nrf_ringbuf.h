@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrf_ringbuf library, see emu_log.c. Types and signatures
+ * follow nRF5 SDK 17.1, the library is used from thread mode only so nothing is atomic.
+ */
+#ifndef NRF_RINGBUF_H
+#define NRF_RINGBUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_common.h"
+
+typedef struct
+{
+    uint32_t wr_idx;
+    uint32_t tmp_wr_idx;
+    uint32_t rd_idx;
+    uint32_t tmp_rd_idx;
+    bool     wr_busy;
+    bool     rd_busy;
+} nrf_ringbuf_cb_t;
+
+typedef struct
+{
+    uint8_t *          p_buffer;
+    size_t             bufsize_mask;
+    nrf_ringbuf_cb_t * p_cb;
+} nrf_ringbuf_t;
+
+#define NRF_RINGBUF_DEF(_name, _size)                                          \
+    STATIC_ASSERT(IS_POWER_OF_TWO(_size));                                     \
+    static uint8_t CONCAT_2(_name, _buf)[_size];                               \
+    static nrf_ringbuf_cb_t CONCAT_2(_name, _cb);                              \
+    static const nrf_ringbuf_t _name =                                         \
+    {                                                                          \
+        .p_buffer     = CONCAT_2(_name, _buf),                                 \
+        .bufsize_mask = (_size) - 1,                                           \
+        .p_cb         = &CONCAT_2(_name, _cb),                                 \
+    }
+
+void nrf_ringbuf_init(nrf_ringbuf_t const * p_ringbuf);
+
+ret_code_t nrf_ringbuf_alloc(nrf_ringbuf_t const * p_ringbuf, uint8_t ** pp_data,
+                             size_t * p_length, bool start);
+
+ret_code_t nrf_ringbuf_put(nrf_ringbuf_t const * p_ringbuf, size_t length);
+
+ret_code_t nrf_ringbuf_get(nrf_ringbuf_t const * p_ringbuf, uint8_t ** pp_data,
+                           size_t * p_length, bool start);
+
+ret_code_t nrf_ringbuf_free(nrf_ringbuf_t const * p_ringbuf, size_t length);
+
+#endif // NRF_RINGBUF_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx GPIOTE driver API. Input pins are connected to the
+ * interrupt outputs of the nPM1300 emulator devices in the order they are set up, see
+ * emu_gpiote.c. Types and signatures follow nrfx 2.x from nRF5 SDK 17.1.
+ */
+#ifndef NRFX_GPIOTE_H__
+#define NRFX_GPIOTE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+typedef uint32_t nrfx_gpiote_pin_t;
+
+typedef enum
+{
+    NRF_GPIOTE_POLARITY_LOTOHI = 1,
+    NRF_GPIOTE_POLARITY_HITOLO = 2,
+    NRF_GPIOTE_POLARITY_TOGGLE = 3,
+} nrf_gpiote_polarity_t;
+
+typedef enum
+{
+    NRF_GPIO_PIN_NOPULL   = 0,
+    NRF_GPIO_PIN_PULLDOWN = 1,
+    NRF_GPIO_PIN_PULLUP   = 3,
+} nrf_gpio_pin_pull_t;
+
+typedef struct
+{
+    nrf_gpiote_polarity_t sense;
+    nrf_gpio_pin_pull_t   pull;
+    bool                  is_watcher      : 1;
+    bool                  hi_accuracy     : 1;
+    bool                  skip_gpio_setup : 1;
+} nrfx_gpiote_in_config_t;
+
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_LOTOHI(hi_accu) \
+{                                                   \
+    .sense           = NRF_GPIOTE_POLARITY_LOTOHI,  \
+    .pull            = NRF_GPIO_PIN_NOPULL,         \
+    .is_watcher      = false,                       \
+    .hi_accuracy     = hi_accu,                     \
+    .skip_gpio_setup = false,                       \
+}
+
+typedef void (*nrfx_gpiote_evt_handler_t)(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
+
+ret_code_t nrfx_gpiote_init(void);
+bool nrfx_gpiote_is_init(void);
+ret_code_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t               pin,
+                               nrfx_gpiote_in_config_t const * p_config,
+                               nrfx_gpiote_evt_handler_t       evt_handler);
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable);
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin);
+
+#endif // NRFX_GPIOTE_H__
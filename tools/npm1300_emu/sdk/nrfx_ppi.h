@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx PPI allocator. Channels connect the event and task
+ * addresses of the emulated peripherals, see emu_ppi.c. Types and signatures follow
+ * nrfx 2.x from nRF5 SDK 17.1.
+ */
+#ifndef NRFX_PPI_H__
+#define NRFX_PPI_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_PPI_CHANNEL0,
+    NRF_PPI_CHANNEL1,
+    NRF_PPI_CHANNEL2,
+    NRF_PPI_CHANNEL3,
+    NRF_PPI_CHANNEL4,
+    NRF_PPI_CHANNEL5,
+    NRF_PPI_CHANNEL6,
+    NRF_PPI_CHANNEL7,
+    NRF_PPI_CHANNEL8,
+    NRF_PPI_CHANNEL9,
+    NRF_PPI_CHANNEL10,
+    NRF_PPI_CHANNEL11,
+    NRF_PPI_CHANNEL12,
+    NRF_PPI_CHANNEL13,
+    NRF_PPI_CHANNEL14,
+    NRF_PPI_CHANNEL15,
+    NRF_PPI_CHANNEL16,
+    NRF_PPI_CHANNEL17,
+    NRF_PPI_CHANNEL18,
+    NRF_PPI_CHANNEL19,
+} nrf_ppi_channel_t;
+
+nrfx_err_t nrfx_ppi_channel_alloc(nrf_ppi_channel_t * p_channel);
+
+nrfx_err_t nrfx_ppi_channel_free(nrf_ppi_channel_t channel);
+
+nrfx_err_t nrfx_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep);
+
+nrfx_err_t nrfx_ppi_channel_fork_assign(nrf_ppi_channel_t channel, uint32_t fork_tep);
+
+nrfx_err_t nrfx_ppi_channel_enable(nrf_ppi_channel_t channel);
+
+nrfx_err_t nrfx_ppi_channel_disable(nrf_ppi_channel_t channel);
+
+#endif // NRFX_PPI_H__
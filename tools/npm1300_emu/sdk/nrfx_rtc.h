@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx RTC driver API, counting in simulated time, see
+ * emu_timer.c. Types and signatures follow nrfx 2.x from nRF5 SDK 17.1, task and event
+ * values are the register offsets of the HAL.
+ */
+#ifndef NRFX_RTC_H__
+#define NRFX_RTC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_RTC_TASK_START            = 0x000,
+    NRF_RTC_TASK_STOP             = 0x004,
+    NRF_RTC_TASK_CLEAR            = 0x008,
+    NRF_RTC_TASK_TRIGGER_OVERFLOW = 0x00C,
+} nrf_rtc_task_t;
+
+typedef enum
+{
+    NRF_RTC_EVENT_TICK      = 0x100,
+    NRF_RTC_EVENT_OVERFLOW  = 0x104,
+    NRF_RTC_EVENT_COMPARE_0 = 0x140,
+    NRF_RTC_EVENT_COMPARE_1 = 0x144,
+    NRF_RTC_EVENT_COMPARE_2 = 0x148,
+    NRF_RTC_EVENT_COMPARE_3 = 0x14C,
+} nrf_rtc_event_t;
+
+typedef enum
+{
+    NRFX_RTC_INT_COMPARE0 = 0,
+    NRFX_RTC_INT_COMPARE1 = 1,
+    NRFX_RTC_INT_COMPARE2 = 2,
+    NRFX_RTC_INT_COMPARE3 = 3,
+    NRFX_RTC_INT_TICK     = 4,
+    NRFX_RTC_INT_OVERFLOW = 5,
+} nrfx_rtc_int_type_t;
+
+typedef struct
+{
+    uint32_t base;
+    uint8_t  instance_id;
+    uint8_t  cc_channel_count;
+} nrfx_rtc_t;
+
+/* Register base of the nRF52840 RTC instances */
+#define NRFX_RTC_INSTANCE(id)                                                  \
+    {                                                                          \
+        .base             = ((id) == 0) ? 0x4000B000UL :                       \
+                            ((id) == 1) ? 0x40011000UL : 0x40024000UL,         \
+        .instance_id      = (id),                                              \
+        .cc_channel_count = ((id) == 0) ? 3U : 4U,                             \
+    }
+
+typedef struct
+{
+    uint16_t prescaler;
+    uint8_t  interrupt_priority;
+    uint8_t  tick_latency;
+    bool     reliable;
+} nrfx_rtc_config_t;
+
+#define NRFX_RTC_DEFAULT_CONFIG                                                \
+    {                                                                          \
+        .prescaler          = 0,                                               \
+        .interrupt_priority = 6,                                               \
+        .tick_latency       = 66,                                              \
+        .reliable           = false,                                           \
+    }
+
+typedef void (* nrfx_rtc_handler_t)(nrfx_rtc_int_type_t int_type);
+
+nrfx_err_t nrfx_rtc_init(nrfx_rtc_t const *        p_instance,
+                         nrfx_rtc_config_t const * p_config,
+                         nrfx_rtc_handler_t        handler);
+
+void nrfx_rtc_uninit(nrfx_rtc_t const * p_instance);
+
+void nrfx_rtc_enable(nrfx_rtc_t const * p_instance);
+
+void nrfx_rtc_disable(nrfx_rtc_t const * p_instance);
+
+nrfx_err_t nrfx_rtc_cc_set(nrfx_rtc_t const * p_instance,
+                           uint32_t           channel,
+                           uint32_t           val,
+                           bool               enable_irq);
+
+void nrfx_rtc_counter_clear(nrfx_rtc_t const * p_instance);
+
+uint32_t nrfx_rtc_counter_get(nrfx_rtc_t const * p_instance);
+
+uint32_t nrfx_rtc_task_address_get(nrfx_rtc_t const * p_instance, nrf_rtc_task_t task);
+
+uint32_t nrfx_rtc_event_address_get(nrfx_rtc_t const * p_instance, nrf_rtc_event_t event);
+
+#endif // NRFX_RTC_H__
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx TIMER driver API, counter mode only, see emu_timer.c.
+ * Types and signatures follow nrfx 2.x from nRF5 SDK 17.1, task and event values are the
+ * register offsets of the HAL.
+ */
+#ifndef NRFX_TIMER_H__
+#define NRFX_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_TIMER_TASK_START    = 0x000,
+    NRF_TIMER_TASK_STOP     = 0x004,
+    NRF_TIMER_TASK_COUNT    = 0x008,
+    NRF_TIMER_TASK_CLEAR    = 0x00C,
+    NRF_TIMER_TASK_SHUTDOWN = 0x010,
+    NRF_TIMER_TASK_CAPTURE0 = 0x040,
+    NRF_TIMER_TASK_CAPTURE1 = 0x044,
+    NRF_TIMER_TASK_CAPTURE2 = 0x048,
+    NRF_TIMER_TASK_CAPTURE3 = 0x04C,
+} nrf_timer_task_t;
+
+typedef enum
+{
+    NRF_TIMER_EVENT_COMPARE0 = 0x140,
+    NRF_TIMER_EVENT_COMPARE1 = 0x144,
+    NRF_TIMER_EVENT_COMPARE2 = 0x148,
+    NRF_TIMER_EVENT_COMPARE3 = 0x14C,
+} nrf_timer_event_t;
+
+typedef enum
+{
+    NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK = (1UL << 0),
+    NRF_TIMER_SHORT_COMPARE1_CLEAR_MASK = (1UL << 1),
+    NRF_TIMER_SHORT_COMPARE2_CLEAR_MASK = (1UL << 2),
+    NRF_TIMER_SHORT_COMPARE3_CLEAR_MASK = (1UL << 3),
+    NRF_TIMER_SHORT_COMPARE0_STOP_MASK  = (1UL << 8),
+    NRF_TIMER_SHORT_COMPARE1_STOP_MASK  = (1UL << 9),
+    NRF_TIMER_SHORT_COMPARE2_STOP_MASK  = (1UL << 10),
+    NRF_TIMER_SHORT_COMPARE3_STOP_MASK  = (1UL << 11),
+} nrf_timer_short_mask_t;
+
+typedef enum
+{
+    NRF_TIMER_CC_CHANNEL0,
+    NRF_TIMER_CC_CHANNEL1,
+    NRF_TIMER_CC_CHANNEL2,
+    NRF_TIMER_CC_CHANNEL3,
+} nrf_timer_cc_channel_t;
+
+typedef enum
+{
+    NRF_TIMER_MODE_TIMER             = 0,
+    NRF_TIMER_MODE_COUNTER           = 1,
+    NRF_TIMER_MODE_LOW_POWER_COUNTER = 2,
+} nrf_timer_mode_t;
+
+typedef enum
+{
+    NRF_TIMER_BIT_WIDTH_16 = 0,
+    NRF_TIMER_BIT_WIDTH_8  = 1,
+    NRF_TIMER_BIT_WIDTH_24 = 2,
+    NRF_TIMER_BIT_WIDTH_32 = 3,
+} nrf_timer_bit_width_t;
+
+typedef enum
+{
+    NRF_TIMER_FREQ_16MHz = 0,
+    NRF_TIMER_FREQ_1MHz  = 4,
+} nrf_timer_frequency_t;
+
+typedef struct
+{
+    uint32_t base;
+    uint8_t  instance_id;
+    uint8_t  cc_channel_count;
+} nrfx_timer_t;
+
+/* Register base of the nRF52840 TIMER instances 0 to 2 */
+#define NRFX_TIMER_INSTANCE(id)                                                \
+    {                                                                          \
+        .base             = 0x40008000UL + ((uint32_t)(id) * 0x1000UL),        \
+        .instance_id      = (id),                                              \
+        .cc_channel_count = 4U,                                                \
+    }
+
+typedef struct
+{
+    nrf_timer_frequency_t frequency;
+    nrf_timer_mode_t      mode;
+    nrf_timer_bit_width_t bit_width;
+    uint8_t               interrupt_priority;
+    void *                p_context;
+} nrfx_timer_config_t;
+
+#define NRFX_TIMER_DEFAULT_CONFIG                                              \
+    {                                                                          \
+        .frequency          = NRF_TIMER_FREQ_16MHz,                            \
+        .mode               = NRF_TIMER_MODE_TIMER,                            \
+        .bit_width          = NRF_TIMER_BIT_WIDTH_16,                          \
+        .interrupt_priority = 6,                                               \
+        .p_context          = NULL,                                            \
+    }
+
+typedef void (* nrfx_timer_event_handler_t)(nrf_timer_event_t event_type, void * p_context);
+
+nrfx_err_t nrfx_timer_init(nrfx_timer_t const *        p_instance,
+                           nrfx_timer_config_t const * p_config,
+                           nrfx_timer_event_handler_t  timer_event_handler);
+
+void nrfx_timer_uninit(nrfx_timer_t const * p_instance);
+
+void nrfx_timer_enable(nrfx_timer_t const * p_instance);
+
+void nrfx_timer_disable(nrfx_timer_t const * p_instance);
+
+void nrfx_timer_clear(nrfx_timer_t const * p_instance);
+
+void nrfx_timer_increment(nrfx_timer_t const * p_instance);
+
+uint32_t nrfx_timer_capture(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel);
+
+uint32_t nrfx_timer_capture_get(nrfx_timer_t const * p_instance, nrf_timer_cc_channel_t cc_channel);
+
+void nrfx_timer_compare(nrfx_timer_t const *   p_instance,
+                        nrf_timer_cc_channel_t cc_channel,
+                        uint32_t               cc_value,
+                        bool                   enable_int);
+
+void nrfx_timer_extended_compare(nrfx_timer_t const *   p_instance,
+                                 nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t               cc_value,
+                                 nrf_timer_short_mask_t timer_short_mask,
+                                 bool                   enable_int);
+
+uint32_t nrfx_timer_task_address_get(nrfx_timer_t const * p_instance, nrf_timer_task_t timer_task);
+
+uint32_t nrfx_timer_capture_task_address_get(nrfx_timer_t const * p_instance, uint32_t channel);
+
+uint32_t nrfx_timer_event_address_get(nrfx_timer_t const * p_instance, nrf_timer_event_t timer_event);
+
+#endif // NRFX_TIMER_H__
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx TWI driver API. Transfers are executed on the nPM1300
+ * emulator, see emu_twi.c. Types and signatures follow nrfx 2.x from nRF5 SDK 17.1.
+ */
+#ifndef NRFX_TWI_H__
+#define NRFX_TWI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_TWI_FREQ_100K = 0x01980000UL,
+    NRF_TWI_FREQ_250K = 0x04000000UL,
+    NRF_TWI_FREQ_400K = 0x06680000UL,
+} nrf_twi_frequency_t;
+
+typedef struct
+{
+    void *  p_twi;
+    uint8_t drv_inst_idx;
+} nrfx_twi_t;
+
+#define NRFX_TWI_INSTANCE(id) { .p_twi = NULL, .drv_inst_idx = (id) }
+
+typedef struct
+{
+    uint32_t            scl;
+    uint32_t            sda;
+    nrf_twi_frequency_t frequency;
+    uint8_t             interrupt_priority;
+    bool                hold_bus_uninit;
+} nrfx_twi_config_t;
+
+typedef enum
+{
+    NRFX_TWI_EVT_DONE,
+    NRFX_TWI_EVT_ADDRESS_NACK,
+    NRFX_TWI_EVT_DATA_NACK,
+    NRFX_TWI_EVT_OVERRUN,
+    NRFX_TWI_EVT_BUS_ERROR,
+} nrfx_twi_evt_type_t;
+
+typedef enum
+{
+    NRFX_TWI_XFER_TX,
+    NRFX_TWI_XFER_RX,
+    NRFX_TWI_XFER_TXRX,
+    NRFX_TWI_XFER_TXTX,
+} nrfx_twi_xfer_type_t;
+
+typedef struct
+{
+    nrfx_twi_xfer_type_t type;
+    uint8_t              address;
+    size_t               primary_length;
+    size_t               secondary_length;
+    uint8_t *            p_primary_buf;
+    uint8_t *            p_secondary_buf;
+} nrfx_twi_xfer_desc_t;
+
+typedef struct
+{
+    nrfx_twi_evt_type_t  type;
+    nrfx_twi_xfer_desc_t xfer_desc;
+} nrfx_twi_evt_t;
+
+typedef void (* nrfx_twi_evt_handler_t)(nrfx_twi_evt_t const * p_event, void * p_context);
+
+nrfx_err_t nrfx_twi_init(nrfx_twi_t const *        p_instance,
+                         nrfx_twi_config_t const * p_config,
+                         nrfx_twi_evt_handler_t    event_handler,
+                         void *                    p_context);
+
+void nrfx_twi_uninit(nrfx_twi_t const * p_instance);
+
+void nrfx_twi_enable(nrfx_twi_t const * p_instance);
+
+void nrfx_twi_disable(nrfx_twi_t const * p_instance);
+
+nrfx_err_t nrfx_twi_tx(nrfx_twi_t const * p_instance,
+                       uint8_t            address,
+                       uint8_t const *    p_data,
+                       size_t             length,
+                       bool               no_stop);
+
+nrfx_err_t nrfx_twi_rx(nrfx_twi_t const * p_instance,
+                       uint8_t            address,
+                       uint8_t *          p_data,
+                       size_t             length);
+
+bool nrfx_twi_is_busy(nrfx_twi_t const * p_instance);
+
+#endif // NRFX_TWI_H__
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nrfx TWIM driver API. Transfers are executed on the nPM1300
+ * emulator, see emu_twi.c. Types and signatures follow nrfx 2.x from nRF5 SDK 17.1.
+ */
+#ifndef NRFX_TWIM_H__
+#define NRFX_TWIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_TWIM_FREQ_100K = 0x01980000UL,
+    NRF_TWIM_FREQ_250K = 0x04000000UL,
+    NRF_TWIM_FREQ_400K = 0x06400000UL,
+} nrf_twim_frequency_t;
+
+typedef struct
+{
+    void *  p_twim;
+    uint8_t drv_inst_idx;
+} nrfx_twim_t;
+
+#define NRFX_TWIM_INSTANCE(id) { .p_twim = NULL, .drv_inst_idx = (id) }
+
+typedef struct
+{
+    uint32_t             scl;
+    uint32_t             sda;
+    nrf_twim_frequency_t frequency;
+    uint8_t              interrupt_priority;
+    bool                 hold_bus_uninit;
+} nrfx_twim_config_t;
+
+#define NRFX_TWIM_FLAG_TX_POSTINC          (1UL << 0)
+#define NRFX_TWIM_FLAG_RX_POSTINC          (1UL << 1)
+#define NRFX_TWIM_FLAG_NO_XFER_EVT_HANDLER (1UL << 2)
+#define NRFX_TWIM_FLAG_REPEATED_XFER       (1UL << 3)
+#define NRFX_TWIM_FLAG_HOLD_XFER           (1UL << 4)
+#define NRFX_TWIM_FLAG_TX_NO_STOP          (1UL << 5)
+
+typedef enum
+{
+    NRFX_TWIM_EVT_DONE,
+    NRFX_TWIM_EVT_ADDRESS_NACK,
+    NRFX_TWIM_EVT_DATA_NACK,
+    NRFX_TWIM_EVT_OVERRUN,
+    NRFX_TWIM_EVT_BUS_ERROR,
+} nrfx_twim_evt_type_t;
+
+typedef enum
+{
+    NRFX_TWIM_XFER_TX,
+    NRFX_TWIM_XFER_RX,
+    NRFX_TWIM_XFER_TXRX,
+    NRFX_TWIM_XFER_TXTX,
+} nrfx_twim_xfer_type_t;
+
+typedef struct
+{
+    nrfx_twim_xfer_type_t type;
+    uint8_t               address;
+    size_t                primary_length;
+    size_t                secondary_length;
+    uint8_t *             p_primary_buf;
+    uint8_t *             p_secondary_buf;
+} nrfx_twim_xfer_desc_t;
+
+#define NRFX_TWIM_XFER_DESC(_type, _addr, _p_primary, _primary_len, _p_secondary, _secondary_len) \
+    {                                                                          \
+        .type             = (_type),                                           \
+        .address          = (_addr),                                           \
+        .primary_length   = (_primary_len),                                    \
+        .secondary_length = (_secondary_len),                                  \
+        .p_primary_buf    = (_p_primary),                                      \
+        .p_secondary_buf  = (_p_secondary),                                    \
+    }
+
+#define NRFX_TWIM_XFER_DESC_TX(addr, p_data, length) \
+    NRFX_TWIM_XFER_DESC(NRFX_TWIM_XFER_TX, addr, p_data, length, NULL, 0)
+
+#define NRFX_TWIM_XFER_DESC_RX(addr, p_data, length) \
+    NRFX_TWIM_XFER_DESC(NRFX_TWIM_XFER_RX, addr, p_data, length, NULL, 0)
+
+#define NRFX_TWIM_XFER_DESC_TXRX(addr, p_tx, tx_len, p_rx, rx_len) \
+    NRFX_TWIM_XFER_DESC(NRFX_TWIM_XFER_TXRX, addr, p_tx, tx_len, p_rx, rx_len)
+
+#define NRFX_TWIM_XFER_DESC_TXTX(addr, p_tx, tx_len, p_tx2, tx_len2) \
+    NRFX_TWIM_XFER_DESC(NRFX_TWIM_XFER_TXTX, addr, p_tx, tx_len, p_tx2, tx_len2)
+
+typedef struct
+{
+    nrfx_twim_evt_type_t  type;
+    nrfx_twim_xfer_desc_t xfer_desc;
+} nrfx_twim_evt_t;
+
+typedef void (* nrfx_twim_evt_handler_t)(nrfx_twim_evt_t const * p_event, void * p_context);
+
+nrfx_err_t nrfx_twim_init(nrfx_twim_t const *        p_instance,
+                          nrfx_twim_config_t const * p_config,
+                          nrfx_twim_evt_handler_t    event_handler,
+                          void *                     p_context);
+
+void nrfx_twim_uninit(nrfx_twim_t const * p_instance);
+
+void nrfx_twim_enable(nrfx_twim_t const * p_instance);
+
+void nrfx_twim_disable(nrfx_twim_t const * p_instance);
+
+nrfx_err_t nrfx_twim_xfer(nrfx_twim_t const *           p_instance,
+                          nrfx_twim_xfer_desc_t const * p_xfer_desc,
+                          uint32_t                      flags);
+
+bool nrfx_twim_is_busy(nrfx_twim_t const * p_instance);
+
+uint32_t nrfx_twim_start_task_get(nrfx_twim_t const * p_instance, nrfx_twim_xfer_type_t xfer_type);
+
+uint32_t nrfx_twim_stopped_event_get(nrfx_twim_t const * p_instance);
+
+#endif // NRFX_TWIM_H__
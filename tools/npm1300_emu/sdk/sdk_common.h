@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the parts of sdk_common.h and app_util.h used by the driver. */
+#ifndef SDK_COMMON_H__
+#define SDK_COMMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sdk_config.h"
+#include "sdk_errors.h"
+#include "nrf.h"
+#include "app_error.h"
+
+#ifndef __packed
+#define __packed __attribute__((packed))
+#endif
+
+#define UNUSED_PARAMETER(X)  ((void)(X))
+#define UNUSED_VARIABLE(X)   ((void)(X))
+#define UNUSED_RETURN_VALUE(X) ((void)(X))
+
+#define CONCAT_2(p1, p2)      CONCAT_2_(p1, p2)
+#define CONCAT_2_(p1, p2)     p1##p2
+
+#define ROUNDED_DIV(A, B)     (((A) + ((B) / 2)) / (B))
+#define CEIL_DIV(A, B)        (((A) + (B) - 1) / (B))
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+#endif
+
+#define IS_POWER_OF_TWO(A) ( ((A) != 0) && ((((A) - 1) & (A)) == 0) )
+
+#define STATIC_ASSERT(EXPR) _Static_assert((EXPR), #EXPR)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) < (b) ? (b) : (a))
+#endif
+
+#define NRF_MODULE_ENABLED(module) ((defined(module ## _ENABLED) && (module ## _ENABLED)) ? 1 : 0)
+
+#endif // SDK_COMMON_H__
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host build uses the board configuration of the firmware, so the emulated driver runs
+ * with the same options. Select another board with -DEMU_SDK_CONFIG="<path>".
+ */
+#ifndef EMU_SDK_CONFIG_H__
+#define EMU_SDK_CONFIG_H__
+
+#ifdef EMU_SDK_CONFIG
+#include EMU_SDK_CONFIG
+#else
+#include "../../../pca10056/blank/config/sdk_config.h"
+#endif
+
+#endif // EMU_SDK_CONFIG_H__
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host replacement for the nRF5 SDK error codes. Values match the SDK. */
+#ifndef SDK_ERRORS_H__
+#define SDK_ERRORS_H__
+
+#include <stdint.h>
+
+#define NRF_ERROR_BASE_NUM      (0x0)
+#define NRF_ERROR_DRIVERS_BASE_NUM (0x8000)
+
+#define NRF_SUCCESS                       (NRF_ERROR_BASE_NUM + 0)
+#define NRF_ERROR_INTERNAL                (NRF_ERROR_BASE_NUM + 3)
+#define NRF_ERROR_NO_MEM                  (NRF_ERROR_BASE_NUM + 4)
+#define NRF_ERROR_NOT_FOUND               (NRF_ERROR_BASE_NUM + 5)
+#define NRF_ERROR_NOT_SUPPORTED           (NRF_ERROR_BASE_NUM + 6)
+#define NRF_ERROR_INVALID_PARAM           (NRF_ERROR_BASE_NUM + 7)
+#define NRF_ERROR_INVALID_STATE           (NRF_ERROR_BASE_NUM + 8)
+#define NRF_ERROR_INVALID_LENGTH          (NRF_ERROR_BASE_NUM + 9)
+#define NRF_ERROR_INVALID_FLAGS           (NRF_ERROR_BASE_NUM + 10)
+#define NRF_ERROR_INVALID_DATA            (NRF_ERROR_BASE_NUM + 11)
+#define NRF_ERROR_DATA_SIZE               (NRF_ERROR_BASE_NUM + 12)
+#define NRF_ERROR_TIMEOUT                 (NRF_ERROR_BASE_NUM + 13)
+#define NRF_ERROR_NULL                    (NRF_ERROR_BASE_NUM + 14)
+#define NRF_ERROR_FORBIDDEN               (NRF_ERROR_BASE_NUM + 15)
+#define NRF_ERROR_INVALID_ADDR            (NRF_ERROR_BASE_NUM + 16)
+#define NRF_ERROR_BUSY                    (NRF_ERROR_BASE_NUM + 17)
+
+#define NRF_ERROR_DRV_TWI_ERR_OVERRUN     (NRF_ERROR_DRIVERS_BASE_NUM + 0x0200)
+#define NRF_ERROR_DRV_TWI_ERR_ANACK       (NRF_ERROR_DRIVERS_BASE_NUM + 0x0201)
+#define NRF_ERROR_DRV_TWI_ERR_DNACK       (NRF_ERROR_DRIVERS_BASE_NUM + 0x0202)
+
+typedef uint32_t ret_code_t;
+
+/* nrfx shares the SDK error codes, as with NRFX_CUSTOM_ERROR_CODES in the SDK glue layer. */
+typedef ret_code_t nrfx_err_t;
+
+#define NRFX_SUCCESS                 NRF_SUCCESS
+#define NRFX_ERROR_INTERNAL          NRF_ERROR_INTERNAL
+#define NRFX_ERROR_NO_MEM            NRF_ERROR_NO_MEM
+#define NRFX_ERROR_NOT_SUPPORTED     NRF_ERROR_NOT_SUPPORTED
+#define NRFX_ERROR_INVALID_PARAM     NRF_ERROR_INVALID_PARAM
+#define NRFX_ERROR_INVALID_STATE     NRF_ERROR_INVALID_STATE
+#define NRFX_ERROR_INVALID_LENGTH    NRF_ERROR_INVALID_LENGTH
+#define NRFX_ERROR_TIMEOUT           NRF_ERROR_TIMEOUT
+#define NRFX_ERROR_FORBIDDEN         NRF_ERROR_FORBIDDEN
+#define NRFX_ERROR_NULL              NRF_ERROR_NULL
+#define NRFX_ERROR_INVALID_ADDR      NRF_ERROR_INVALID_ADDR
+#define NRFX_ERROR_BUSY              NRF_ERROR_BUSY
+#define NRFX_ERROR_DRV_TWI_ERR_OVERRUN NRF_ERROR_DRV_TWI_ERR_OVERRUN
+#define NRFX_ERROR_DRV_TWI_ERR_ANACK NRF_ERROR_DRV_TWI_ERR_ANACK
+#define NRFX_ERROR_DRV_TWI_ERR_DNACK NRF_ERROR_DRV_TWI_ERR_DNACK
+
+#endif // SDK_ERRORS_H__
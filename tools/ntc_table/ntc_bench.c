@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Compares the cost and the result of the two NTC conversions of ntc_temp.c over all ADC
+ * codes, the error within the range of the table and the values the table saturates to.
+ * Cycles are read from the x86 time stamp counter.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+#include "ntc_temp.h"
+
+#define CODES  1024U
+#define ROUNDS 2000U
+
+/* Keeps the compiler from dropping the conversions */
+static volatile int32_t m_sink;
+
+static double lut_cycles(void)
+{
+    uint64_t start = __rdtsc();
+
+    for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+        for (uint16_t code = 1; code < CODES; code++)
+        {
+            m_sink = ntc_temp_lut_get(code);
+        }
+    }
+
+    return (double)(__rdtsc() - start) / (ROUNDS * (CODES - 1U));
+}
+
+static double calc_cycles(uint16_t beta)
+{
+    uint64_t start = __rdtsc();
+
+    for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+        for (uint16_t code = 1; code < CODES; code++)
+        {
+            m_sink = (int32_t)(ntc_temp_calc(code, beta) * 1000.f);
+        }
+    }
+
+    return (double)(__rdtsc() - start) / (ROUNDS * (CODES - 1U));
+}
+
+int main(void)
+{
+    uint16_t beta      = ntc_temp_lut_beta_get();
+    uint16_t code_min  = CODES;
+    uint16_t code_max  = 0;
+    double   err_range = 0.0;
+
+    for (uint16_t code = 1; code < CODES; code++)
+    {
+        double calc = ntc_temp_calc(code, beta);
+        double err  = fabs((ntc_temp_lut_get(code) / 1000.0) - calc);
+
+        if ((calc >= -40.0) && (calc <= 125.0))
+        {
+            if (code < code_min)
+            {
+                code_min = code;
+            }
+            code_max = code;
+            if (err > err_range)
+            {
+                err_range = err;
+            }
+        }
+    }
+
+    printf("beta                %u\n", beta);
+    printf("table               %u entries, %zu bytes\n", NTC_TABLE_LEN,
+           sizeof(ntc_table_t));
+    printf("max error           %.3f C from -40 to 125 C, codes %u to %u\n", err_range,
+           code_min, code_max);
+    printf("saturated           %.3f C at code 1, %.3f C at code %u\n",
+           ntc_temp_lut_get(1) / 1000.0, ntc_temp_lut_get(CODES - 1U) / 1000.0, CODES - 1U);
+    printf("table lookup        %.1f cycles\n", lut_cycles());
+    printf("formula             %.1f cycles\n", calc_cycles(beta));
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Generates npm1300_lib/ntc_table.inc: battery temperature in millidegrees Celsius for every
+ * NTC_TABLE_STEP ADC codes, computed with the formula of ntc_temp_calc(), the codes of the
+ * range ntc_temp_lut_get() saturates to and the worst case error of the interpolated table
+ * against that formula within them.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ntc_temp.h"
+
+#define CODES 1024
+
+/* Temperature range of the table, codes beyond it saturate */
+#define RANGE_MIN_C (-40.0)
+#define RANGE_MAX_C 125.0
+
+static double temp_get(int code, unsigned beta)
+{
+    return (1.0 / ((1.0 / 298.15) - (log((1024.0 / code) - 1.0) / beta))) - 273.15;
+}
+
+int main(int argc, char *argv[])
+{
+    static int32_t table[NTC_TABLE_LEN];
+    unsigned beta;
+    int code_min = 1;
+    int code_max = CODES - 1;
+    double err_range = 0.0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s thermistor_beta > npm1300_lib/ntc_table.inc\n", argv[0]);
+        return 1;
+    }
+
+    beta = (unsigned)strtoul(argv[1], NULL, 0);
+    if ((beta == 0) || (beta > UINT16_MAX))
+    {
+        fprintf(stderr, "invalid beta\n");
+        return 1;
+    }
+
+    for (int i = 1; i < NTC_TABLE_LEN - 1; i++)
+    {
+        table[i] = (int32_t)lround(temp_get(i * NTC_TABLE_STEP, beta) * 1000.0);
+    }
+
+    /* Code 0 is a shorted NTC and 1024 is past the ADC range. Place the end points so the
+     * interpolation is exact at codes 1 and 1023.
+     */
+    table[0] = (int32_t)lround(((NTC_TABLE_STEP * temp_get(1, beta) * 1000.0) - table[1]) /
+                               (NTC_TABLE_STEP - 1));
+    table[NTC_TABLE_LEN - 1] = table[NTC_TABLE_LEN - 2] +
+        (int32_t)lround(((temp_get(CODES - 1, beta) * 1000.0) - table[NTC_TABLE_LEN - 2]) *
+                        NTC_TABLE_STEP / (NTC_TABLE_STEP - 1));
+
+    /* The temperature falls as the code rises. Codes below code_min are hotter than the
+     * range, down to a shorted NTC, codes above code_max colder, up to an open one.
+     */
+    while (temp_get(code_min, beta) > RANGE_MAX_C)
+    {
+        code_min++;
+    }
+    while (temp_get(code_max, beta) < RANGE_MIN_C)
+    {
+        code_max--;
+    }
+
+    /* Compare the interpolation used by ntc_temp_lut_get() with the float formula */
+    for (int code = code_min; code <= code_max; code++)
+    {
+        int idx = code / NTC_TABLE_STEP;
+        int frac = code % NTC_TABLE_STEP;
+        int32_t lut = table[idx] + (((table[idx + 1] - table[idx]) * frac) / NTC_TABLE_STEP);
+        double exact = temp_get(code, beta);
+        double err = fabs((lut / 1000.0) - exact);
+
+        if (err > err_range)
+        {
+            err_range = err;
+        }
+    }
+
+    printf("/*\n"
+           " * Copyright (c) 2023 Nordic Semiconductor ASA\n"
+           " * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause\n"
+           " */\n"
+           "\n"
+           "/* Generated by tools/ntc_table/ntc_table_gen %u, do not edit.\n"
+           " * Max interpolation error against the NTC formula: %.3f C from %.0f to %.0f C,\n"
+           " * codes %d to %d. Codes beyond them saturate to the nearest end.\n"
+           " */\n"
+           "\n"
+           ".beta = %u,\n"
+           ".code_min = %d,\n"
+           ".code_max = %d,\n"
+           ".millicelsius = {",
+           beta, err_range, RANGE_MIN_C, RANGE_MAX_C, code_min, code_max, beta, code_min,
+           code_max);
+
+    for (int i = 0; i < NTC_TABLE_LEN; i++)
+    {
+        printf("%s%ld,", ((i % 8) == 0) ? "\n    " : " ", (long)table[i]);
+    }
+
+    printf("\n},\n");
+
+    return 0;
+}
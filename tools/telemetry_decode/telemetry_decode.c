@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Decodes the binary fuel gauge records of telemetry.c, as captured from the RTT channel,
+ * into CSV. Gaps in the record counter are reported as lost records, bytes that do not
+ * start a record are skipped until the next sync byte.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+_Static_assert(sizeof(telemetry_record_t) == 32U, "record layout of telemetry.h");
+
+typedef struct
+{
+    uint32_t records;
+    uint32_t lost;
+    uint32_t skipped;
+} decode_stats_t;
+
+static void usage(const char * p_name)
+{
+    fprintf(stderr,
+            "usage: %s [-s] [capture]\n"
+            "  capture  RTT channel output, stdin if omitted\n"
+            "  -s       print the time as uptime in milliseconds instead of seconds\n",
+            p_name);
+}
+
+/* Empty field for the NaN the gauge returns while TTE or TTF are unknown */
+static void csv_seconds(float value)
+{
+    if (isnan(value))
+    {
+        printf(",");
+    }
+    else
+    {
+        printf(",%.0f", value);
+    }
+}
+
+static void record_print(telemetry_record_t const * p_record, int raw_time)
+{
+    if (raw_time)
+    {
+        printf("%" PRIu32, p_record->time_ms);
+    }
+    else
+    {
+        printf("%.3f", p_record->time_ms / 1000.0);
+    }
+
+    printf(",%.6f,%.6f,%.3f,%.2f", p_record->voltage_uv / 1e6, p_record->current_ua / 1e6,
+           p_record->temp_mdeg / 1e3, p_record->soc);
+    csv_seconds(p_record->tte);
+    csv_seconds(p_record->ttf);
+    printf(",0x%02X,0x%02X\n", p_record->chg_status, p_record->vbus_stat);
+}
+
+int main(int argc, char * argv[])
+{
+    FILE *             p_in     = stdin;
+    int                raw_time = 0;
+    decode_stats_t     stats    = { 0 };
+    telemetry_record_t record;
+    uint8_t            buf[sizeof(telemetry_record_t)];
+    size_t             fill     = 0;
+    int                have_seq = 0;
+    uint8_t            next_seq = 0;
+    int                opt;
+
+    while ((opt = getopt(argc, argv, "sh")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                raw_time = 1;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind < argc)
+    {
+        p_in = fopen(argv[optind], "rb");
+        if (p_in == NULL)
+        {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    printf("%s,voltage_v,current_a,temp_c,soc_pct,tte_s,ttf_s,chg_stat,vbus_stat\n",
+           raw_time ? "time_ms" : "time_s");
+
+    for (;;)
+    {
+        size_t got = fread(&buf[fill], 1, sizeof(buf) - fill, p_in);
+
+        fill += got;
+        if (fill < sizeof(buf))
+        {
+            break;
+        }
+
+        /* Resynchronize on the next sync byte */
+        if (buf[0] != TELEMETRY_RECORD_SYNC)
+        {
+            uint8_t * p_sync = memchr(&buf[1], TELEMETRY_RECORD_SYNC, sizeof(buf) - 1);
+            size_t    skip   = (p_sync != NULL) ? (size_t)(p_sync - buf) : sizeof(buf);
+
+            memmove(buf, &buf[skip], sizeof(buf) - skip);
+            fill          -= skip;
+            stats.skipped += skip;
+            have_seq       = 0;
+            continue;
+        }
+
+        memcpy(&record, buf, sizeof(record));
+        fill = 0;
+
+        if (have_seq)
+        {
+            stats.lost += (uint8_t)(record.seq - next_seq);
+        }
+        have_seq = 1;
+        next_seq = (uint8_t)(record.seq + 1U);
+
+        record_print(&record, raw_time);
+        stats.records++;
+    }
+
+    stats.skipped += fill;
+
+    fprintf(stderr, "%" PRIu32 " records, %" PRIu32 " lost, %" PRIu32 " bytes skipped\n",
+            stats.records, stats.lost, stats.skipped);
+
+    if (p_in != stdin)
+    {
+        fclose(p_in);
+    }
+
+    return 0;
+}
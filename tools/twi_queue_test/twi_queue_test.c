@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Runs twi_queue.c on the emulated TWI or TWIM driver of the nPM1300 host emulator. Every
+ * transfer writes one tag byte to a logging device on the bus, so the log tells which
+ * transfers reached the bus and in which order. Completion callbacks are logged the same
+ * way, with the result of their transaction.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "twi_queue.h"
+#include "npm1300_emu.h"
+#include "emu_platform.h"
+#include "emu_twi.h"
+
+#define LOG_ADDR     0x20U /* Logging device */
+#define ABSENT_ADDR  0x21U /* No device, transfers end with an address NACK */
+#define LOG_MAX      64U
+#define READ_BASE    0xA0U /* The logging device reads back READ_BASE, READ_BASE + 1, ... */
+
+TWI_QUEUE_DEF(m_queue, 0);
+
+static uint32_t m_failures;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(expr))                                                       \
+        {                                                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #expr);   \
+            m_failures++;                                                  \
+        }                                                                  \
+    } while (0)
+
+/* Tags written to the bus */
+static struct
+{
+    uint8_t  tags[LOG_MAX];
+    uint32_t count;
+} m_log;
+
+/* Completion callbacks, by the tag of their transaction */
+static struct
+{
+    uint8_t    tags[LOG_MAX];
+    ret_code_t results[LOG_MAX];
+    uint32_t   count;
+} m_done;
+
+/* Bus hook state, see test_bus_hook */
+static struct
+{
+    bool     hook_owned;
+    uint32_t acquires;
+    uint32_t releases;
+    uint32_t owned_xfers;
+} m_hook;
+
+static bool log_write(void * p_context, uint8_t const * p_data, size_t len)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if ((len != 0U) && (m_log.count < LOG_MAX))
+    {
+        m_log.tags[m_log.count++] = p_data[0];
+    }
+
+    /* The queue must hold the bus for every transfer it starts */
+    if (m_hook.hook_owned)
+    {
+        m_hook.owned_xfers++;
+    }
+
+    return true;
+}
+
+static void log_read(void * p_context, uint8_t * p_data, size_t len)
+{
+    UNUSED_PARAMETER(p_context);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        p_data[i] = (uint8_t)(READ_BASE + i);
+    }
+}
+
+static emu_twi_slave_t const m_log_slave =
+{
+    .address   = LOG_ADDR,
+    .write     = log_write,
+    .read      = log_read,
+    .p_context = NULL,
+};
+
+static void log_clear(void)
+{
+    memset(&m_log, 0, sizeof(m_log));
+    memset(&m_done, 0, sizeof(m_done));
+}
+
+static bool log_equal(uint8_t const * p_tags, uint32_t count)
+{
+    return (m_log.count == count) && (memcmp(m_log.tags, p_tags, count) == 0);
+}
+
+static bool done_equal(uint8_t const * p_tags, uint32_t count)
+{
+    return (m_done.count == count) && (memcmp(m_done.tags, p_tags, count) == 0);
+}
+
+/* The context of a transaction is the tag of its first transfer */
+static void done_callback(ret_code_t result, void * p_context)
+{
+    if (m_done.count < LOG_MAX)
+    {
+        m_done.tags[m_done.count]    = *(uint8_t const *)p_context;
+        m_done.results[m_done.count] = result;
+        m_done.count++;
+    }
+}
+
+/* Transaction of a single tag write */
+typedef struct
+{
+    uint8_t                 tag;
+    twi_queue_xfer_t        xfer;
+    twi_queue_transaction_t transaction;
+} tagged_t;
+
+static void tagged_init(tagged_t * p_tagged, uint8_t tag, twi_queue_priority_t priority)
+{
+    p_tagged->tag  = tag;
+    p_tagged->xfer = (twi_queue_xfer_t)TWI_QUEUE_WRITE(LOG_ADDR, &p_tagged->tag, 1U);
+
+    p_tagged->transaction = (twi_queue_transaction_t)
+    {
+        .callback  = done_callback,
+        .p_context = &p_tagged->tag,
+        .p_xfers   = &p_tagged->xfer,
+        .count     = 1U,
+        .priority  = priority,
+    };
+}
+
+static void queue_drain(void)
+{
+    while (!twi_queue_is_idle(&m_queue))
+    {
+        emu_wfe();
+    }
+}
+
+/* Each class holds TWI_QUEUE_SIZE - 1 transactions behind the one on the bus */
+static void test_fifo_full(void)
+{
+    static tagged_t normal[TWI_QUEUE_SIZE + 1];
+    static tagged_t high;
+    uint8_t         expected[TWI_QUEUE_SIZE + 1];
+    twi_queue_transaction_t empty = { .callback = done_callback, .p_xfers = NULL, .count = 0 };
+
+    log_clear();
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(normal); i++)
+    {
+        tagged_init(&normal[i], (uint8_t)(10U + i), TWI_QUEUE_PRIORITY_NORMAL);
+    }
+    tagged_init(&high, 30U, TWI_QUEUE_PRIORITY_HIGH);
+
+    /* The first one goes on the bus right away, TWI_QUEUE_SIZE - 1 wait */
+    for (uint8_t i = 0; i < TWI_QUEUE_SIZE; i++)
+    {
+        CHECK(twi_queue_schedule(&m_queue, &normal[i].transaction) == NRF_SUCCESS);
+    }
+    CHECK(twi_queue_schedule(&m_queue, &normal[TWI_QUEUE_SIZE].transaction) == NRF_ERROR_NO_MEM);
+
+    /* Other classes have FIFOs of their own, bad transactions are refused */
+    CHECK(twi_queue_schedule(&m_queue, &high.transaction) == NRF_SUCCESS);
+    CHECK(twi_queue_schedule(&m_queue, &empty) == NRF_ERROR_INVALID_PARAM);
+    empty.p_xfers  = &high.xfer;
+    empty.count    = 1U;
+    empty.priority = TWI_QUEUE_PRIORITY_COUNT;
+    CHECK(twi_queue_schedule(&m_queue, &empty) == NRF_ERROR_INVALID_PARAM);
+
+    queue_drain();
+
+    /* The high priority one overtakes the waiting ones, the refused one never runs */
+    expected[0] = 10U;
+    expected[1] = 30U;
+    for (uint8_t i = 1; i < TWI_QUEUE_SIZE; i++)
+    {
+        expected[i + 1U] = (uint8_t)(10U + i);
+    }
+    CHECK(log_equal(expected, TWI_QUEUE_SIZE + 1U));
+    CHECK(done_equal(expected, TWI_QUEUE_SIZE + 1U));
+    for (uint32_t i = 0; i < m_done.count; i++)
+    {
+        CHECK(m_done.results[i] == NRF_SUCCESS);
+    }
+
+    /* Room again once drained */
+    CHECK(twi_queue_schedule(&m_queue, &normal[TWI_QUEUE_SIZE].transaction) == NRF_SUCCESS);
+    queue_drain();
+    CHECK((m_log.count == TWI_QUEUE_SIZE + 2U) && (m_log.tags[TWI_QUEUE_SIZE + 1U] == 18U));
+}
+
+/* A failing transfer ends its transaction, the rest of the chain is skipped */
+static void test_error(void)
+{
+    static uint8_t const          tags[] = { 40U, 41U, 42U };
+    static twi_queue_xfer_t const xfers[] =
+    {
+        TWI_QUEUE_WRITE(LOG_ADDR, &tags[0], 1U),
+        TWI_QUEUE_WRITE(ABSENT_ADDR, &tags[1], 1U),
+        TWI_QUEUE_WRITE(LOG_ADDR, &tags[2], 1U),
+    };
+    static twi_queue_transaction_t const chain =
+    {
+        .callback  = done_callback,
+        .p_context = (void *)&tags[0],
+        .p_xfers   = xfers,
+        .count     = ARRAY_SIZE(xfers),
+    };
+    static tagged_t next;
+    uint32_t        xfer_count = twi_queue_xfer_count_get(&m_queue);
+    uint8_t         rx[3]      = { 0 };
+
+    log_clear();
+    tagged_init(&next, 43U, TWI_QUEUE_PRIORITY_NORMAL);
+
+    CHECK(twi_queue_schedule(&m_queue, &chain) == NRF_SUCCESS);
+    CHECK(twi_queue_schedule(&m_queue, &next.transaction) == NRF_SUCCESS);
+    queue_drain();
+
+    CHECK(log_equal((uint8_t const[]){ 40U, 43U }, 2U));
+    CHECK(done_equal((uint8_t const[]){ 40U, 43U }, 2U));
+    CHECK(m_done.results[0] == NRF_ERROR_DRV_TWI_ERR_ANACK);
+    CHECK(m_done.results[1] == NRF_SUCCESS);
+    /* Only completed transfers are counted */
+    CHECK(twi_queue_xfer_count_get(&m_queue) == xfer_count + 2U);
+
+    /* Blocking transactions report the error too, and reads come back after a repeated start */
+    twi_queue_xfer_t const read   = TWI_QUEUE_READ(LOG_ADDR, &tags[2], 1U, rx, sizeof(rx));
+    twi_queue_xfer_t const absent = TWI_QUEUE_READ(ABSENT_ADDR, &tags[2], 1U, rx, sizeof(rx));
+
+    CHECK(twi_queue_perform(&m_queue, &read, 1U) == NRF_SUCCESS);
+    CHECK((rx[0] == READ_BASE) && (rx[1] == READ_BASE + 1U) && (rx[2] == READ_BASE + 2U));
+    CHECK(twi_queue_perform(&m_queue, &absent, 1U) == NRF_ERROR_DRV_TWI_ERR_ANACK);
+    CHECK(twi_queue_is_idle(&m_queue));
+}
+
+static tagged_t m_chained[3];
+
+/* Schedules the next transaction of m_chained from the callback of the previous one */
+static void chain_callback(ret_code_t result, void * p_context)
+{
+    tagged_t * p_tagged = (tagged_t *)p_context;
+
+    done_callback(result, &p_tagged->tag);
+
+    if (p_tagged < &m_chained[ARRAY_SIZE(m_chained) - 1U])
+    {
+        CHECK(twi_queue_schedule(&m_queue, &(p_tagged + 1)->transaction) == NRF_SUCCESS);
+    }
+}
+
+/* Transactions scheduled from a callback start after the ones already waiting */
+static void test_callback_schedule(void)
+{
+    static tagged_t waiting;
+
+    log_clear();
+    tagged_init(&waiting, 59U, TWI_QUEUE_PRIORITY_NORMAL);
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_chained); i++)
+    {
+        tagged_init(&m_chained[i], (uint8_t)(50U + i), TWI_QUEUE_PRIORITY_NORMAL);
+        m_chained[i].transaction.callback  = chain_callback;
+        m_chained[i].transaction.p_context = &m_chained[i];
+    }
+
+    CHECK(twi_queue_schedule(&m_queue, &m_chained[0].transaction) == NRF_SUCCESS);
+    CHECK(twi_queue_schedule(&m_queue, &waiting.transaction) == NRF_SUCCESS);
+    queue_drain();
+
+    CHECK(log_equal((uint8_t const[]){ 50U, 59U, 51U, 52U }, 4U));
+    CHECK(done_equal((uint8_t const[]){ 50U, 59U, 51U, 52U }, 4U));
+}
+
+/* While the bus is busy, high goes before normal before low, each class in order */
+static void test_priority(void)
+{
+    static tagged_t tagged[6];
+    static twi_queue_priority_t const priorities[ARRAY_SIZE(tagged)] =
+    {
+        TWI_QUEUE_PRIORITY_LOW, /* Goes on the bus right away */
+        TWI_QUEUE_PRIORITY_LOW,
+        TWI_QUEUE_PRIORITY_NORMAL,
+        TWI_QUEUE_PRIORITY_HIGH,
+        TWI_QUEUE_PRIORITY_NORMAL,
+        TWI_QUEUE_PRIORITY_HIGH,
+    };
+
+    log_clear();
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(tagged); i++)
+    {
+        tagged_init(&tagged[i], (uint8_t)(60U + i), priorities[i]);
+        CHECK(twi_queue_schedule(&m_queue, &tagged[i].transaction) == NRF_SUCCESS);
+    }
+    queue_drain();
+
+    CHECK(log_equal((uint8_t const[]){ 60U, 63U, 65U, 62U, 64U, 61U }, 6U));
+    CHECK(done_equal((uint8_t const[]){ 60U, 63U, 65U, 62U, 64U, 61U }, 6U));
+}
+
+#if TWI_QUEUE_USE_TWIM
+static void hook_acquire(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    CHECK(m_hook.hook_owned);
+    m_hook.hook_owned = false;
+    m_hook.acquires++;
+}
+
+static void hook_release(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    CHECK(!m_hook.hook_owned);
+    CHECK(!nrfx_twim_is_busy(twi_queue_instance_get(&m_queue)));
+    m_hook.hook_owned = true;
+    m_hook.releases++;
+}
+
+/* The hook owns the bus while the queue is idle, and gets it back once per busy stretch */
+static void test_bus_hook(void)
+{
+    static twi_queue_bus_hook_t const hook =
+    {
+        .acquire   = hook_acquire,
+        .release   = hook_release,
+        .p_context = NULL,
+    };
+    static tagged_t tagged[3];
+
+    log_clear();
+    memset(&m_hook, 0, sizeof(m_hook));
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(tagged); i++)
+    {
+        tagged_init(&tagged[i], (uint8_t)(70U + i), TWI_QUEUE_PRIORITY_NORMAL);
+    }
+
+    /* Handed over right away on an idle queue */
+    twi_queue_bus_hook_set(&m_queue, &hook);
+    CHECK(m_hook.hook_owned && (m_hook.releases == 1U));
+
+    /* Back to back transactions are one stretch */
+    CHECK(twi_queue_schedule(&m_queue, &tagged[0].transaction) == NRF_SUCCESS);
+    CHECK(!m_hook.hook_owned && (m_hook.acquires == 1U));
+    CHECK(twi_queue_schedule(&m_queue, &tagged[1].transaction) == NRF_SUCCESS);
+    queue_drain();
+    CHECK(m_hook.hook_owned && (m_hook.acquires == 1U) && (m_hook.releases == 2U));
+
+    CHECK(twi_queue_schedule(&m_queue, &tagged[2].transaction) == NRF_SUCCESS);
+    queue_drain();
+    CHECK(m_hook.hook_owned && (m_hook.acquires == 2U) && (m_hook.releases == 3U));
+
+    CHECK(log_equal((uint8_t const[]){ 70U, 71U, 72U }, 3U));
+    CHECK(m_hook.owned_xfers == 0U);
+
+    /* Removing the hook takes the bus back for good */
+    twi_queue_bus_hook_set(&m_queue, NULL);
+    CHECK(!m_hook.hook_owned && (m_hook.acquires == 3U));
+    CHECK(twi_queue_schedule(&m_queue, &tagged[0].transaction) == NRF_SUCCESS);
+    queue_drain();
+    CHECK((m_hook.acquires == 3U) && (m_hook.releases == 3U));
+}
+#endif // TWI_QUEUE_USE_TWIM
+
+int main(void)
+{
+    twi_queue_config_t const queue_config =
+    {
+        .scl                = 27U,
+        .sda                = 26U,
+        .frequency          = TWI_QUEUE_FREQ_400K,
+        .interrupt_priority = 6U,
+    };
+
+    npm1300_emu_reset();
+    CHECK(emu_twi_slave_add(&m_log_slave));
+    CHECK(twi_queue_init(&m_queue, &queue_config) == NRF_SUCCESS);
+
+    test_fifo_full();
+    test_error();
+    test_callback_schedule();
+    test_priority();
+#if TWI_QUEUE_USE_TWIM
+    test_bus_hook();
+#endif
+
+    if (m_failures != 0U)
+    {
+        fprintf(stderr, "%u checks failed\n", (unsigned)m_failures);
+        return 1;
+    }
+
+    printf("twi_queue_test: all checks passed\n");
+
+    return 0;
+}